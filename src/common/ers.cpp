@@ -28,7 +28,8 @@
  *    destroyed so memory will usually only be recovered near the end.       *
  *  - Always wastes space for entries smaller than a pointer.                *
  *                                                                           *
- *  WARNING: The system is not thread-safe at the moment.                    *
+ *  WARNING: Only managers with ERS_OPT_THREADSAFE may be used by several   *
+ *  threads. Creating and destroying managers is not thread-safe.          *
  *                                                                           *
  *  HISTORY:                                                                 *
  *    0.1 - Initial version                                                  *
@@ -42,8 +43,17 @@
 
 #include "ers.hpp"
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef WIN32
+	#include "winapi.hpp"
+#else
+	#include <sys/mman.h>
+#endif
 
 #include "cbasetypes.hpp"
 #include "malloc.hpp" // CREATE, RECREATE, aMalloc, aFree
@@ -53,6 +63,14 @@
 #ifndef DISABLE_ERS
 
 #define ERS_BLOCK_ENTRIES 2048
+#define ERS_HUGEPAGE_SIZE (2 * 1024 * 1024) // Chunks of ERS_OPT_HUGEPAGES caches are rounded up to this
+
+// Options that give an instance its own cache
+#define ERS_CACHE_MASK (ERS_CACHE_OPTIONS|ERS_OPT_HUGEPAGES|ERS_OPT_THREADSAFE)
+
+#define ERS_MAGAZINE_SIZE 64 // Free entries a thread keeps per thread-safe cache
+#define ERS_DEPOT_SIZE 1024 // Magazines the lock-free depot of a thread-safe cache holds, power of two
+#define ERS_THREADSAFE_MAX 32 // Thread-safe caches at the same time
 
 struct ers_list
 {
@@ -61,6 +79,59 @@ struct ers_list
 
 struct ers_instance_t;
 
+/**
+ * Shared part of a thread-safe cache
+ * Full magazines are exchanged through a bounded lock-free queue, only carving
+ * new entries or a full queue take the lock.
+ */
+struct ers_depot {
+	struct ers_depot_cell {
+		std::atomic<size_t> Sequence;
+		struct ers_list *Head;
+		uint32 Count;
+	} Cells[ERS_DEPOT_SIZE];
+
+	alignas(64) std::atomic<size_t> EnqueuePos;
+	alignas(64) std::atomic<size_t> DequeuePos;
+
+	// Guards the blocks of the cache and the overflow
+	std::mutex Lock;
+
+	// Entries that did not fit into the queue
+	struct ers_list *Overflow;
+	uint32 OverflowCount;
+};
+
+/// Statistics of a thread for a thread-safe cache, only written by the thread itself
+struct ers_thread_stats {
+	std::atomic<uint32> Generation; // Cache the statistics belong to
+	std::atomic<uint64> Allocs;
+	std::atomic<uint64> Frees;
+	std::atomic<uint64> Refills; // Magazines taken from the depot
+	std::atomic<uint64> Spills; // Magazines handed to the depot
+};
+
+/// Thread that used a thread-safe cache, kept after the thread ended for ers_report
+struct ers_thread {
+	uint32 Id;
+	std::atomic<bool> Running;
+	struct ers_thread_stats Stats[ERS_THREADSAFE_MAX];
+};
+
+/// Free entries of a thread-safe cache owned by a thread
+struct ers_magazine {
+	struct ers_list *Head;
+	uint32 Count;
+	uint32 Generation; // Cache the entries belong to
+};
+
+struct ers_thread_local {
+	struct ers_magazine Magazines[ERS_THREADSAFE_MAX];
+	struct ers_thread *Thread;
+
+	~ers_thread_local();
+};
+
 typedef struct ers_cache
 {
 	// Allocated object size, including ers_list size
@@ -75,6 +146,9 @@ typedef struct ers_cache
 	// Memory blocks array
 	unsigned char **Blocks;
 
+	// Size of each memory block in bytes, ERS_OPT_HUGEPAGES only
+	size_t *BlockSizes;
+
 	// Max number of blocks
 	uint32 Max;
 
@@ -93,6 +167,16 @@ typedef struct ers_cache
 	// Misc options, some options are shared from the instance
 	enum ERSOptions Options;
 
+	// Lock-free depot, ERS_OPT_THREADSAFE only
+	struct ers_depot *Depot;
+
+	// Index in ThreadSafeCaches and unique number of the cache, ERS_OPT_THREADSAFE only
+	uint32 Slot;
+	uint32 Generation;
+
+	// Number of entries carved from the blocks
+	uint32 Total;
+
 	// Linked list
 	struct ers_cache *Next, *Prev;
 } ers_cache_t;
@@ -113,6 +197,9 @@ struct ers_instance_t {
 	// Count of objects in use, used for detecting memory leaks
 	uint32 Count;
 
+	// Highest count of objects in use
+	uint32 Peak;
+
 	struct ers_instance_t *Next, *Prev;
 };
 
@@ -121,6 +208,25 @@ struct ers_instance_t {
 static ers_cache_t *CacheList = nullptr;
 static struct ers_instance_t *InstanceList = nullptr;
 
+// Thread-safe caches by slot, only changed while creating or destroying managers
+static ers_cache_t *ThreadSafeCaches[ERS_THREADSAFE_MAX];
+static uint32 ThreadSafeGeneration = 0;
+
+static std::mutex& ers_threads_lock(void) {
+	static std::mutex lock;
+
+	return lock;
+}
+
+static std::vector<struct ers_thread *>& ers_threads(void) {
+	// Never destroyed, threads can still end during static destruction
+	static std::vector<struct ers_thread *> *threads = new std::vector<struct ers_thread *>();
+
+	return *threads;
+}
+
+static thread_local struct ers_thread_local ErsThread;
+
 /**
  * @param Options the options from the instance seeking a cache, we use it to give it a cache with matching configuration
  **/
@@ -128,20 +234,47 @@ static ers_cache_t *ers_find_cache(uint32 size, enum ERSOptions Options) {
 	ers_cache_t *cache;
 
 	for (cache = CacheList; cache; cache = cache->Next)
-		if ( cache->ObjectSize == size && cache->Options == ( Options & ERS_CACHE_OPTIONS ) )
+		if ( cache->ObjectSize == size && cache->Options == ( Options & ERS_CACHE_MASK ) )
 			return cache;
 
+	uint32 slot = 0;
+
+	if (Options & ERS_OPT_THREADSAFE) {
+		for (slot = 0; slot < ERS_THREADSAFE_MAX; slot++)
+			if (ThreadSafeCaches[slot] == nullptr)
+				break;
+
+		if (slot == ERS_THREADSAFE_MAX)
+			return nullptr;
+	}
+
 	CREATE(cache, ers_cache_t, 1);
 	cache->ObjectSize = size;
 	cache->ReferenceCount = 0;
 	cache->ReuseList = nullptr;
 	cache->Blocks = nullptr;
+	cache->BlockSizes = nullptr;
 	cache->Free = 0;
 	cache->Used = 0;
 	cache->UsedObjs = 0;
 	cache->Max = 0;
 	cache->ChunkSize = ERS_BLOCK_ENTRIES;
-	cache->Options = (enum ERSOptions)(Options & ERS_CACHE_OPTIONS);
+	cache->Options = (enum ERSOptions)(Options & ERS_CACHE_MASK);
+	cache->Depot = nullptr;
+	cache->Total = 0;
+
+	if (Options & ERS_OPT_THREADSAFE) {
+		cache->Depot = new struct ers_depot;
+		for (size_t i = 0; i < ERS_DEPOT_SIZE; i++)
+			cache->Depot->Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		cache->Depot->EnqueuePos.store(0, std::memory_order_relaxed);
+		cache->Depot->DequeuePos.store(0, std::memory_order_relaxed);
+		cache->Depot->Overflow = nullptr;
+		cache->Depot->OverflowCount = 0;
+		cache->Slot = slot;
+		cache->Generation = ++ThreadSafeGeneration;
+		ThreadSafeCaches[slot] = cache;
+	}
 
 	if (CacheList == nullptr)
 	{
@@ -158,12 +291,87 @@ static ers_cache_t *ers_find_cache(uint32 size, enum ERSOptions Options) {
 	return cache;
 }
 
+/**
+ * Allocates a zeroed memory block of a cache
+ * Caches with ERS_OPT_HUGEPAGES map their blocks from huge pages, falling back to normal pages.
+ * @param cache: Cache to allocate the block for
+ * @param entries: Requested entries, may be raised to fill up the huge pages
+ * @return Memory block
+ */
+static unsigned char *ers_alloc_block(ers_cache_t *cache, uint32 &entries)
+{
+	if (!(cache->Options & ERS_OPT_HUGEPAGES)) {
+		unsigned char *block;
+
+		CREATE(block, unsigned char, static_cast<size_t>( cache->ObjectSize ) * entries);
+		return block;
+	}
+
+	size_t size = static_cast<size_t>( cache->ObjectSize ) * entries;
+	void *block = nullptr;
+
+	size = (size + ERS_HUGEPAGE_SIZE - 1) / ERS_HUGEPAGE_SIZE * ERS_HUGEPAGE_SIZE;
+
+#ifdef WIN32
+	// Large pages need the "Lock pages in memory" privilege
+	if (GetLargePageMinimum() > 0)
+		block = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+	if (block == nullptr)
+		block = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (block == nullptr) {
+		ShowFatalError("ers_alloc_block: Out of memory allocating %" PRIuPTR " bytes.\n", size);
+		exit(EXIT_FAILURE);
+	}
+#else
+#ifdef MAP_HUGETLB
+	block = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (block == MAP_FAILED)
+		block = nullptr;
+#endif
+	// No reserved huge pages, ask for transparent ones instead
+	if (block == nullptr) {
+		block = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (block == MAP_FAILED) {
+			ShowFatalError("ers_alloc_block: Out of memory allocating %" PRIuPTR " bytes.\n", size);
+			exit(EXIT_FAILURE);
+		}
+#ifdef MADV_HUGEPAGE
+		madvise(block, size, MADV_HUGEPAGE);
+#endif
+	}
+#endif
+
+	cache->BlockSizes[cache->Used] = size;
+	entries = static_cast<uint32>( size / cache->ObjectSize );
+
+	return static_cast<unsigned char *>(block);
+}
+
+/**
+ * Frees a memory block of a cache
+ * @param cache: Cache the block belongs to
+ * @param i: Index of the block
+ */
+static void ers_free_block(ers_cache_t *cache, uint32 i)
+{
+	if (!(cache->Options & ERS_OPT_HUGEPAGES)) {
+		aFree(cache->Blocks[i]);
+		return;
+	}
+
+#ifdef WIN32
+	VirtualFree(cache->Blocks[i], 0, MEM_RELEASE);
+#else
+	munmap(cache->Blocks[i], cache->BlockSizes[i]);
+#endif
+}
+
 static void ers_free_cache(ers_cache_t *cache, bool remove)
 {
 	uint32 i;
 
 	for (i = 0; i < cache->Used; i++)
-		aFree(cache->Blocks[i]);
+		ers_free_block(cache, i);
 
 	if (cache->Next)
 		cache->Next->Prev = cache->Prev;
@@ -174,10 +382,39 @@ static void ers_free_cache(ers_cache_t *cache, bool remove)
 		CacheList = cache->Next;
 
 	aFree(cache->Blocks);
+	if (cache->BlockSizes != nullptr)
+		aFree(cache->BlockSizes);
+
+	if (cache->Depot != nullptr) {
+		// Magazines other threads still hold are dropped on their next use, see ers_thread_magazine
+		ThreadSafeCaches[cache->Slot] = nullptr;
+		delete cache->Depot;
+	}
 
 	aFree(cache);
 }
 
+/**
+ * Adds a new block of entries to a cache
+ * @param cache: Cache to grow, the lock of the depot has to be held for thread-safe caches
+ */
+static void ers_cache_grow(ers_cache_t *cache)
+{
+	if (cache->Used == cache->Max) {
+		cache->Max = (cache->Max * 4) + 3;
+		RECREATE(cache->Blocks, unsigned char *, cache->Max);
+		if (cache->Options & ERS_OPT_HUGEPAGES)
+			RECREATE(cache->BlockSizes, size_t, cache->Max);
+	}
+
+	uint32 entries = cache->ChunkSize;
+
+	cache->Blocks[cache->Used] = ers_alloc_block(cache, entries);
+	cache->Used++;
+	cache->Free = entries;
+	cache->Total += entries;
+}
+
 static void *ers_obj_alloc_entry(ERS *self)
 {
 	struct ers_instance_t *instance = (struct ers_instance_t *)self;
@@ -195,19 +432,15 @@ static void *ers_obj_alloc_entry(ERS *self)
 		instance->Cache->Free--;
 		ret = &instance->Cache->Blocks[instance->Cache->Used - 1][static_cast<size_t>( instance->Cache->Free ) * static_cast<size_t>( instance->Cache->ObjectSize ) + sizeof( struct ers_list )];
 	} else {
-		if (instance->Cache->Used == instance->Cache->Max) {
-			instance->Cache->Max = (instance->Cache->Max * 4) + 3;
-			RECREATE(instance->Cache->Blocks, unsigned char *, instance->Cache->Max);
-		}
-
-		CREATE(instance->Cache->Blocks[instance->Cache->Used], unsigned char, instance->Cache->ObjectSize * instance->Cache->ChunkSize);
-		instance->Cache->Used++;
+		ers_cache_grow(instance->Cache);
 
-		instance->Cache->Free = instance->Cache->ChunkSize -1;
+		instance->Cache->Free--;
 		ret = &instance->Cache->Blocks[instance->Cache->Used - 1][static_cast<size_t>( instance->Cache->Free ) * static_cast<size_t>( instance->Cache->ObjectSize ) + sizeof( struct ers_list )];
 	}
 
 	instance->Count++;
+	if (instance->Count > instance->Peak)
+		instance->Peak = instance->Count;
 	instance->Cache->UsedObjs++;
 
 	return ret;
@@ -235,6 +468,249 @@ static void ers_obj_free_entry(ERS *self, void *entry)
 	instance->Cache->UsedObjs--;
 }
 
+/**
+ * Hands a magazine to the lock-free depot of a cache
+ * @return false if the depot is full
+ */
+static bool ers_depot_push(struct ers_depot *depot, struct ers_list *head, uint32 count)
+{
+	size_t pos = depot->EnqueuePos.load(std::memory_order_relaxed);
+
+	for (;;) {
+		struct ers_depot::ers_depot_cell *cell = &depot->Cells[pos & (ERS_DEPOT_SIZE - 1)];
+		intptr_t diff = (intptr_t)cell->Sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+
+		if (diff == 0) {
+			if (depot->EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell->Head = head;
+				cell->Count = count;
+				cell->Sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = depot->EnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/**
+ * Takes a magazine from the lock-free depot of a cache
+ * @return false if the depot is empty
+ */
+static bool ers_depot_pop(struct ers_depot *depot, struct ers_list *&head, uint32 &count)
+{
+	size_t pos = depot->DequeuePos.load(std::memory_order_relaxed);
+
+	for (;;) {
+		struct ers_depot::ers_depot_cell *cell = &depot->Cells[pos & (ERS_DEPOT_SIZE - 1)];
+		intptr_t diff = (intptr_t)cell->Sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1);
+
+		if (diff == 0) {
+			if (depot->DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				head = cell->Head;
+				count = cell->Count;
+				cell->Sequence.store(pos + ERS_DEPOT_SIZE, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = depot->DequeuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/**
+ * Hands the entries of a magazine back to a cache, they are kept in the overflow if the depot is full
+ */
+static void ers_depot_spill(ers_cache_t *cache, struct ers_list *head, uint32 count)
+{
+	if (head == nullptr || ers_depot_push(cache->Depot, head, count))
+		return;
+
+	std::lock_guard<std::mutex> lock(cache->Depot->Lock);
+	struct ers_list *tail = head;
+
+	while (tail->Next != nullptr)
+		tail = tail->Next;
+
+	tail->Next = cache->Depot->Overflow;
+	cache->Depot->Overflow = head;
+	cache->Depot->OverflowCount += count;
+}
+
+/**
+ * Fills an empty magazine from the depot, the overflow or new entries of the blocks
+ */
+static void ers_depot_refill(ers_cache_t *cache, struct ers_magazine &magazine)
+{
+	if (ers_depot_pop(cache->Depot, magazine.Head, magazine.Count))
+		return;
+
+	std::lock_guard<std::mutex> lock(cache->Depot->Lock);
+
+	while (magazine.Count < ERS_MAGAZINE_SIZE) {
+		struct ers_list *reuse;
+
+		if (cache->Depot->Overflow != nullptr) {
+			reuse = cache->Depot->Overflow;
+			cache->Depot->Overflow = reuse->Next;
+			cache->Depot->OverflowCount--;
+		} else {
+			if (cache->Free == 0)
+				ers_cache_grow(cache);
+
+			cache->Free--;
+			reuse = (struct ers_list *)&cache->Blocks[cache->Used - 1][static_cast<size_t>( cache->Free ) * static_cast<size_t>( cache->ObjectSize )];
+		}
+
+		reuse->Next = magazine.Head;
+		magazine.Head = reuse;
+		magazine.Count++;
+	}
+}
+
+/**
+ * Returns the magazines of a thread that ended to their caches
+ */
+ers_thread_local::~ers_thread_local()
+{
+	if (this->Thread == nullptr)
+		return;
+
+	for (uint32 i = 0; i < ERS_THREADSAFE_MAX; i++) {
+		ers_cache_t *cache = ThreadSafeCaches[i];
+
+		if (cache != nullptr && cache->Generation == this->Magazines[i].Generation)
+			ers_depot_spill(cache, this->Magazines[i].Head, this->Magazines[i].Count);
+
+		this->Magazines[i].Head = nullptr;
+		this->Magazines[i].Count = 0;
+	}
+
+	this->Thread->Running = false;
+}
+
+static inline void ers_stat_inc(std::atomic<uint64> &stat)
+{
+	// Only the owning thread writes, no read-modify-write needed
+	stat.store(stat.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the magazine and statistics of the current thread for a thread-safe cache
+ */
+static inline struct ers_magazine &ers_thread_magazine(ers_cache_t *cache, struct ers_thread_stats *&stats)
+{
+	struct ers_thread_local &local = ErsThread;
+
+	if (local.Thread == nullptr) {
+		std::lock_guard<std::mutex> lock(ers_threads_lock());
+		std::vector<struct ers_thread *> &threads = ers_threads();
+
+		local.Thread = new struct ers_thread();
+		local.Thread->Id = static_cast<uint32>( threads.size() );
+		local.Thread->Running = true;
+		threads.push_back(local.Thread);
+	}
+
+	struct ers_magazine &magazine = local.Magazines[cache->Slot];
+
+	stats = &local.Thread->Stats[cache->Slot];
+
+	if (magazine.Generation != cache->Generation) {
+		// Entries of a destroyed cache that used the same slot, their memory is gone
+		magazine.Head = nullptr;
+		magazine.Count = 0;
+		magazine.Generation = cache->Generation;
+		stats->Allocs = 0;
+		stats->Frees = 0;
+		stats->Refills = 0;
+		stats->Spills = 0;
+		stats->Generation = cache->Generation;
+	}
+
+	return magazine;
+}
+
+static void *ers_obj_alloc_entry_threadsafe(ERS *self)
+{
+	struct ers_instance_t *instance = (struct ers_instance_t *)self;
+
+	if (instance == nullptr) {
+		ShowError("ers_obj_alloc_entry: nullptr object, aborting entry freeing.\n");
+		return nullptr;
+	}
+
+	struct ers_thread_stats *stats;
+	struct ers_magazine &magazine = ers_thread_magazine(instance->Cache, stats);
+
+	if (magazine.Head == nullptr) {
+		ers_depot_refill(instance->Cache, magazine);
+		ers_stat_inc(stats->Refills);
+	}
+
+	struct ers_list *reuse = magazine.Head;
+
+	magazine.Head = reuse->Next;
+	magazine.Count--;
+	ers_stat_inc(stats->Allocs);
+
+	return (unsigned char *)reuse + sizeof(struct ers_list);
+}
+
+static void ers_obj_free_entry_threadsafe(ERS *self, void *entry)
+{
+	struct ers_instance_t *instance = (struct ers_instance_t *)self;
+	struct ers_list *reuse = (struct ers_list *)((unsigned char *)entry - sizeof(struct ers_list));
+
+	if (instance == nullptr) {
+		ShowError("ers_obj_free_entry: nullptr object, aborting entry freeing.\n");
+		return;
+	} else if (entry == nullptr) {
+		ShowError("ers_obj_free_entry: nullptr entry, nothing to free.\n");
+		return;
+	}
+
+	if( instance->Cache->Options & ERS_OPT_CLEAN )
+		memset((unsigned char*)reuse + sizeof(struct ers_list), 0, instance->Cache->ObjectSize - sizeof(struct ers_list));
+
+	struct ers_thread_stats *stats;
+	struct ers_magazine &magazine = ers_thread_magazine(instance->Cache, stats);
+
+	if (magazine.Count >= ERS_MAGAZINE_SIZE) {
+		ers_depot_spill(instance->Cache, magazine.Head, magazine.Count);
+		ers_stat_inc(stats->Spills);
+		magazine.Head = nullptr;
+		magazine.Count = 0;
+	}
+
+	reuse->Next = magazine.Head;
+	magazine.Head = reuse;
+	magazine.Count++;
+	ers_stat_inc(stats->Frees);
+}
+
+/**
+ * Counts the entries of a thread-safe cache in use, from the statistics of all threads
+ */
+static int64 ers_threadsafe_used(ers_cache_t *cache)
+{
+	std::lock_guard<std::mutex> lock(ers_threads_lock());
+	int64 used = 0;
+
+	for (struct ers_thread *thread : ers_threads()) {
+		struct ers_thread_stats &stats = thread->Stats[cache->Slot];
+
+		if (stats.Generation == cache->Generation)
+			used += static_cast<int64>( stats.Allocs.load() ) - static_cast<int64>( stats.Frees.load() );
+	}
+
+	return used;
+}
+
 static size_t ers_obj_entry_size(ERS *self)
 {
 	struct ers_instance_t *instance = (struct ers_instance_t *)self;
@@ -256,6 +732,10 @@ static void ers_obj_destroy(ERS *self)
 		return;
 	}
 
+	// Thread-safe instances only count per cache, checked when the last one is destroyed
+	if (instance->Options & ERS_OPT_THREADSAFE && instance->Cache->ReferenceCount == 1)
+		instance->Count = static_cast<uint32>( std::max<int64>( ers_threadsafe_used(instance->Cache), 0 ) );
+
 	if (instance->Count > 0)
 		if (!(instance->Options & ERS_OPT_CLEAR))
 			ShowWarning("Memory leak detected at ERS '%s', %d objects not freed.\n", instance->Name, instance->Count);
@@ -302,16 +782,28 @@ ERS *ers_new(uint32 size, const char *name, enum ERSOptions options)
 		size += ERS_ALIGNED - size % ERS_ALIGNED;
 #endif
 
-	instance->VTable.alloc = ers_obj_alloc_entry;
-	instance->VTable.free = ers_obj_free_entry;
+	instance->Name = ( options & ERS_OPT_FREE_NAME ) ? (char *)aStrdup(name) : (char *)name;
+
+	if ((options & ERS_OPT_THREADSAFE) && (instance->Cache = ers_find_cache(size, options)) == nullptr) {
+		ShowError("ers_new: Too many thread-safe caches, '%s' can only be used by one thread.\n", instance->Name);
+		options = (enum ERSOptions)(options & ~ERS_OPT_THREADSAFE);
+	}
+
+	if (options & ERS_OPT_THREADSAFE) {
+		instance->VTable.alloc = ers_obj_alloc_entry_threadsafe;
+		instance->VTable.free = ers_obj_free_entry_threadsafe;
+	} else {
+		instance->VTable.alloc = ers_obj_alloc_entry;
+		instance->VTable.free = ers_obj_free_entry;
+	}
 	instance->VTable.entry_size = ers_obj_entry_size;
 	instance->VTable.destroy = ers_obj_destroy;
 	instance->VTable.chunk_size = ers_cache_size;
 
-	instance->Name = ( options & ERS_OPT_FREE_NAME ) ? (char *)aStrdup(name) : (char *)name;
 	instance->Options = options;
 
-	instance->Cache = ers_find_cache(size,instance->Options);
+	if (!(options & ERS_OPT_THREADSAFE))
+		instance->Cache = ers_find_cache(size,instance->Options);
 
 	instance->Cache->ReferenceCount++;
 
@@ -325,6 +817,7 @@ ERS *ers_new(uint32 size, const char *name, enum ERSOptions options)
 	}
 
 	instance->Count = 0;
+	instance->Peak = 0;
 
 	return &instance->VTable;
 }
@@ -334,17 +827,43 @@ void ers_report(void) {
 	uint32 cache_c = 0, blocks_u = 0, blocks_a = 0, memory_b = 0, memory_t = 0;
 
 	for (cache = CacheList; cache; cache = cache->Next) {
+		uint32 used = cache->UsedObjs, unused = cache->Free;
+
+		// Thread-safe caches do not count centrally, the threads keep the statistics
+		if (cache->Options & ERS_OPT_THREADSAFE) {
+			used = static_cast<uint32>( std::max<int64>( ers_threadsafe_used(cache), 0 ) );
+			unused = cache->Total - used;
+		}
+
 		cache_c++;
 		ShowMessage(CL_BOLD"[ERS Cache of size '" CL_NORMAL "" CL_WHITE "%u" CL_NORMAL "" CL_BOLD "' report]\n" CL_NORMAL, cache->ObjectSize);
 		ShowMessage("\tinstances          : %u\n", cache->ReferenceCount);
-		ShowMessage("\tblocks in use      : %u/%u\n", cache->UsedObjs, cache->UsedObjs+cache->Free);
-		ShowMessage("\tblocks unused      : %u\n", cache->Free);
-		ShowMessage("\tmemory in use      : %.2f MB\n", cache->UsedObjs == 0 ? 0. : (double)((cache->UsedObjs * cache->ObjectSize)/1024)/1024);
-		ShowMessage("\tmemory allocated   : %.2f MB\n", (cache->Free+cache->UsedObjs) == 0 ? 0. : (double)(((cache->UsedObjs+cache->Free) * cache->ObjectSize)/1024)/1024);
-		blocks_u += cache->UsedObjs;
-		blocks_a += cache->UsedObjs + cache->Free;
-		memory_b += cache->UsedObjs * cache->ObjectSize;
-		memory_t += (cache->UsedObjs+cache->Free) * cache->ObjectSize;
+		ShowMessage("\tblocks in use      : %u/%u\n", used, used+unused);
+		ShowMessage("\tblocks unused      : %u\n", unused);
+		ShowMessage("\tmemory in use      : %.2f MB\n", used == 0 ? 0. : (double)((used * cache->ObjectSize)/1024)/1024);
+		ShowMessage("\tmemory allocated   : %.2f MB\n", (unused+used) == 0 ? 0. : (double)(((used+unused) * cache->ObjectSize)/1024)/1024);
+		blocks_u += used;
+		blocks_a += used + unused;
+		memory_b += used * cache->ObjectSize;
+		memory_t += (used+unused) * cache->ObjectSize;
+
+		if (cache->Options & ERS_OPT_THREADSAFE) {
+			std::lock_guard<std::mutex> lock(ers_threads_lock());
+
+			for (struct ers_thread *thread : ers_threads()) {
+				struct ers_thread_stats &stats = thread->Stats[cache->Slot];
+
+				if (stats.Generation != cache->Generation)
+					continue;
+
+				ShowMessage("\tthread %-3u%s       : %" PRIu64 " allocs, %" PRIu64 " frees, %" PRIu64 " refills, %" PRIu64 " spills\n",
+					thread->Id, thread->Running ? "" : "(end)", stats.Allocs.load(), stats.Frees.load(), stats.Refills.load(), stats.Spills.load());
+			}
+		}
+	}
+	for (struct ers_instance_t *instance = InstanceList; instance; instance = instance->Next) {
+		if (instance->Peak > 0)
+			ShowMessage("\t[ERS '" CL_WHITE "%s" CL_NORMAL "'] in use: %u, peak: %u\n", instance->Name, instance->Count, instance->Peak);
 	}
 	ShowInfo("ers_report: '" CL_WHITE "%u" CL_NORMAL "' caches in use\n",cache_c);
 	ShowInfo("ers_report: '" CL_WHITE "%u" CL_NORMAL "' blocks in use, consuming '" CL_WHITE "%.2f MB" CL_NORMAL "'\n",blocks_u,(double)((memory_b)/1024)/1024);
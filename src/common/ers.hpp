@@ -77,6 +77,8 @@ enum ERSOptions {
 	ERS_OPT_FREE_NAME   = 0x04,/* name is dynamic memory, and should be freed */
 	ERS_OPT_CLEAN       = 0x08,/* clears used memory upon ers_free so that its all new to be reused on the next alloc */
 	ERS_OPT_FLEX_CHUNK  = 0x10,/* signs that it should look for its own cache given it'll have a dynamic chunk size, so that it doesn't affect the other ERS it'd otherwise be sharing */
+	ERS_OPT_HUGEPAGES   = 0x20,/* allocates the chunks from huge pages where the system supports them, the cache is not shared with caches without it */
+	ERS_OPT_THREADSAFE  = 0x40,/* entries can be allocated and freed from any thread, each thread keeps a magazine of free entries */
 
 	/* Compound, is used to determine whether it should be looking for a cache of matching options */
 	ERS_CACHE_OPTIONS   = ERS_OPT_CLEAN|ERS_OPT_FLEX_CHUNK,
@@ -3,9 +3,14 @@
 
 #include "malloc.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "core.hpp"
 #include "showmsg.hpp"
@@ -61,6 +66,7 @@
 
 #else
 
+#	define MALLOC_BACKEND
 #	define MALLOC(n,file,line,func)	malloc(n)
 #	define CALLOC(m,n,file,line,func)	calloc((m),(n))
 #	define REALLOC(p,n,file,line,func)	realloc((p),(n))
@@ -72,6 +78,403 @@
 
 #endif
 
+////////////// Allocation Sites //////////////////
+
+#ifdef MALLOC_SITE_STATS
+
+/// Statistics of a call site that allocates memory
+/// Sites are never released, memory headers keep pointing to them until the end.
+struct s_malloc_site {
+	const char* file;
+	int32 line;
+	const char* func;
+	std::atomic<uint64> allocs; ///< Allocations made in total
+	std::atomic<int64> count; ///< Allocations in use
+	std::atomic<int64> bytes; ///< Bytes in use
+};
+
+struct s_malloc_site_key {
+	const char* file;
+	int32 line;
+
+	bool operator==( const s_malloc_site_key& other ) const {
+		return this->file == other.file && this->line == other.line;
+	}
+};
+
+struct s_malloc_site_hash {
+	size_t operator()( const s_malloc_site_key& key ) const {
+		return std::hash<const char*>()( key.file ) ^ ( static_cast<size_t>( key.line ) * 2654435761u );
+	}
+};
+
+typedef std::unordered_map<s_malloc_site_key, s_malloc_site*, s_malloc_site_hash> malloc_site_map;
+
+// Function statics, allocations can happen during static initialization
+static std::mutex& malloc_site_mutex( void ){
+	static std::mutex mutex;
+
+	return mutex;
+}
+
+static malloc_site_map& malloc_sites( void ){
+	// Never destroyed, memory can still be freed during static destruction
+	static malloc_site_map* sites = new malloc_site_map();
+
+	return *sites;
+}
+
+/**
+ * Returns the statistics of a call site, created on first use
+ * Every thread remembers the sites it used, so only the first allocation of a thread at a site takes the lock.
+ */
+static s_malloc_site* malloc_site( const char* file, int32 line, const char* func ){
+	thread_local malloc_site_map cache;
+	s_malloc_site_key key = { file, line };
+	auto it = cache.find( key );
+
+	if( it != cache.end() )
+		return it->second;
+
+	s_malloc_site* site;
+
+	{
+		std::lock_guard<std::mutex> lock( malloc_site_mutex() );
+		malloc_site_map& sites = malloc_sites();
+		auto found = sites.find( key );
+
+		if( found != sites.end() ){
+			site = found->second;
+		}else{
+			site = new s_malloc_site{ file, line, func };
+			sites[key] = site;
+		}
+	}
+
+	cache[key] = site;
+
+	return site;
+}
+
+static inline void malloc_site_add( s_malloc_site* site, size_t size ){
+	site->allocs.fetch_add( 1, std::memory_order_relaxed );
+	site->count.fetch_add( 1, std::memory_order_relaxed );
+	site->bytes.fetch_add( static_cast<int64>( size ), std::memory_order_relaxed );
+}
+
+static inline void malloc_site_remove( s_malloc_site* site, size_t size ){
+	site->count.fetch_sub( 1, std::memory_order_relaxed );
+	site->bytes.fetch_sub( static_cast<int64>( size ), std::memory_order_relaxed );
+}
+
+// Freed memory is counted off the site that allocated it, so the site already exists
+#define MALLOC_SITE_ADD(file,line,func,size) malloc_site_add( malloc_site( (file), (line), (func) ), (size) )
+#define MALLOC_SITE_REMOVE(file,line,size) malloc_site_remove( malloc_site( (file), (line), nullptr ), (size) )
+
+#else
+
+#define MALLOC_SITE_ADD(file,line,func,size)
+#define MALLOC_SITE_REMOVE(file,line,size)
+
+#endif /* MALLOC_SITE_STATS */
+
+#ifdef MALLOC_BACKEND
+
+////////////// Backends //////////////////
+
+static void* malloc_system_alloc( size_t size ){
+	return malloc( size );
+}
+
+static void* malloc_system_realloc( void* p, size_t old_size, size_t size ){
+	return realloc( p, size );
+}
+
+static void malloc_system_free( void* p, size_t size ){
+	free( p );
+}
+
+const s_malloc_backend malloc_backend_system = { "system", malloc_system_alloc, malloc_system_realloc, malloc_system_free };
+
+/*
+ * Size class backend
+ *     Small allocations are rounded up to a multiple of SIZECLASS_ALIGNMENT and taken from a free list
+ *     of their class. Every thread has its own free lists, so allocating and freeing does not lock.
+ *     Threads with too many free entries of a class hand a batch to the shared depot, threads without
+ *     one take a batch from there before carving a new slab from the system.
+ *     Slabs are never returned to the system, like the blocks of the memory manager.
+ */
+
+/// Distance between two size classes
+#define SIZECLASS_ALIGNMENT 16
+/// Number of size classes, larger allocations are passed to the system allocator
+#define SIZECLASS_COUNT 64
+#define SIZECLASS_MAX ( SIZECLASS_ALIGNMENT * SIZECLASS_COUNT )
+/// Entries carved at once from memory requested from the system
+#define SIZECLASS_SLAB_COUNT 64
+/// Free entries a thread keeps per class before it returns a batch to the depot
+#define SIZECLASS_CACHE_MAX 256
+/// Entries moved between a thread and the depot at once
+#define SIZECLASS_BATCH 128
+
+struct s_sizeclass_entry {
+	s_sizeclass_entry* next;
+};
+
+struct s_sizeclass_list {
+	s_sizeclass_entry* head;
+	uint32 count;
+};
+
+/// Free entries shared by all threads
+struct s_sizeclass_depot {
+	std::mutex mutex;
+	s_sizeclass_list lists[SIZECLASS_COUNT];
+};
+
+static s_sizeclass_depot& sizeclass_depot( void ){
+	static s_sizeclass_depot depot;
+
+	return depot;
+}
+
+static std::atomic<size_t> sizeclass_slab_bytes;
+
+/**
+ * Moves up to count entries from one free list to another
+ */
+static void sizeclass_move( s_sizeclass_list& from, s_sizeclass_list& to, uint32 count ){
+	for( ; count > 0 && from.head != nullptr; count-- ){
+		s_sizeclass_entry* entry = from.head;
+
+		from.head = entry->next;
+		from.count--;
+		entry->next = to.head;
+		to.head = entry;
+		to.count++;
+	}
+}
+
+/// Free entries of a thread, handed to the depot when the thread ends
+struct s_sizeclass_cache {
+	s_sizeclass_list lists[SIZECLASS_COUNT];
+
+	~s_sizeclass_cache(){
+		s_sizeclass_depot& depot = sizeclass_depot();
+		std::lock_guard<std::mutex> lock( depot.mutex );
+
+		for( uint32 i = 0; i < SIZECLASS_COUNT; i++ ){
+			sizeclass_move( this->lists[i], depot.lists[i], this->lists[i].count );
+		}
+	}
+};
+
+static thread_local s_sizeclass_cache sizeclass_cache;
+
+static inline uint32 sizeclass_index( size_t size ){
+	return static_cast<uint32>( ( size + SIZECLASS_ALIGNMENT - 1 ) / SIZECLASS_ALIGNMENT - 1 );
+}
+
+static void* malloc_sizeclass_alloc( size_t size ){
+	if( size > SIZECLASS_MAX )
+		return malloc( size );
+
+	uint32 index = sizeclass_index( size );
+	s_sizeclass_list& list = sizeclass_cache.lists[index];
+
+	if( list.head == nullptr ){
+		s_sizeclass_depot& depot = sizeclass_depot();
+		std::lock_guard<std::mutex> lock( depot.mutex );
+
+		sizeclass_move( depot.lists[index], list, SIZECLASS_BATCH );
+	}
+
+	if( list.head == nullptr ){
+		size_t entry_size = ( index + 1 ) * SIZECLASS_ALIGNMENT;
+		char* slab = static_cast<char*>( malloc( entry_size * SIZECLASS_SLAB_COUNT ) );
+
+		if( slab == nullptr )
+			return nullptr;
+
+		sizeclass_slab_bytes.fetch_add( entry_size * SIZECLASS_SLAB_COUNT, std::memory_order_relaxed );
+
+		for( size_t i = 0; i < SIZECLASS_SLAB_COUNT; i++ ){
+			s_sizeclass_entry* entry = reinterpret_cast<s_sizeclass_entry*>( slab + i * entry_size );
+
+			entry->next = list.head;
+			list.head = entry;
+			list.count++;
+		}
+	}
+
+	s_sizeclass_entry* entry = list.head;
+
+	list.head = entry->next;
+	list.count--;
+
+	return entry;
+}
+
+static void malloc_sizeclass_free( void* p, size_t size ){
+	if( size > SIZECLASS_MAX ){
+		free( p );
+		return;
+	}
+
+	uint32 index = sizeclass_index( size );
+	s_sizeclass_list& list = sizeclass_cache.lists[index];
+	s_sizeclass_entry* entry = static_cast<s_sizeclass_entry*>( p );
+
+	entry->next = list.head;
+	list.head = entry;
+	list.count++;
+
+	if( list.count > SIZECLASS_CACHE_MAX ){
+		s_sizeclass_depot& depot = sizeclass_depot();
+		std::lock_guard<std::mutex> lock( depot.mutex );
+
+		sizeclass_move( list, depot.lists[index], SIZECLASS_BATCH );
+	}
+}
+
+static void* malloc_sizeclass_realloc( void* p, size_t old_size, size_t size ){
+	if( old_size > SIZECLASS_MAX && size > SIZECLASS_MAX )
+		return realloc( p, size );
+
+	// Still fits into its entry
+	if( old_size <= SIZECLASS_MAX && size <= SIZECLASS_MAX && sizeclass_index( old_size ) == sizeclass_index( size ) )
+		return p;
+
+	void* ret = malloc_sizeclass_alloc( size );
+
+	if( ret != nullptr ){
+		memcpy( ret, p, std::min( old_size, size ) );
+		malloc_sizeclass_free( p, old_size );
+	}
+
+	return ret;
+}
+
+const s_malloc_backend malloc_backend_sizeclass = { "sizeclass", malloc_sizeclass_alloc, malloc_sizeclass_realloc, malloc_sizeclass_free };
+
+#ifdef MALLOC_SIZECLASS
+static const s_malloc_backend* malloc_backend = &malloc_backend_sizeclass;
+#else
+static const s_malloc_backend* malloc_backend = &malloc_backend_system;
+#endif
+
+static std::atomic<size_t> malloc_backend_bytes; // Bytes in use by aMalloc_ and co.
+static std::atomic<bool> malloc_backend_used; // The backend can only be changed before the first allocation
+
+/// Header in front of the memory returned by aMalloc_ and co.
+/// Callers of aFree_ do not know the size the backend needs, so it is kept in here.
+/// Padded to 16 bytes to keep the alignment of malloc.
+struct alignas(16) s_malloc_head {
+#ifdef MALLOC_SITE_STATS
+	s_malloc_site* site;
+#endif
+	size_t size;
+};
+
+/**
+ * Changes the allocator behind aMalloc_ and co.
+ * @param backend: New backend
+ * @return false if memory was already allocated by the current backend
+ */
+bool malloc_set_backend( const s_malloc_backend* backend ){
+	if( backend == nullptr || malloc_backend_used.load( std::memory_order_relaxed ) )
+		return false;
+
+	malloc_backend = backend;
+
+	return true;
+}
+
+static void* malloc_backend_alloc( size_t size, const char* file, int32 line, const char* func, const char* name ){
+	if( !malloc_backend_used.load( std::memory_order_relaxed ) )
+		malloc_backend_used = true;
+
+	s_malloc_head* head = static_cast<s_malloc_head*>( malloc_backend->alloc( sizeof( s_malloc_head ) + size ) );
+
+	if( head == nullptr ){
+		ShowFatalError( "%s:%d: in func %s: %s error out of memory!\n", file, line, func, name );
+		exit( EXIT_FAILURE );
+	}
+
+#ifdef MALLOC_SITE_STATS
+	head->site = malloc_site( file, line, func );
+	malloc_site_add( head->site, size );
+#endif
+	head->size = size;
+	malloc_backend_bytes.fetch_add( size, std::memory_order_relaxed );
+
+	return head + 1;
+}
+
+void* aMalloc_(size_t size, const char *file, int32 line, const char *func)
+{
+	return malloc_backend_alloc( size, file, line, func, "aMalloc" );
+}
+void* aCalloc_(size_t num, size_t size, const char *file, int32 line, const char *func)
+{
+	void* ret = malloc_backend_alloc( num * size, file, line, func, "aCalloc" );
+
+	memset( ret, 0, num * size );
+	return ret;
+}
+void* aRealloc_(void *p, size_t size, const char *file, int32 line, const char *func)
+{
+	if( p == nullptr )
+		return malloc_backend_alloc( size, file, line, func, "aRealloc" );
+
+	s_malloc_head* head = static_cast<s_malloc_head*>( p ) - 1;
+	size_t old_size = head->size;
+
+#ifdef MALLOC_SITE_STATS
+	malloc_site_remove( head->site, old_size );
+#endif
+	head = static_cast<s_malloc_head*>( malloc_backend->realloc( head, sizeof( s_malloc_head ) + old_size, sizeof( s_malloc_head ) + size ) );
+
+	if( head == nullptr ){
+		ShowFatalError("%s:%d: in func %s: aRealloc error out of memory!\n",file,line,func);
+		exit(EXIT_FAILURE);
+	}
+
+#ifdef MALLOC_SITE_STATS
+	// The memory now belongs to the site that resized it
+	head->site = malloc_site( file, line, func );
+	malloc_site_add( head->site, size );
+#endif
+	head->size = size;
+	malloc_backend_bytes.fetch_add( size, std::memory_order_relaxed );
+	malloc_backend_bytes.fetch_sub( old_size, std::memory_order_relaxed );
+
+	return head + 1;
+}
+char* aStrdup_(const char *p, const char *file, int32 line, const char *func)
+{
+	size_t len = strlen( p );
+	char* ret = static_cast<char*>( malloc_backend_alloc( len + 1, file, line, func, "aStrdup" ) );
+
+	memcpy( ret, p, len + 1 );
+	return ret;
+}
+void aFree_(void *p, const char *file, int32 line, const char *func)
+{
+	if( p == nullptr )
+		return;
+
+	s_malloc_head* head = static_cast<s_malloc_head*>( p ) - 1;
+
+#ifdef MALLOC_SITE_STATS
+	malloc_site_remove( head->site, head->size );
+#endif
+	malloc_backend_bytes.fetch_sub( head->size, std::memory_order_relaxed );
+	malloc_backend->free( head, sizeof( s_malloc_head ) + head->size );
+}
+
+#else /* MALLOC_BACKEND */
+
 void* aMalloc_(size_t size, const char *file, int32 line, const char *func)
 {
 	void *ret = MALLOC(size, file, line, func);
@@ -121,6 +524,8 @@ void aFree_(void *p, const char *file, int32 line, const char *func)
 }
 
 
+#endif /* MALLOC_BACKEND */
+
 #ifdef USE_MEMMGR
 
 #if defined(DEBUG)
@@ -164,6 +569,7 @@ void aFree_(void *p, const char *file, int32 line, const char *func)
 
 /* block */
 struct block {
+	struct s_memmgr_arena* arena;	/* The arena owning the block */
 	struct block* block_next;		/* Then the allocated area */
 	struct block* unfill_prev;		/* The previous area not filled */
 	struct block* unfill_next;		/* The next area not filled */
@@ -184,22 +590,62 @@ struct unit_head {
 	long           checksum;
 };
 
-static struct block* hash_unfill[BLOCK_DATA_COUNT1 + BLOCK_DATA_COUNT2 + 1];
-static struct block* block_first, *block_last, block_head;
-
 /* Data for areas that do not use the memory be turned */
 struct unit_head_large {
+	struct s_memmgr_arena*  arena;
 	size_t                  size;
 	struct unit_head_large* prev;
 	struct unit_head_large* next;
 	struct unit_head        unit_head;
 };
 
-static struct unit_head_large *unit_head_large_first = nullptr;
+/* Unit or large area freed by another thread than the owner of its arena, stored in the freed data */
+struct s_memmgr_remote {
+	struct s_memmgr_remote* next;
+	size_t                  size;
+};
+
+/* unit_head.size of memory waiting in a remote free list */
+#define MEMMGR_REMOTE_FREED 0xFFFE
+
+/*
+ * Arena
+ *     Every thread that allocates gets an arena of its own, so allocating and freeing memory of
+ *     the own thread does not lock. Blocks and large areas always return to the arena they came
+ *     from: memory freed by another thread is put into the remote free list of the owner, which
+ *     releases it on its next allocation. Arenas of ended threads are reused by new threads, until
+ *     then memory freed into them is released under the lock.
+ */
+struct s_memmgr_arena {
+	struct block* hash_unfill[BLOCK_DATA_COUNT1 + BLOCK_DATA_COUNT2 + 1];
+	struct unit_head_large* large_first;
+	std::atomic<size_t> usage_bytes;					/* Only written by the owner */
+	std::atomic<struct s_memmgr_remote*> remote_free;
+	struct s_memmgr_arena* next;
+	std::atomic<bool> in_use;							/* Owned by a running thread, only changed under the lock */
+};
+
+static struct block* block_first, *block_last, block_head;
+static struct s_memmgr_arena* memmgr_arena_first;
+static std::mutex memmgr_mutex;		/* Guards the block chain and the arena list */
+
+static thread_local struct s_memmgr_arena* memmgr_arena_local;
+
+static struct block* block_malloc(struct s_memmgr_arena* arena, uint16 hash);
+static void          block_free(struct s_memmgr_arena* arena, struct block* p);
+static void          memmgr_release_remote(struct s_memmgr_arena* arena);
 
-static struct block* block_malloc(uint16 hash);
-static void          block_free(struct block* p);
-static size_t        memmgr_usage_bytes;
+/* Returns the arena of a thread to the unused ones when it ends */
+struct s_memmgr_arena_owner {
+	~s_memmgr_arena_owner(){
+		std::lock_guard<std::mutex> lock( memmgr_mutex );
+
+		memmgr_release_remote( memmgr_arena_local );
+		// Memory freed after this point is handled as freed by another thread
+		memmgr_arena_local->in_use = false;
+		memmgr_arena_local = nullptr;
+	}
+};
 
 #define block2unit(p, n) ((struct unit_head*)(&(p)->data[ p->unit_size * (n) ]))
 #define memmgr_assert(v) do { if(!(v)) { ShowError("Memory manager: assertion '" #v "' failed!\n"); } } while(0)
@@ -225,6 +671,53 @@ static size_t hash2size( uint16 hash )
 	}
 }
 
+/**
+ * Returns the arena of the calling thread, an unused or new one on its first allocation
+ */
+static struct s_memmgr_arena* memmgr_arena( void )
+{
+	if( memmgr_arena_local != nullptr )
+		return memmgr_arena_local;
+
+	struct s_memmgr_arena* arena;
+
+	{
+		std::lock_guard<std::mutex> lock( memmgr_mutex );
+
+		for( arena = memmgr_arena_first; arena != nullptr && arena->in_use; arena = arena->next );
+
+		if( arena == nullptr ){
+			arena = (struct s_memmgr_arena*)MALLOC(sizeof(struct s_memmgr_arena), __FILE__, __LINE__, __func__ );
+			if( arena == nullptr ) {
+				ShowFatalError("Memory manager::arena_alloc failed.\n");
+				exit(EXIT_FAILURE);
+			}
+			new(arena) s_memmgr_arena{};
+			arena->next = memmgr_arena_first;
+			memmgr_arena_first = arena;
+		}
+
+		arena->in_use = true;
+	}
+
+	memmgr_arena_local = arena;
+
+	// Only constructed once per thread, an arena taken after the owner ended is kept until the process ends
+	static thread_local s_memmgr_arena_owner owner;
+
+	return arena;
+}
+
+static inline void memmgr_usage_add( struct s_memmgr_arena* arena, size_t size )
+{
+	arena->usage_bytes.store( arena->usage_bytes.load( std::memory_order_relaxed ) + size, std::memory_order_relaxed );
+}
+
+static inline void memmgr_usage_sub( struct s_memmgr_arena* arena, size_t size )
+{
+	arena->usage_bytes.store( arena->usage_bytes.load( std::memory_order_relaxed ) - size, std::memory_order_relaxed );
+}
+
 void* _mmalloc(size_t size, const char *file, int32 line, const char *func )
 {
 	struct block *block;
@@ -236,26 +729,33 @@ void* _mmalloc(size_t size, const char *file, int32 line, const char *func )
 		return nullptr;
 	}
 
-	memmgr_usage_bytes += size;
+	struct s_memmgr_arena* arena = memmgr_arena();
+
+	if( arena->remote_free.load( std::memory_order_relaxed ) != nullptr )
+		memmgr_release_remote( arena );
+
+	memmgr_usage_add( arena, size );
+	MALLOC_SITE_ADD( file, line, func, size );
 
 	/* To ensure the area that exceeds the length of the block, using malloc () to */
 	/* At that time, the distinction by assigning nullptr to unit_head.block */
 	if(hash2size(size_hash) > BLOCK_DATA_SIZE - sizeof(struct unit_head)) {
 		struct unit_head_large* p = (struct unit_head_large*)MALLOC(sizeof(struct unit_head_large)+size,file,line,func);
 		if(p != nullptr) {
+			p->arena           = arena;
 			p->size            = size;
 			p->unit_head.block = nullptr;
 			p->unit_head.size  = 0;
 			p->unit_head.file  = file;
 			p->unit_head.line  = line;
 			p->prev = nullptr;
-			if (unit_head_large_first == nullptr)
+			if (arena->large_first == nullptr)
 				p->next = nullptr;
 			else {
-				unit_head_large_first->prev = p;
-				p->next = unit_head_large_first;
+				arena->large_first->prev = p;
+				p->next = arena->large_first;
 			}
-			unit_head_large_first = p;
+			arena->large_first = p;
 			*(long*)((char*)p + sizeof(struct unit_head_large) - sizeof(long) + size) = FREED_POINTER;
 			return (char *)p + sizeof(struct unit_head_large) - sizeof(long);
 		} else {
@@ -265,10 +765,10 @@ void* _mmalloc(size_t size, const char *file, int32 line, const char *func )
 	}
 
 	/* When a block of the same size is not ensured, to ensure a new */
-	if(hash_unfill[size_hash]) {
-		block = hash_unfill[size_hash];
+	if(arena->hash_unfill[size_hash]) {
+		block = arena->hash_unfill[size_hash];
 	} else {
-		block = block_malloc(size_hash);
+		block = block_malloc(arena, size_hash);
 	}
 
 	if( block->unit_unfill == 0xFFFF ) {
@@ -287,7 +787,7 @@ void* _mmalloc(size_t size, const char *file, int32 line, const char *func )
 	if( block->unit_unfill == 0xFFFF && block->unit_maxused >= block->unit_count) {
 		// Since I ran out of the unit, removed from the list unfill
 		if( block->unfill_prev == &block_head) {
-			hash_unfill[ size_hash ] = block->unfill_next;
+			arena->hash_unfill[ size_hash ] = block->unfill_next;
 		} else {
 			block->unfill_prev->unfill_next = block->unfill_next;
 		}
@@ -371,6 +871,104 @@ char* _mstrdup(const char *p, const char *file, int32 line, const char *func )
 	}
 }
 
+/* Releases a checked large area into the arena owning it */
+static void memmgr_release_large( struct s_memmgr_arena* arena, struct unit_head_large* head_large, const char *file, int32 line, const char *func )
+{
+	head_large->unit_head.size = 0xFFFF;
+	if(head_large->prev) {
+		head_large->prev->next = head_large->next;
+	} else {
+		arena->large_first     = head_large->next;
+	}
+	if(head_large->next) {
+		head_large->next->prev = head_large->prev;
+	}
+	memmgr_usage_sub( arena, head_large->size );
+	MALLOC_SITE_REMOVE( head_large->unit_head.file, head_large->unit_head.line, head_large->size );
+#ifdef DEBUG_MEMMGR
+	// set freed memory to 0xfd
+	memset((char *)head_large + sizeof(struct unit_head_large) - sizeof(long), 0xfd, head_large->size);
+#endif
+	FREE(head_large,file,line,func);
+}
+
+/* Releases a checked unit into the arena owning its block */
+static void memmgr_release_unit( struct s_memmgr_arena* arena, struct unit_head* head, const char *file, int32 line, const char *func )
+{
+	struct block *block = head->block;
+
+	memmgr_usage_sub( arena, head->size );
+	MALLOC_SITE_REMOVE( head->file, head->line, head->size );
+	head->block         = nullptr;
+#ifdef DEBUG_MEMMGR
+	memset((char *)head + sizeof(struct unit_head) - sizeof(long), 0xfd, block->unit_size - sizeof(struct unit_head) + sizeof(long) );
+	head->file = file;
+	head->line = line;
+#endif
+	memmgr_assert( block->unit_used > 0 );
+	if(--block->unit_used == 0) {
+		/* Release of the block */
+		block_free(arena, block);
+	} else {
+		if( block->unfill_prev == nullptr) {
+			// add to unfill list
+			if( arena->hash_unfill[ block->unit_hash ] ) {
+				arena->hash_unfill[ block->unit_hash ]->unfill_prev = block;
+			}
+			block->unfill_prev = &block_head;
+			block->unfill_next = arena->hash_unfill[ block->unit_hash ];
+			arena->hash_unfill[ block->unit_hash ] = block;
+		}
+		head->size     = block->unit_unfill;
+		block->unit_unfill = (uint16)(((uintptr_t)head - (uintptr_t)block->data) / block->unit_size);
+	}
+}
+
+/* Hands checked memory of another thread to the remote free list of its arena */
+static void memmgr_free_remote( struct s_memmgr_arena* arena, void* ptr, struct unit_head* head, const char *file, int32 line, const char *func )
+{
+	struct s_memmgr_remote* remote = (struct s_memmgr_remote*)ptr;
+
+	if( !arena->in_use.load( std::memory_order_relaxed ) ) {
+		std::lock_guard<std::mutex> lock( memmgr_mutex );
+
+		// The thread of the arena ended and no other took it over yet
+		if( !arena->in_use.load( std::memory_order_relaxed ) ) {
+			memmgr_release_remote( arena );
+			if( head->block == nullptr ) {
+				memmgr_release_large( arena, (struct unit_head_large *)((char *)ptr - sizeof(struct unit_head_large) + sizeof(long)), file, line, func );
+			} else {
+				memmgr_release_unit( arena, head, file, line, func );
+			}
+			return;
+		}
+	}
+
+	remote->size = head->size;
+	head->size   = MEMMGR_REMOTE_FREED;
+	remote->next = arena->remote_free.load( std::memory_order_relaxed );
+	while( !arena->remote_free.compare_exchange_weak( remote->next, remote, std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+/* Releases the memory other threads freed into an arena, called by its owner */
+static void memmgr_release_remote( struct s_memmgr_arena* arena )
+{
+	struct s_memmgr_remote* remote = arena->remote_free.exchange( nullptr, std::memory_order_acquire );
+
+	while( remote != nullptr ) {
+		struct s_memmgr_remote* next = remote->next;
+		struct unit_head* head = (struct unit_head *)((char *)remote - sizeof(struct unit_head) + sizeof(long));
+
+		head->size = (uint16)remote->size;
+		if( head->block == nullptr ) {
+			memmgr_release_large( arena, (struct unit_head_large *)((char *)remote - sizeof(struct unit_head_large) + sizeof(long)), ALC_MARK );
+		} else {
+			memmgr_release_unit( arena, head, ALC_MARK );
+		}
+		remote = next;
+	}
+}
+
 void _mfree(void *ptr, const char *file, int32 line, const char *func )
 {
 	struct unit_head *head;
@@ -387,69 +985,38 @@ void _mfree(void *ptr, const char *file, int32 line, const char *func )
 			!= FREED_POINTER)
 		{
 			ShowError("Memory manager: args of aFree 0x%p is overflowed pointer %s line %d\n", ptr, file, line);
+		} else if( head_large->arena == memmgr_arena_local ) {
+			memmgr_release_large( head_large->arena, head_large, file, line, func );
 		} else {
-			head->size = 0xFFFF;
-			if(head_large->prev) {
-				head_large->prev->next = head_large->next;
-			} else {
-				unit_head_large_first  = head_large->next;
-			}
-			if(head_large->next) {
-				head_large->next->prev = head_large->prev;
-			}
-			memmgr_usage_bytes -= head_large->size;
-#ifdef DEBUG_MEMMGR
-			// set freed memory to 0xfd
-			memset(ptr, 0xfd, head_large->size);
-#endif
-			FREE(head_large,file,line,func);
+			memmgr_free_remote( head_large->arena, ptr, head, file, line, func );
 		}
 	} else {
 		/* Release unit */
 		struct block *block = head->block;
-		if( (size_t)((char*)head - (char*)block) > sizeof(struct block) ) {
+		if( head->size == MEMMGR_REMOTE_FREED ) {
+			ShowError("Memory manager: args of aFree 0x%p is freed pointer %s:%d@%s\n", ptr, file, line, func);
+		} else if( (size_t)((char*)head - (char*)block) > sizeof(struct block) ) {
 			ShowError("Memory manager: args of aFree 0x%p is invalid pointer %s line %d\n", ptr, file, line);
 		} else if(head->block == nullptr) {
 			ShowError("Memory manager: args of aFree 0x%p is freed pointer %s:%d@%s\n", ptr, file, line, func);
 		} else if(*(long*)((char*)head + sizeof(struct unit_head) - sizeof(long) + head->size) != FREED_POINTER) {
 			ShowError("Memory manager: args of aFree 0x%p is overflowed pointer %s line %d\n", ptr, file, line);
+		} else if( block->arena == memmgr_arena_local ) {
+			memmgr_release_unit( block->arena, head, file, line, func );
 		} else {
-			memmgr_usage_bytes -= head->size;
-			head->block         = nullptr;
-#ifdef DEBUG_MEMMGR
-			memset(ptr, 0xfd, block->unit_size - sizeof(struct unit_head) + sizeof(long) );
-			head->file = file;
-			head->line = line;
-#endif
-			memmgr_assert( block->unit_used > 0 );
-			if(--block->unit_used == 0) {
-				/* Release of the block */
-				block_free(block);
-			} else {
-				if( block->unfill_prev == nullptr) {
-					// add to unfill list
-					if( hash_unfill[ block->unit_hash ] ) {
-						hash_unfill[ block->unit_hash ]->unfill_prev = block;
-					}
-					block->unfill_prev = &block_head;
-					block->unfill_next = hash_unfill[ block->unit_hash ];
-					hash_unfill[ block->unit_hash ] = block;
-				}
-				head->size     = block->unit_unfill;
-				block->unit_unfill = (uint16)(((uintptr_t)head - (uintptr_t)block->data) / block->unit_size);
-			}
+			memmgr_free_remote( block->arena, ptr, head, file, line, func );
 		}
 	}
 }
 
 /* Allocating blocks */
-static struct block* block_malloc(uint16 hash)
+static struct block* block_malloc(struct s_memmgr_arena* arena, uint16 hash)
 {
 	struct block *p;
-	if(hash_unfill[0] != nullptr) {
+	if(arena->hash_unfill[0] != nullptr) {
 		/* Space for the block has already been secured */
-		p = hash_unfill[0];
-		hash_unfill[0] = hash_unfill[0]->unfill_next;
+		p = arena->hash_unfill[0];
+		arena->hash_unfill[0] = arena->hash_unfill[0]->unfill_next;
 	} else {
 		int32 i;
 		/* Newly allocated space for the block */
@@ -459,20 +1026,25 @@ static struct block* block_malloc(uint16 hash)
 			exit(EXIT_FAILURE);
 		}
 
-		if(block_first == nullptr) {
-			/* First ensure */
-			block_first = p;
-		} else {
-			block_last->block_next = p;
+		{
+			std::lock_guard<std::mutex> lock( memmgr_mutex );
+
+			if(block_first == nullptr) {
+				/* First ensure */
+				block_first = p;
+			} else {
+				block_last->block_next = p;
+			}
+			block_last = &p[BLOCK_ALLOC - 1];
+			block_last->block_next = nullptr;
 		}
-		block_last = &p[BLOCK_ALLOC - 1];
-		block_last->block_next = nullptr;
 		/* Linking the block */
 		for(i=0;i<BLOCK_ALLOC;i++) {
+			p[i].arena = arena;
 			if(i != 0) {
 				// I do not add the link p [0], so we will use
-				p[i].unfill_next = hash_unfill[0];
-				hash_unfill[0]   = &p[i];
+				p[i].unfill_next = arena->hash_unfill[0];
+				arena->hash_unfill[0] = &p[i];
 				p[i].unfill_prev = nullptr;
 				p[i].unit_used = 0;
 			}
@@ -483,8 +1055,8 @@ static struct block* block_malloc(uint16 hash)
 	}
 
 	// Add to unfill
-	memmgr_assert(hash_unfill[ hash ] == nullptr);
-	hash_unfill[ hash ] = p;
+	memmgr_assert(arena->hash_unfill[ hash ] == nullptr);
+	arena->hash_unfill[ hash ] = p;
 	p->unfill_prev  = &block_head;
 	p->unfill_next  = nullptr;
 	p->unit_size    = (uint16)(hash2size( hash ) + sizeof(struct unit_head));
@@ -499,11 +1071,11 @@ static struct block* block_malloc(uint16 hash)
 	return p;
 }
 
-static void block_free(struct block* p)
+static void block_free(struct s_memmgr_arena* arena, struct block* p)
 {
 	if( p->unfill_prev ) {
 		if( p->unfill_prev == &block_head) {
-			hash_unfill[ p->unit_hash ] = p->unfill_next;
+			arena->hash_unfill[ p->unit_hash ] = p->unfill_next;
 		} else {
 			p->unfill_prev->unfill_next = p->unfill_next;
 		}
@@ -513,13 +1085,22 @@ static void block_free(struct block* p)
 		p->unfill_prev = nullptr;
 	}
 
-	p->unfill_next = hash_unfill[0];
-	hash_unfill[0] = p;
+	p->unfill_next = arena->hash_unfill[0];
+	arena->hash_unfill[0] = p;
 }
 
 size_t memmgr_usage (void)
 {
-	return memmgr_usage_bytes / 1024;
+	size_t usage = 0;
+
+	std::lock_guard<std::mutex> lock( memmgr_mutex );
+
+	// Memory waiting in remote free lists is still counted
+	for( struct s_memmgr_arena* arena = memmgr_arena_first; arena != nullptr; arena = arena->next ) {
+		usage += arena->usage_bytes.load( std::memory_order_relaxed );
+	}
+
+	return usage / 1024;
 }
 
 #ifdef LOG_MEMMGR
@@ -561,11 +1142,12 @@ static void memmgr_log (char *buf)
 bool memmgr_verify(void* ptr)
 {
 	struct block* block = block_first;
-	struct unit_head_large* large = unit_head_large_first;
 
 	if( ptr == nullptr )
 		return false;// never valid
 
+	std::lock_guard<std::mutex> lock( memmgr_mutex );
+
 	// search small blocks
 	while( block )
 	{
@@ -587,14 +1169,16 @@ bool memmgr_verify(void* ptr)
 	}
 
 	// search large blocks
-	while( large )
+	for( struct s_memmgr_arena* arena = memmgr_arena_first; arena != nullptr; arena = arena->next )
 	{
-		if( (char*)ptr >= (char*)large && (char*)ptr < ((char*)large) + large->size )
-		{// found memory block, check if ptr points to the usable part
-			return ( (char*)ptr >= ((char*)large) + sizeof(struct unit_head_large) - sizeof(long)
-				&& (char*)ptr < ((char*)large) + sizeof(struct unit_head_large) - sizeof(long) + large->size );
+		for( struct unit_head_large* large = arena->large_first; large != nullptr; large = large->next )
+		{
+			if( (char*)ptr >= (char*)large && (char*)ptr < ((char*)large) + large->size )
+			{// found memory block, check if ptr points to the usable part
+				return ( (char*)ptr >= ((char*)large) + sizeof(struct unit_head_large) - sizeof(long)
+					&& (char*)ptr < ((char*)large) + sizeof(struct unit_head_large) - sizeof(long) + large->size );
+			}
 		}
-		large = large->next;
 	}
 	return false;
 }
@@ -602,12 +1186,17 @@ bool memmgr_verify(void* ptr)
 static void memmgr_final (void)
 {
 	struct block *block = block_first;
-	struct unit_head_large *large = unit_head_large_first;
+	struct s_memmgr_arena *arena;
 
 #ifdef LOG_MEMMGR
 	int32 count = 0;
 #endif /* LOG_MEMMGR */
 
+	// All other threads ended, memory they freed is no longer in use
+	for( arena = memmgr_arena_first; arena != nullptr; arena = arena->next ) {
+		memmgr_release_remote( arena );
+	}
+
 	while (block) {
 		if (block->unit_used) {
 			int32 i;
@@ -623,25 +1212,30 @@ static void memmgr_final (void)
 					memmgr_log (buf);
 #endif /* LOG_MEMMGR */
 					// get block pointer and free it [celest]
-					_mfree(ptr, ALC_MARK);
+					memmgr_release_unit(block->arena, head, ALC_MARK);
 				}
 			}
 		}
 		block = block->block_next;
 	}
 
-	while(large) {
-		struct unit_head_large *large2;
+	for( arena = memmgr_arena_first; arena != nullptr; arena = arena->next ) {
+		struct unit_head_large *large = arena->large_first;
+
+		while(large) {
+			struct unit_head_large *large2;
 #ifdef LOG_MEMMGR
-		char buf[1024];
-		sprintf (buf,
-			"%04d : %s line %d size %lu address 0x%p\n", ++count,
-			large->unit_head.file, large->unit_head.line, (unsigned long)large->size, &large->unit_head.checksum);
-		memmgr_log (buf);
+			char buf[1024];
+			sprintf (buf,
+				"%04d : %s line %d size %lu address 0x%p\n", ++count,
+				large->unit_head.file, large->unit_head.line, (unsigned long)large->size, &large->unit_head.checksum);
+			memmgr_log (buf);
 #endif /* LOG_MEMMGR */
-		large2 = large->next;
-		FREE(large,file,line,func);
-		large = large2;
+			large2 = large->next;
+			FREE(large,file,line,func);
+			large = large2;
+		}
+		arena->large_first = nullptr;
 	}
 #ifdef LOG_MEMMGR
 	if(count == 0) {
@@ -658,7 +1252,6 @@ static void memmgr_init (void)
 #ifdef LOG_MEMMGR
 	sprintf(memmer_logfile, "log/%s.leaks", SERVER_NAME);
 	ShowStatus("Memory manager initialised: " CL_WHITE "%s" CL_RESET "\n", memmer_logfile);
-	memset(hash_unfill, 0, sizeof(hash_unfill));
 #endif /* LOG_MEMMGR */
 }
 #endif /* USE_MEMMGR */
@@ -693,11 +1286,75 @@ size_t malloc_usage (void)
 {
 #ifdef USE_MEMMGR
 	return memmgr_usage ();
+#elif defined(MALLOC_BACKEND)
+	return malloc_backend_bytes.load( std::memory_order_relaxed ) / 1024;
 #else
 	return MEMORY_USAGE();
 #endif
 }
 
+/// Displays the call sites with the most memory in use.
+///
+/// @param count Number of call sites to display
+void malloc_report( size_t count )
+{
+#if defined(USE_MEMMGR)
+	const char* allocator = "memory manager";
+#elif defined(MALLOC_BACKEND)
+	const char* allocator = malloc_backend->name;
+#else
+	const char* allocator = "memory library";
+#endif
+
+#ifdef MALLOC_SITE_STATS
+	struct s_malloc_report_site {
+		const s_malloc_site* site;
+		uint64 allocs;
+		int64 count;
+		int64 bytes;
+	};
+
+	// Copied first, the statistics keep changing while they are sorted
+	std::vector<s_malloc_report_site> sites;
+
+	{
+		std::lock_guard<std::mutex> lock( malloc_site_mutex() );
+
+		for( const auto& it : malloc_sites() ){
+			const s_malloc_site* site = it.second;
+
+			sites.push_back( { site, site->allocs.load( std::memory_order_relaxed ), site->count.load( std::memory_order_relaxed ), site->bytes.load( std::memory_order_relaxed ) } );
+		}
+	}
+
+	std::sort( sites.begin(), sites.end(), []( const s_malloc_report_site& a, const s_malloc_report_site& b ){
+		return a.bytes > b.bytes;
+	} );
+
+	ShowInfo( "malloc_report: '" CL_WHITE "%" PRIuPTR " KB" CL_RESET "' in use by '" CL_WHITE "%" PRIuPTR CL_RESET "' call sites (%s)\n", malloc_usage(), sites.size(), allocator );
+#else
+	ShowInfo( "malloc_report: '" CL_WHITE "%" PRIuPTR " KB" CL_RESET "' in use (%s)\n", malloc_usage(), allocator );
+#endif
+#ifdef MALLOC_BACKEND
+	if( malloc_backend == &malloc_backend_sizeclass )
+		ShowInfo( "malloc_report: '" CL_WHITE "%" PRIuPTR " KB" CL_RESET "' of size class slabs\n", sizeclass_slab_bytes.load( std::memory_order_relaxed ) / 1024 );
+#endif
+
+#ifdef MALLOC_SITE_STATS
+	for( size_t i = 0; i < sites.size() && i < count; i++ ){
+		const s_malloc_report_site& report = sites[i];
+
+		if( report.count <= 0 )
+			break;
+
+		ShowInfo( "malloc_report: %8" PRId64 " KB in %7" PRId64 " allocations (%" PRIu64 " total) at %s:%d@%s\n",
+			report.bytes / 1024, report.count, report.allocs, report.site->file, report.site->line, report.site->func );
+	}
+#else
+	ShowInfo( "malloc_report: Call sites are only counted when MALLOC_SITE_STATS is defined in src/common/malloc.hpp.\n" );
+#endif
+}
+
 void malloc_final (void)
 {
 #ifdef USE_MEMMGR
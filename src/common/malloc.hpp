@@ -22,6 +22,14 @@
 #endif
 #endif
 
+// Uncomment to let aMalloc and co. use thread local size class caches instead of the
+// system allocator when the built-in memory manager is disabled
+//#define MALLOC_SIZECLASS
+
+// Uncomment to count the memory in use per call site for malloc_report
+// Every allocation and free then looks up its call site and updates shared counters
+//#define MALLOC_SITE_STATS
+
 
 //////////////////////////////////////////////////////////////////////
 // Athena's built-in Memory Manager
@@ -99,6 +107,23 @@
 
 ////////////////////////////////////////////////
 
+/// Allocator behind aMalloc_ and co. when neither the built-in memory manager nor a memory library is used.
+/// aMalloc_ and co. keep the size in a header in front of each allocation and pass it to every call,
+/// so a backend does not need a header of its own.
+/// All functions can be called from any thread.
+struct s_malloc_backend {
+	const char* name;
+	void* (*alloc)( size_t size );
+	void* (*realloc)( void* p, size_t old_size, size_t size );
+	void (*free)( void* p, size_t size );
+};
+
+extern const s_malloc_backend malloc_backend_system;
+extern const s_malloc_backend malloc_backend_sizeclass;
+
+bool malloc_set_backend( const s_malloc_backend* backend );
+void malloc_report( size_t count );
+
 void malloc_memory_check(void);
 bool malloc_verify_ptr(void* ptr);
 size_t malloc_usage (void);
@@ -3,9 +3,13 @@
 
 #include "timer.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "cbasetypes.hpp"
 #include "db.hpp"
@@ -46,6 +50,20 @@ static int32 free_timer_list_pos = 0;
 // timer heap (binary heap of tid's)
 static BHEAP_VAR(int32, timer_heap);
 
+// batched timers (expiry tick -> tid's), each batch is a single TIMER_BATCH entry in the timer heap
+static std::unordered_map<t_tick, std::vector<int32>> timer_batches;
+// batch whose timers are being run by do_timer, it is no longer in timer_batches
+static std::vector<int32>* timer_batch_running = nullptr;
+static size_t timer_batch_running_pos; // position of the timer that is being run
+
+static struct s_timer_stats {
+	uint64 added; ///< Timers added to the timer heap
+	uint64 batched; ///< Timers that joined an existing batch instead
+	size_t heap_peak; ///< Highest number of entries in the timer heap
+	uint64 runs; ///< Calls of do_timer
+	std::chrono::nanoseconds run_time; ///< Time spent in do_timer
+} timer_stats;
+
 
 // server startup time
 time_t start_time;
@@ -210,6 +228,9 @@ static void push_timer_heap(int32 tid)
 {
 	BHEAP_ENSURE(timer_heap, 1, 256);
 	BHEAP_PUSH(timer_heap, tid, DIFFTICK_MINTOPCMP);
+
+	timer_stats.added++;
+	timer_stats.heap_peak = std::max( timer_stats.heap_peak, BHEAP_LENGTH(timer_heap) );
 }
 
 /*==========================
@@ -290,6 +311,43 @@ int32 add_timer_interval(t_tick tick, TimerFunc func, int32 id, intptr_t data, i
 	return tid;
 }
 
+/// Starts a new single-use timer that shares its timer heap entry with all batched timers of the same tick.
+/// Behaves exactly like add_timer, but many timers that expire together only cost one heap operation.
+/// Returns the timer's id.
+int32 add_timer_batch(t_tick tick, TimerFunc func, int32 id, intptr_t data)
+{
+	int32 tid;
+
+	tid = acquire_timer();
+	timer_data[tid].tick     = tick;
+	timer_data[tid].func     = func;
+	timer_data[tid].id       = id;
+	timer_data[tid].data     = data;
+	timer_data[tid].type     = TIMER_ONCE_AUTODEL;
+	timer_data[tid].interval = 1000;
+
+	std::vector<int32>& batch = timer_batches[tick];
+
+	if( batch.empty() )
+	{// first timer of this tick, the batch itself goes into the heap
+		int32 batch_tid = acquire_timer();
+
+		timer_data[batch_tid].tick     = tick;
+		timer_data[batch_tid].func     = nullptr;
+		timer_data[batch_tid].id       = 0;
+		timer_data[batch_tid].data     = 0;
+		timer_data[batch_tid].type     = TIMER_BATCH;
+		timer_data[batch_tid].interval = 0;
+		push_timer_heap(batch_tid);
+	}
+	else
+		timer_stats.batched++;
+
+	batch.push_back(tid);
+
+	return tid;
+}
+
 /// Retrieves internal timer data
 const struct TimerData* get_timer(int32 tid)
 {
@@ -318,6 +376,38 @@ int32 delete_timer(int32 tid, TimerFunc func)
 	return 0;
 }
 
+/// Removes a timer from the batch of its tick.
+/// Returns true if the timer was batched and has not run yet.
+static bool timer_batch_remove(int32 tid)
+{
+	auto it = timer_batches.find(timer_data[tid].tick);
+
+	if( it != timer_batches.end() )
+	{
+		std::vector<int32>& batch = it->second;
+		auto member = std::find(batch.begin(), batch.end(), tid);
+
+		if( member != batch.end() )
+		{// The batch entry in the heap stays, an empty batch is simply released once it expires
+			batch.erase(member);
+			return true;
+		}
+	}
+
+	if( timer_batch_running != nullptr )
+	{// a timer of the running batch changes a timer of the same batch that is still waiting to be run
+		auto member = std::find(timer_batch_running->begin() + timer_batch_running_pos + 1, timer_batch_running->end(), tid);
+
+		if( member != timer_batch_running->end() )
+		{
+			*member = INVALID_TIMER;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /// Adjusts a timer's expiration time.
 /// Returns the new tick value, or -1 if it fails.
 t_tick addtick_timer(int32 tid, t_tick tick)
@@ -333,6 +423,23 @@ t_tick settick_timer(int32 tid, t_tick tick)
 
 	// search timer position
 	ARR_FIND(0, BHEAP_LENGTH(timer_heap), i, BHEAP_DATA(timer_heap)[i] == tid);
+	if( i == BHEAP_LENGTH(timer_heap) && timer_batch_remove(tid) )
+	{// batched timer, continues as a normal timer
+		if( tick == -1 )
+			tick = 0;
+		timer_data[tid].tick = tick;
+		push_timer_heap(tid);
+		return tick;
+	}
+	if( i == BHEAP_LENGTH(timer_heap) && timer_batch_running != nullptr && (*timer_batch_running)[timer_batch_running_pos] == tid )
+	{// batched timer that is being run, continues as a normal timer instead of being released once it returns
+		if( tick == -1 )
+			tick = 0;
+		timer_data[tid].type &= ~TIMER_REMOVE_HEAP;
+		timer_data[tid].tick = tick;
+		push_timer_heap(tid);
+		return tick;
+	}
 	if( i == BHEAP_LENGTH(timer_heap) )
 	{
 		ShowError("settick_timer: no such timer %d (%p(%s))\n", tid, timer_data[tid].func, search_timer_func_list(timer_data[tid].func));
@@ -352,11 +459,62 @@ t_tick settick_timer(int32 tid, t_tick tick)
 	return tick;
 }
 
+/// Puts a timer back into the free timer list.
+static void release_timer(int32 tid)
+{
+	timer_data[tid].type = 0;
+	if (free_timer_list_pos >= free_timer_list_max) {
+		free_timer_list_max += 256;
+		RECREATE(free_timer_list,int32,free_timer_list_max);
+		memset(free_timer_list + (free_timer_list_max - 256), 0, 256 * sizeof(int32));
+	}
+	free_timer_list[free_timer_list_pos++] = tid;
+}
+
+/// Executes an expired timer that was removed from the timer heap.
+static void run_timer(int32 tid, t_tick tick)
+{
+	t_tick diff = DIFF_TICK(timer_data[tid].tick, tick);
+
+	timer_data[tid].type |= TIMER_REMOVE_HEAP;
+
+	if( timer_data[tid].func )
+	{
+		if( diff < -1000 )
+			// timer was delayed for more than 1 second, use current tick instead
+			timer_data[tid].func(tid, tick, timer_data[tid].id, timer_data[tid].data);
+		else
+			timer_data[tid].func(tid, timer_data[tid].tick, timer_data[tid].id, timer_data[tid].data);
+	}
+
+	// in the case the function didn't change anything...
+	if( timer_data[tid].type & TIMER_REMOVE_HEAP )
+	{
+		timer_data[tid].type &= ~TIMER_REMOVE_HEAP;
+
+		switch( timer_data[tid].type )
+		{
+		default:
+		case TIMER_ONCE_AUTODEL:
+			release_timer(tid);
+		break;
+		case TIMER_INTERVAL:
+			if( DIFF_TICK(timer_data[tid].tick, tick) < -1000 )
+				timer_data[tid].tick = tick + timer_data[tid].interval;
+			else
+				timer_data[tid].tick += timer_data[tid].interval;
+			push_timer_heap(tid);
+		break;
+		}
+	}
+}
+
 /// Executes all expired timers.
 /// Returns the value of the smallest non-expired timer (or 1 second if there aren't any).
 t_tick do_timer(t_tick tick)
 {
 	t_tick diff = TIMER_MAX_INTERVAL; // return value
+	auto start = std::chrono::steady_clock::now();
 
 	// process all timers one by one
 	while( BHEAP_LENGTH(timer_heap) )
@@ -369,48 +527,50 @@ t_tick do_timer(t_tick tick)
 
 		// remove timer
 		BHEAP_POP(timer_heap, DIFFTICK_MINTOPCMP);
-		timer_data[tid].type |= TIMER_REMOVE_HEAP;
 
-		if( timer_data[tid].func )
-		{
-			if( diff < -1000 )
-				// timer was delayed for more than 1 second, use current tick instead
-				timer_data[tid].func(tid, tick, timer_data[tid].id, timer_data[tid].data);
-			else
-				timer_data[tid].func(tid, timer_data[tid].tick, timer_data[tid].id, timer_data[tid].data);
-		}
+		if( timer_data[tid].type == TIMER_BATCH )
+		{// run all timers of the batch, timers added meanwhile for the same tick form a new batch
+			std::vector<int32> batch;
+			auto it = timer_batches.find(timer_data[tid].tick);
 
-		// in the case the function didn't change anything...
-		if( timer_data[tid].type & TIMER_REMOVE_HEAP )
-		{
-			timer_data[tid].type &= ~TIMER_REMOVE_HEAP;
+			if( it != timer_batches.end() )
+			{
+				batch.swap(it->second);
+				timer_batches.erase(it);
+			}
+
+			release_timer(tid);
+
+			// timers of the batch may still be changed by the ones run before them, see settick_timer
+			timer_batch_running = &batch;
 
-			switch( timer_data[tid].type )
+			for( timer_batch_running_pos = 0; timer_batch_running_pos < batch.size(); timer_batch_running_pos++ )
 			{
-			default:
-			case TIMER_ONCE_AUTODEL:
-				timer_data[tid].type = 0;
-				if (free_timer_list_pos >= free_timer_list_max) {
-					free_timer_list_max += 256;
-					RECREATE(free_timer_list,int32,free_timer_list_max);
-					memset(free_timer_list + (free_timer_list_max - 256), 0, 256 * sizeof(int32));
-				}
-				free_timer_list[free_timer_list_pos++] = tid;
-			break;
-			case TIMER_INTERVAL:
-				if( DIFF_TICK(timer_data[tid].tick, tick) < -1000 )
-					timer_data[tid].tick = tick + timer_data[tid].interval;
-				else
-					timer_data[tid].tick += timer_data[tid].interval;
-				push_timer_heap(tid);
-			break;
+				if( batch[timer_batch_running_pos] != INVALID_TIMER )
+					run_timer(batch[timer_batch_running_pos], tick);
 			}
+
+			timer_batch_running = nullptr;
 		}
+		else
+			run_timer(tid, tick);
 	}
 
+	timer_stats.runs++;
+	timer_stats.run_time += std::chrono::steady_clock::now() - start;
+
 	return cap_value(diff, TIMER_MIN_INTERVAL, TIMER_MAX_INTERVAL);
 }
 
+/// Displays statistics of the timer heap and batched timers.
+void timer_report(void)
+{
+	ShowInfo("Timers: " CL_WHITE "%" PRIuPTR CL_RESET " heap entries (peak " CL_WHITE "%" PRIuPTR CL_RESET "), " CL_WHITE "%" PRIuPTR CL_RESET " pending batches.\n", BHEAP_LENGTH(timer_heap), timer_stats.heap_peak, timer_batches.size());
+	ShowInfo("Timers: " CL_WHITE "%" PRIu64 CL_RESET " added to the heap, " CL_WHITE "%" PRIu64 CL_RESET " joined a batch instead, " CL_WHITE "%" PRId64 CL_RESET " ns per do_timer call on average.\n",
+		timer_stats.added, timer_stats.batched,
+		timer_stats.runs > 0 ? static_cast<int64>( timer_stats.run_time.count() / timer_stats.runs ) : 0);
+}
+
 unsigned long get_uptime(void)
 {
 	return (unsigned long)difftime(time(nullptr), start_time);
@@ -536,5 +696,6 @@ void timer_final(void)
 
 	if (timer_data) aFree(timer_data);
 	BHEAP_CLEAR(timer_heap);
+	timer_batches.clear();
 	if (free_timer_list) aFree(free_timer_list);
 }
@@ -27,6 +27,7 @@ const t_tick INFINITE_TICK = -1;
 enum {
 	TIMER_ONCE_AUTODEL = 0x01,
 	TIMER_INTERVAL = 0x02,
+	TIMER_BATCH = 0x04,
 	TIMER_REMOVE_HEAP = 0x10,
 };
 
@@ -53,6 +54,7 @@ t_tick gettick_nocache(void);
 
 int32 add_timer(t_tick tick, TimerFunc func, int32 id, intptr_t data);
 int32 add_timer_interval(t_tick tick, TimerFunc func, int32 id, intptr_t data, int32 interval);
+int32 add_timer_batch(t_tick tick, TimerFunc func, int32 id, intptr_t data);
 const struct TimerData* get_timer(int32 tid);
 int32 delete_timer(int32 tid, TimerFunc func);
 
@@ -69,6 +71,7 @@ void split_time(int32 time, int32* year, int32* month, int32* day, int32* hour,
 double solve_time(char* modif_p);
 
 t_tick do_timer(t_tick tick);
+void timer_report(void);
 void timer_init(void);
 void timer_final(void);
 
@@ -524,7 +524,7 @@ int64 battle_attr_fix(block_list *src, block_list *target, int64 damage,int32 at
 		return damage;
 	}
 
-	ratio = elemental_attribute_db.getAttribute(def_lv, atk_elem, def_type);
+	ratio = elemental_attribute_db.getAttributeUnchecked(def_lv, atk_elem, def_type);
 	if (sc != nullptr && !sc->empty()) { //increase dmg by src status
 		switch(atk_elem){
 			case ELE_FIRE:
@@ -816,7 +816,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 #define APPLY_CARDFIX_RE(damage, fix) { (damage) = (damage) - (int64)(((damage) * (100 - max(0, 100+(fix)))) / 100); }
 				// On (at least) BF_MAGIC, damages are calculated consecutively and rounded down in the following order to match official damage :
 				// size, race2, ele, atk_ele, race, class
-				APPLY_CARDFIX_RE( damage, sd->indexed_bonus.magic_addsize[tstatus->size] + sd->indexed_bonus.magic_addsize[SZ_ALL] );
+				APPLY_CARDFIX_RE( damage, sd->cardfix.magic_addsize[tstatus->size] );
 
 				// race2 is the same as the bonus per class ID
 				for (const auto &raceit : t_race2)
@@ -830,8 +830,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 				APPLY_CARDFIX_RE( damage, race2_val );
 
 				if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-					APPLY_CARDFIX_RE( damage, sd->indexed_bonus.magic_addele[tstatus->def_ele] + sd->indexed_bonus.magic_addele[ELE_ALL] +
-						sd->indexed_bonus.magic_addele_script[tstatus->def_ele] + sd->indexed_bonus.magic_addele_script[ELE_ALL] );
+					APPLY_CARDFIX_RE( damage, sd->cardfix.magic_addele[tstatus->def_ele] );
 				}
 			}
 			// Statuses that affect the target's element and should be calculated right after magic_addele, independently of it
@@ -840,24 +839,23 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 			}
 			if( sd && !nk[NK_IGNOREATKCARD] ) {
 				if( !nk[NK_IGNOREELEMENT] ) {
-					APPLY_CARDFIX_RE( damage, sd->indexed_bonus.magic_atk_ele[rh_ele] + sd->indexed_bonus.magic_atk_ele[ELE_ALL] );
+					APPLY_CARDFIX_RE( damage, sd->cardfix.magic_atk_ele[rh_ele] );
 				}
-				APPLY_CARDFIX_RE( damage, sd->indexed_bonus.magic_addrace[tstatus->race] + sd->indexed_bonus.magic_addrace[RC_ALL] );
-				APPLY_CARDFIX_RE( damage, sd->indexed_bonus.magic_addclass[tstatus->class_] + sd->indexed_bonus.magic_addclass[CLASS_ALL] );
+				APPLY_CARDFIX_RE( damage, sd->cardfix.magic_addrace[tstatus->race] );
+				APPLY_CARDFIX_RE( damage, sd->cardfix.magic_addclass[tstatus->class_] );
 #undef APPLY_CARDFIX_RE
 
 // Pre-renewal / old renewal behaviour
 #else
 				for (const auto &raceit : t_race2)
 					race2_val += sd->indexed_bonus.magic_addrace2[raceit];
-				cardfix = cardfix * (100 + sd->indexed_bonus.magic_addrace[tstatus->race] + sd->indexed_bonus.magic_addrace[RC_ALL] + race2_val) / 100;
+				cardfix = cardfix * (100 + sd->cardfix.magic_addrace[tstatus->race] + race2_val) / 100;
 				if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-					cardfix = cardfix * (100 + sd->indexed_bonus.magic_addele[tstatus->def_ele] + sd->indexed_bonus.magic_addele[ELE_ALL] +
-						sd->indexed_bonus.magic_addele_script[tstatus->def_ele] + sd->indexed_bonus.magic_addele_script[ELE_ALL]) / 100;
-					cardfix = cardfix * (100 + sd->indexed_bonus.magic_atk_ele[rh_ele] + sd->indexed_bonus.magic_atk_ele[ELE_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->cardfix.magic_addele[tstatus->def_ele]) / 100;
+					cardfix = cardfix * (100 + sd->cardfix.magic_atk_ele[rh_ele]) / 100;
 				}
-				cardfix = cardfix * (100 + sd->indexed_bonus.magic_addsize[tstatus->size] + sd->indexed_bonus.magic_addsize[SZ_ALL]) / 100;
-				cardfix = cardfix * (100 + sd->indexed_bonus.magic_addclass[tstatus->class_] + sd->indexed_bonus.magic_addclass[CLASS_ALL]) / 100;
+				cardfix = cardfix * (100 + sd->cardfix.magic_addsize[tstatus->size]) / 100;
+				cardfix = cardfix * (100 + sd->cardfix.magic_addclass[tstatus->class_]) / 100;
 				for (const auto &it : sd->add_mdmg) {
 					if (it.id == t_class) {
 						cardfix = cardfix * (100 + it.val) / 100;
@@ -873,7 +871,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 				cardfix = 1000; // reset var for target
 
 				if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-					int32 ele_fix = tsd->indexed_bonus.subele[rh_ele] + tsd->indexed_bonus.subele[ELE_ALL] + tsd->indexed_bonus.subele_script[rh_ele] + tsd->indexed_bonus.subele_script[ELE_ALL];
+					int32 ele_fix = tsd->cardfix.subele[rh_ele];
 
 					for (const auto &it : tsd->subele2) {
 						if (it.ele != ELE_ALL && it.ele != rh_ele)
@@ -885,7 +883,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 						ele_fix += it.rate;
 					}
 					if (s_defele != ELE_NONE)
-						ele_fix += tsd->indexed_bonus.magic_subdefele[s_defele] + tsd->indexed_bonus.magic_subdefele[ELE_ALL];
+						ele_fix += tsd->cardfix.magic_subdefele[s_defele];
 #ifndef RENEWAL
 					// Custom to follow SC_ debuff renewal behavior
 					if (tsc != nullptr)
@@ -893,15 +891,15 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 #endif
 					cardfix = cardfix * (100 - ele_fix) / 100;
 				}
-				cardfix = cardfix * (100 - tsd->indexed_bonus.subsize[sstatus->size] - tsd->indexed_bonus.subsize[SZ_ALL]) / 100;
-				cardfix = cardfix * (100 - tsd->indexed_bonus.magic_subsize[sstatus->size] - tsd->indexed_bonus.magic_subsize[SZ_ALL]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.subsize[sstatus->size]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.magic_subsize[sstatus->size]) / 100;
 
 				int32 race_fix = 0;
 
 				for (const auto &raceit : s_race2)
 					race_fix += tsd->indexed_bonus.subrace2[raceit];
 				cardfix = cardfix * (100 - race_fix) / 100;
-				race_fix = tsd->indexed_bonus.subrace[sstatus->race] + tsd->indexed_bonus.subrace[RC_ALL];
+				race_fix = tsd->cardfix.subrace[sstatus->race];
 				for (const auto &it : tsd->subrace3) {
 					if (it.race != RC_ALL && it.race != sstatus->race)
 						continue;
@@ -912,7 +910,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 					race_fix += it.rate;
 				}
 				cardfix = cardfix * (100 - race_fix) / 100;
-				cardfix = cardfix * (100 - tsd->indexed_bonus.subclass[sstatus->class_] - tsd->indexed_bonus.subclass[CLASS_ALL]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.subclass[sstatus->class_]) / 100;
 
 				for (const auto &it : tsd->add_mdef) {
 					if (it.id == s_class) {
@@ -941,11 +939,9 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 				int16 cardfix_ = 1000;
 
 				if( sd->state.arrow_atk ) { // Ranged attack
-					cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->indexed_bonus.arrow_addrace[tstatus->race] +
-						sd->right_weapon.addrace[RC_ALL] + sd->indexed_bonus.arrow_addrace[RC_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->cardfix.addrace[CARDFIX_ARROW][tstatus->race]) / 100;
 					if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-						int32 ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->indexed_bonus.arrow_addele[tstatus->def_ele] +
-							sd->right_weapon.addele[ELE_ALL] + sd->indexed_bonus.arrow_addele[ELE_ALL];
+						int32 ele_fix = sd->cardfix.addele[CARDFIX_ARROW][tstatus->def_ele];
 
 						for (const auto &it : sd->right_weapon.addele2) {
 							if (it.ele != ELE_ALL && it.ele != tstatus->def_ele)
@@ -958,25 +954,23 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 						}
 						cardfix = cardfix * (100 + ele_fix) / 100;
 					}
-					cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->indexed_bonus.arrow_addsize[tstatus->size] +
-						sd->right_weapon.addsize[SZ_ALL] + sd->indexed_bonus.arrow_addsize[SZ_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->cardfix.addsize[CARDFIX_ARROW][tstatus->size]) / 100;
 
 					int32 race_fix = 0;
 
 					for (const auto &raceit : t_race2)
 						race_fix += sd->right_weapon.addrace2[raceit];
 					cardfix = cardfix * (100 + race_fix) / 100;
-					cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->indexed_bonus.arrow_addclass[tstatus->class_] +
-						sd->right_weapon.addclass[CLASS_ALL] + sd->indexed_bonus.arrow_addclass[CLASS_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->cardfix.addclass[CARDFIX_ARROW][tstatus->class_]) / 100;
 				} else { // Melee attack
 					int32 skill = 0;
 
 					// Calculates each right & left hand weapon bonuses separatedly
 					if( !battle_config.left_cardfix_to_right ) {
 						// Right-handed weapon
-						cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->right_weapon.addrace[RC_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->cardfix.addrace[CARDFIX_RIGHT][tstatus->race]) / 100;
 						if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-							int32 ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->right_weapon.addele[ELE_ALL];
+							int32 ele_fix = sd->cardfix.addele[CARDFIX_RIGHT][tstatus->def_ele];
 
 							for (const auto &it : sd->right_weapon.addele2) {
 								if (it.ele != ELE_ALL && it.ele != tstatus->def_ele)
@@ -989,15 +983,15 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 							}
 							cardfix = cardfix * (100 + ele_fix) / 100;
 						}
-						cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->right_weapon.addsize[SZ_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->cardfix.addsize[CARDFIX_RIGHT][tstatus->size]) / 100;
 						for (const auto &raceit : t_race2)
 							cardfix = cardfix * (100 + sd->right_weapon.addrace2[raceit]) / 100;
-						cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->right_weapon.addclass[CLASS_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->cardfix.addclass[CARDFIX_RIGHT][tstatus->class_]) / 100;
 
 						if( left&1 ) { // Left-handed weapon
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addrace[tstatus->race] + sd->left_weapon.addrace[RC_ALL]) / 100;
+							cardfix_ = cardfix_ * (100 + sd->cardfix.addrace[CARDFIX_LEFT][tstatus->race]) / 100;
 							if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-								int32 ele_fix_lh = sd->left_weapon.addele[tstatus->def_ele] + sd->left_weapon.addele[ELE_ALL];
+								int32 ele_fix_lh = sd->cardfix.addele[CARDFIX_LEFT][tstatus->def_ele];
 
 								for (const auto &it : sd->left_weapon.addele2) {
 									if (it.ele != ELE_ALL && it.ele != tstatus->def_ele)
@@ -1010,18 +1004,17 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 								}
 								cardfix_ = cardfix_ * (100 + ele_fix_lh) / 100;
 							}
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addsize[tstatus->size] + sd->left_weapon.addsize[SZ_ALL]) / 100;
+							cardfix_ = cardfix_ * (100 + sd->cardfix.addsize[CARDFIX_LEFT][tstatus->size]) / 100;
 							for (const auto &raceit : t_race2)
 								cardfix_ = cardfix_ * (100 + sd->left_weapon.addrace2[raceit]) / 100;
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addclass[tstatus->class_] + sd->left_weapon.addclass[CLASS_ALL]) / 100;
+							cardfix_ = cardfix_ * (100 + sd->cardfix.addclass[CARDFIX_LEFT][tstatus->class_]) / 100;
 						}
 					}
 					// Calculates right & left hand weapon as unity
 					else {
 						//! CHECKME: If 'left_cardfix_to_right' is yes, doesn't need to check NK_IGNOREELEMENT?
 						//if( !nk[&]K_IGNOREELEMENT) ) { // Affected by Element modifier bonuses
-							int32 ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->left_weapon.addele[tstatus->def_ele]
-										+ sd->right_weapon.addele[ELE_ALL] + sd->left_weapon.addele[ELE_ALL];
+							int32 ele_fix = sd->cardfix.addele[CARDFIX_RIGHT][tstatus->def_ele] + sd->cardfix.addele[CARDFIX_LEFT][tstatus->def_ele];
 
 							for (const auto &it : sd->right_weapon.addele2) {
 								if (it.ele != ELE_ALL && it.ele != tstatus->def_ele)
@@ -1043,14 +1036,11 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 							}
 							cardfix = cardfix * (100 + ele_fix) / 100;
 						//}
-						cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->left_weapon.addrace[tstatus->race] +
-							sd->right_weapon.addrace[RC_ALL] + sd->left_weapon.addrace[RC_ALL]) / 100;
-						cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->left_weapon.addsize[tstatus->size] +
-							sd->right_weapon.addsize[SZ_ALL] + sd->left_weapon.addsize[SZ_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->cardfix.addrace[CARDFIX_RIGHT][tstatus->race] + sd->cardfix.addrace[CARDFIX_LEFT][tstatus->race]) / 100;
+						cardfix = cardfix * (100 + sd->cardfix.addsize[CARDFIX_RIGHT][tstatus->size] + sd->cardfix.addsize[CARDFIX_LEFT][tstatus->size]) / 100;
 						for (const auto &raceit : t_race2)
 							cardfix = cardfix * (100 + sd->right_weapon.addrace2[raceit] + sd->left_weapon.addrace2[raceit]) / 100;
-						cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->left_weapon.addclass[tstatus->class_] +
-							sd->right_weapon.addclass[CLASS_ALL] + sd->left_weapon.addclass[CLASS_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->cardfix.addclass[CARDFIX_RIGHT][tstatus->class_] + sd->cardfix.addclass[CARDFIX_LEFT][tstatus->class_]) / 100;
 					}
 #ifndef RENEWAL
 					if( sd->status.weapon == W_KATAR && (skill = pc_checkskill(sd,ASC_KATAR)) > 0 ) // Adv. Katar Mastery functions similar to a +%ATK card on official [helvetica]
@@ -1088,7 +1078,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 			// Affected by target DEF bonuses
 			else if( tsd && !nk[NK_IGNOREDEFCARD] && !(left&2) ) {
 				if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-					int32 ele_fix = tsd->indexed_bonus.subele[rh_ele] + tsd->indexed_bonus.subele[ELE_ALL] + tsd->indexed_bonus.subele_script[rh_ele] + tsd->indexed_bonus.subele_script[ELE_ALL];
+					int32 ele_fix = tsd->cardfix.subele[rh_ele];
 
 					for (const auto &it : tsd->subele2) {
 						if (it.ele != ELE_ALL && it.ele != rh_ele)
@@ -1102,7 +1092,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 					cardfix = cardfix * (100 - ele_fix) / 100;
 
 					if( left&1 && lh_ele != rh_ele ) {
-						int32 ele_fix_lh = tsd->indexed_bonus.subele[lh_ele] + tsd->indexed_bonus.subele[ELE_ALL] + tsd->indexed_bonus.subele_script[lh_ele] + tsd->indexed_bonus.subele_script[ELE_ALL];
+						int32 ele_fix_lh = tsd->cardfix.subele[lh_ele];
 
 						for (const auto &it : tsd->subele2) {
 							if (it.ele != ELE_ALL && it.ele != lh_ele)
@@ -1116,17 +1106,17 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 						cardfix = cardfix * (100 - ele_fix_lh) / 100;
 					}
 
-					cardfix = cardfix * (100 - tsd->indexed_bonus.subdefele[s_defele] - tsd->indexed_bonus.subdefele[ELE_ALL]) / 100;
+					cardfix = cardfix * (100 - tsd->cardfix.subdefele[s_defele]) / 100;
 				}
 
 				int32 race_fix = 0;
 
-				cardfix = cardfix * (100 - tsd->indexed_bonus.subsize[sstatus->size] - tsd->indexed_bonus.subsize[SZ_ALL]) / 100;
-				cardfix = cardfix * (100 - tsd->indexed_bonus.weapon_subsize[sstatus->size] - tsd->indexed_bonus.weapon_subsize[SZ_ALL]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.subsize[sstatus->size]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.weapon_subsize[sstatus->size]) / 100;
 				for (const auto &raceit : s_race2)
 					race_fix += tsd->indexed_bonus.subrace2[raceit];
 				cardfix = cardfix * (100 - race_fix) / 100;
-				race_fix = tsd->indexed_bonus.subrace[sstatus->race] + tsd->indexed_bonus.subrace[RC_ALL];
+				race_fix = tsd->cardfix.subrace[sstatus->race];
 				for (const auto &it : tsd->subrace3) {
 					if (it.race != RC_ALL && it.race != sstatus->race)
 						continue;
@@ -1137,7 +1127,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 					race_fix += it.rate;
 				}
 				cardfix = cardfix * (100 - race_fix) / 100;
-				cardfix = cardfix * (100 - tsd->indexed_bonus.subclass[sstatus->class_] - tsd->indexed_bonus.subclass[CLASS_ALL]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.subclass[sstatus->class_]) / 100;
 				for (const auto &it : tsd->add_def) {
 					if (it.id == s_class) {
 						cardfix = cardfix * (100 - it.val) / 100;
@@ -1164,7 +1154,7 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 			// Affected by target DEF bonuses
 			if( tsd && !nk[NK_IGNOREDEFCARD] ) {
 				if( !nk[NK_IGNOREELEMENT] ) { // Affected by Element modifier bonuses
-					int32 ele_fix = tsd->indexed_bonus.subele[rh_ele] + tsd->indexed_bonus.subele[ELE_ALL] + tsd->indexed_bonus.subele_script[rh_ele] + tsd->indexed_bonus.subele_script[ELE_ALL];
+					int32 ele_fix = tsd->cardfix.subele[rh_ele];
 
 					for (const auto &it : tsd->subele2) {
 						if (it.ele != rh_ele)
@@ -1176,10 +1166,10 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 						ele_fix += it.rate;
 					}
 					if (s_defele != ELE_NONE)
-						ele_fix += tsd->indexed_bonus.subdefele[s_defele] + tsd->indexed_bonus.subdefele[ELE_ALL];
+						ele_fix += tsd->cardfix.subdefele[s_defele];
 					cardfix = cardfix * (100 - ele_fix) / 100;
 				}
-				int32 race_fix = tsd->indexed_bonus.subrace[sstatus->race] + tsd->indexed_bonus.subrace[RC_ALL];
+				int32 race_fix = tsd->cardfix.subrace[sstatus->race];
 				for (const auto &it : tsd->subrace3) {
 					if (it.race != RC_ALL && it.race != sstatus->race)
 						continue;
@@ -1190,12 +1180,12 @@ int32 battle_calc_cardfix(int32 attack_type, block_list *src, block_list *target
 					race_fix += it.rate;
 				}
 				cardfix = cardfix * (100 - race_fix) / 100;
-				cardfix = cardfix * (100 - tsd->indexed_bonus.subsize[sstatus->size] - tsd->indexed_bonus.subsize[SZ_ALL]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.subsize[sstatus->size]) / 100;
 				race_fix = 0;
 				for (const auto &raceit : s_race2)
 					race_fix += tsd->indexed_bonus.subrace2[raceit];
 				cardfix = cardfix * (100 - race_fix) / 100;
-				cardfix = cardfix * (100 - tsd->indexed_bonus.subclass[sstatus->class_] - tsd->indexed_bonus.subclass[CLASS_ALL]) / 100;
+				cardfix = cardfix * (100 - tsd->cardfix.subclass[sstatus->class_]) / 100;
 				cardfix = cardfix * (100 - tsd->bonus.misc_def_rate) / 100;
 				if( flag&BF_SHORT )
 					cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
@@ -7796,8 +7786,11 @@ void battle_do_reflect(int32 attack_type, struct Damage *wd, block_list* src, bl
  *	Original coder Skotlex
  *	Initial refactoring by Baalberith
  *	Refined and optimized by helvetica
+ *
+ * is_skill: false for normal attacks (skill_id 0), the skill only stages are then left out at compile time
  */
-static struct Damage battle_calc_weapon_attack(block_list *src, block_list *target, uint16 skill_id, uint16 skill_lv, int32 wflag)
+template <bool is_skill>
+static struct Damage battle_calc_weapon_attack_sub(block_list *src, block_list *target, uint16 skill_id, uint16 skill_lv, int32 wflag)
 {
 	map_session_data *sd, *tsd;
 	struct Damage wd;
@@ -7808,6 +7801,10 @@ static struct Damage battle_calc_weapon_attack(block_list *src, block_list *targ
 	int32 right_element, left_element;
 	bool infdef = false;
 
+	// Known to be 0 at compile time, every check and switch on the skill below folds to the normal attack case
+	if constexpr (!is_skill)
+		skill_id = 0;
+
 	memset(&wd,0,sizeof(wd));
 
 	if (src == nullptr || target == nullptr) {
@@ -7873,7 +7870,8 @@ static struct Damage battle_calc_weapon_attack(block_list *src, block_list *targ
 		ATK_RATE(wd.damage, wd.damage2, battle_calc_attack_skill_ratio(&wd, src, target, skill_id, skill_lv));
 
 		// Additive damage bonus
-		ATK_ADD(wd.damage, wd.damage2, battle_calc_skill_constant_addition(&wd, src, target, skill_id, skill_lv));
+		if constexpr (is_skill)
+			ATK_ADD(wd.damage, wd.damage2, battle_calc_skill_constant_addition(&wd, src, target, skill_id, skill_lv));
 #endif
 
 #ifdef RENEWAL
@@ -7961,7 +7959,7 @@ static struct Damage battle_calc_weapon_attack(block_list *src, block_list *targ
 						wd.damage2 += (int64)floor((float)(wd.damage2 * sd->bonus.crit_atk_rate / 100));
 				}
 			}
-			else if (std::shared_ptr<s_skill_db> skill_tmp = skill_db.find(skill_id); skill_tmp == nullptr || !skill_tmp->inf2[INF2_IGNORENONCRITATKBONUS]) {
+			else if (std::shared_ptr<s_skill_db> skill_tmp = is_skill ? skill_db.find(skill_id) : nullptr; skill_tmp == nullptr || !skill_tmp->inf2[INF2_IGNORENONCRITATKBONUS]) {
 				ATK_ADDRATE(wd.damage, wd.damage2, sd->bonus.non_crit_atk_rate);
 			}
 
@@ -7975,7 +7973,8 @@ static struct Damage battle_calc_weapon_attack(block_list *src, block_list *targ
 		ATK_RATE(wd.damage, wd.damage2, battle_calc_attack_skill_ratio(&wd, src, target, skill_id, skill_lv));
 
 		// Additive damage bonus
-		ATK_ADD(wd.damage, wd.damage2, battle_calc_skill_constant_addition(&wd, src, target, skill_id, skill_lv));
+		if constexpr (is_skill)
+			ATK_ADD(wd.damage, wd.damage2, battle_calc_skill_constant_addition(&wd, src, target, skill_id, skill_lv));
 
 		// Advance Katar Mastery
 		if (sd) {
@@ -8199,6 +8198,24 @@ static struct Damage battle_calc_weapon_attack(block_list *src, block_list *targ
 	return wd;
 }
 
+/**
+ * Calculate "weapon"-type attacks and skills
+ * Normal attacks use a specialization without the skill only stages
+ * @param src: Attacker
+ * @param target: Target
+ * @param skill_id: Skill ID or 0 for a normal attack
+ * @param skill_lv: Skill level
+ * @param wflag: Miscellaneous flags
+ * @return Damage
+ */
+static struct Damage battle_calc_weapon_attack(block_list *src, block_list *target, uint16 skill_id, uint16 skill_lv, int32 wflag)
+{
+	if (skill_id == 0)
+		return battle_calc_weapon_attack_sub<false>(src, target, skill_id, skill_lv, wflag);
+	else
+		return battle_calc_weapon_attack_sub<true>(src, target, skill_id, skill_lv, wflag);
+}
+
 /*==========================================
  * Calculate "magic"-type attacks and skills
  *------------------------------------------
@@ -12393,6 +12410,7 @@ static const struct _battle_data {
 	{ "trade_count_stackable",              &battle_config.trade_count_stackable,           1,      0,      1,              },
 	{ "enable_bonus_map_drops",             &battle_config.enable_bonus_map_drops,          1,      0,      1,              },
 	{ "hide_cloaked_units",                 &battle_config.hide_cloaked_units,              0,      0,      BL_ALL,         },
+	{ "status_calc_layer_cache",            &battle_config.status_calc_layer_cache,         0,      0,      1,              },
 
 #include <custom/battle_config_init.inc>
 };
@@ -0,0 +1,645 @@
+// Copyright (c) rAthena Dev Teams - Licensed under GNU GPL
+// For more information, see LICENCE in the main folder
+
+#include <config/core.hpp>
+
+#ifdef MAP_GENERATOR
+
+#include "battle_simulation.hpp"
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+#include <common/malloc.hpp>
+#include <common/mapindex.hpp>
+#include <common/random.hpp>
+#include <common/showmsg.hpp>
+#include <common/timer.hpp>
+
+#include "battle.hpp"
+#include "itemdb.hpp"
+#include "map.hpp"
+#include "mob.hpp"
+#include "npc.hpp"
+#include "path.hpp"
+#include "pc.hpp"
+#include "script.hpp"
+#include "skill.hpp"
+#include "status.hpp"
+#include "unit.hpp"
+
+/// Equipped item of a simulated player
+struct s_battle_simulation_item {
+	t_itemid nameid;
+	uint8 refine;
+	std::vector<t_itemid> cards;
+};
+
+/// Simulated player
+struct s_battle_simulation_pc {
+	uint16 job;
+	uint32 base_level;
+	uint32 job_level;
+	uint16 str, agi, vit, int_, dex, luk;
+	std::vector<s_battle_simulation_item> equipment;
+	std::vector<std::pair<uint16, uint16>> skills; ///< Learned skills: skill ID, level
+	std::vector<std::pair<sc_type, int32>> buffs; ///< Active status changes: type, val1
+};
+
+/// Attacks repeated by a scenario, the player and the monster only exist for the scenario
+struct s_battle_simulation_scenario {
+	const char* name;
+	s_battle_simulation_pc pc;
+	uint16 mob_id;
+	bool mob_attacks; ///< The monster attacks the player instead of the other way round
+	int32 attack_type; ///< BF_WEAPON or BF_MAGIC
+	uint16 skill_id;
+	uint16 skill_lv;
+};
+
+// Only items and monsters that exist in both the renewal and the pre-renewal databases
+static const std::vector<s_battle_simulation_scenario> battle_simulation_scenarios = {
+	{ "Knight normal attack", {
+			JOB_KNIGHT, 99, 50, 90, 70, 50, 1, 40, 30,
+			{ { 1101, 7, { 4035, 4035, 4092 } }, { 2301, 0, {} } }, // Sword [Hydra, Hydra, Skel Worker], Cotton Shirt
+			{ { SM_SWORD, 10 } },
+			{ { SC_BLESSING, 10 }, { SC_INCREASEAGI, 10 }, { SC_IMPOSITIO, 5 } }
+		}, 1023, false, BF_WEAPON, 0, 0 }, // Orc Warrior
+	{ "Knight Bash", {
+			JOB_KNIGHT, 99, 50, 90, 70, 50, 1, 40, 30,
+			{ { 1101, 7, { 4035, 4035, 4092 } }, { 2301, 0, {} } },
+			{ { SM_SWORD, 10 }, { SM_BASH, 10 } },
+			{ { SC_BLESSING, 10 }, { SC_INCREASEAGI, 10 }, { SC_IMPOSITIO, 5 } }
+		}, 1023, false, BF_WEAPON, SM_BASH, 10 },
+	{ "Hunter bow attack", {
+			JOB_HUNTER, 99, 50, 30, 80, 30, 1, 99, 40,
+			{ { 1702, 4, {} }, { 1750, 0, {} } }, // Bow, Arrow
+			{ { AC_OWL, 10 } },
+			{ { SC_BLESSING, 10 } }
+		}, 1002, false, BF_WEAPON, 0, 0 }, // Poring
+	{ "Wizard Fire Bolt", {
+			JOB_WIZARD, 99, 50, 1, 60, 30, 99, 80, 20,
+			{ { 1601, 5, {} } }, // Rod
+			{ { MG_FIREBOLT, 10 } },
+			{ { SC_BLESSING, 10 } }
+		}, 1039, false, BF_MAGIC, MG_FIREBOLT, 10 }, // Baphomet
+	{ "Orc Warrior against Knight", {
+			JOB_KNIGHT, 99, 50, 90, 70, 50, 1, 40, 30,
+			{ { 1101, 7, {} }, { 2301, 0, { 4058 } } }, // Sword, Cotton Shirt [Thara Frog]
+			{},
+			{}
+		}, 1023, true, BF_WEAPON, 0, 0 },
+};
+
+/**
+ * Frees a player created by battle_simulation_create_pc
+ * @param sd: Player
+ */
+static void battle_simulation_free_pc( map_session_data* sd ){
+	status_change_clear( sd, 1 );
+	map_deliddb( sd );
+	sd->regs.vars->destroy( sd->regs.vars, script_reg_destroy );
+	sd->~map_session_data();
+	aFree( sd );
+}
+
+/**
+ * Creates a player for a scenario, the player is neither on a map nor connected
+ * @param pc: Player setup
+ * @param m: Map ID
+ * @param index: Added to the account and character ID, players that exist at the same time need different ones
+ * @return Player or nullptr if an item does not exist
+ */
+static map_session_data* battle_simulation_create_pc( const s_battle_simulation_pc& pc, int16 m, int32 index = 0 ){
+	map_session_data* sd;
+
+	CREATE( sd, map_session_data, 1 );
+	new(sd) map_session_data();
+
+	sd->id = START_ACCOUNT_NUM + index;
+	sd->status.account_id = START_ACCOUNT_NUM + index;
+	sd->status.char_id = START_CHAR_NUM + index;
+	sd->type = BL_PC;
+	sd->m = m;
+	sd->x = 150;
+	sd->y = 150;
+	sd->status.class_ = pc.job;
+	sd->class_ = pc_jobid2mapid( pc.job );
+	sd->status.base_level = pc.base_level;
+	sd->status.job_level = pc.job_level;
+	sd->status.str = pc.str;
+	sd->status.agi = pc.agi;
+	sd->status.vit = pc.vit;
+	sd->status.int_ = pc.int_;
+	sd->status.dex = pc.dex;
+	sd->status.luk = pc.luk;
+	sd->battle_status.speed = sd->base_status.speed = DEFAULT_WALK_SPEED;
+
+	for( int32 i = 0; i < EQI_MAX; i++ ){
+		sd->equip_index[i] = -1;
+		sd->equip_switch_index[i] = -1;
+	}
+
+	// Item scripts find the player by its ID and may read its variables
+	sd->regs.vars = i64db_alloc( DB_OPT_BASE );
+	sd->vars_ok = true;
+
+	// Same as pc_authok, timers are only deleted when they are valid
+	sd->followtimer = INVALID_TIMER;
+	sd->invincible_timer = INVALID_TIMER;
+	sd->npc_timer_id = INVALID_TIMER;
+	sd->pvp_timer = INVALID_TIMER;
+	sd->expiration_tid = INVALID_TIMER;
+	sd->autotrade_tid = INVALID_TIMER;
+	sd->respawn_tid = INVALID_TIMER;
+	sd->tid_queue_active = INVALID_TIMER;
+	sd->macro_detect.timer = INVALID_TIMER;
+	sd->skill_keep_using.tid = INVALID_TIMER;
+	sd->rental_timer = INVALID_TIMER;
+#ifdef SECURE_NPCTIMEOUT
+	sd->npc_idle_timer = INVALID_TIMER;
+#endif
+
+	for( int32 i = 0; i < MAX_SPIRITBALL; i++ ){
+		sd->spirit_timer[i] = INVALID_TIMER;
+	}
+
+	for( int32 i = 0; i < MAX_EVENTTIMER; i++ ){
+		sd->eventtimer[i] = INVALID_TIMER;
+	}
+
+	unit_dataset( sd );
+	map_addiddb( sd );
+
+	for( const auto& skill : pc.skills ){
+		int16 idx = skill_get_index( skill.first );
+
+		if( idx < 0 )
+			continue;
+
+		sd->status.skill[idx].id = skill.first;
+		sd->status.skill[idx].lv = skill.second;
+		sd->status.skill[idx].flag = SKILL_FLAG_PERMANENT;
+	}
+
+	for( size_t i = 0; i < pc.equipment.size() && i < MAX_INVENTORY; i++ ){
+		const s_battle_simulation_item& equip = pc.equipment[i];
+		std::shared_ptr<item_data> id = item_db.find( equip.nameid );
+
+		if( id == nullptr ){
+			ShowError( "battle_simulation_create_pc: Unknown item %u.\n", equip.nameid );
+			battle_simulation_free_pc( sd );
+			return nullptr;
+		}
+
+		item& it = sd->inventory.u.items_inventory[i];
+
+		it.nameid = equip.nameid;
+		it.amount = 1;
+		it.identify = 1;
+		it.equip = id->equip;
+		it.refine = equip.refine;
+
+		for( size_t slot = 0; slot < equip.cards.size() && slot < MAX_SLOTS; slot++ ){
+			it.card[slot] = equip.cards[slot];
+		}
+	}
+
+	pc_setinventorydata( *sd );
+	pc_setequipindex( sd );
+	// SCO_FIRST would run the login only parts of the calculation, except for this one
+	sd->regen.sregen = &sd->sregen;
+	sd->regen.ssregen = &sd->ssregen;
+	status_calc_pc( sd, SCO_FORCE );
+
+	sd->battle_status.hp = sd->battle_status.max_hp;
+	sd->battle_status.sp = sd->battle_status.max_sp;
+
+	for( const auto& buff : pc.buffs ){
+		sc_start( sd, sd, buff.first, 100, buff.second, INFINITE_TICK );
+	}
+
+	return sd;
+}
+
+/**
+ * Adds a damage result to a FNV-1a checksum
+ * @param checksum: Checksum to update
+ * @param value: Value to add
+ */
+static void battle_simulation_checksum( uint64& checksum, int64 value ){
+	for( int32 i = 0; i < 8; i++ ){
+		checksum ^= static_cast<uint64>( value >> ( i * 8 ) ) & 0xFF;
+		checksum *= 0x100000001B3ULL;
+	}
+}
+
+/**
+ * Runs a scenario with a freshly seeded random number generator
+ * @param scenario: Scenario to run
+ * @param m: Map ID
+ * @param checksum: Checksum of all scenarios, updated with the results
+ * @return true on success
+ */
+static bool battle_simulation_run_scenario( const s_battle_simulation_scenario& scenario, int16 m, uint64& checksum ){
+	map_session_data* sd = battle_simulation_create_pc( scenario.pc, m );
+
+	if( sd == nullptr )
+		return false;
+
+	mob_data* md = mob_once_spawn_sub( nullptr, m, 151, 150, "--ja--", scenario.mob_id, "", SZ_SMALL, AI_NONE );
+
+	if( md == nullptr ){
+		ShowError( "battle_simulation_run_scenario: Unknown monster %hu in scenario '%s'.\n", scenario.mob_id, scenario.name );
+		battle_simulation_free_pc( sd );
+		return false;
+	}
+
+	status_calc_mob( md, SCO_FIRST );
+
+	block_list* src = scenario.mob_attacks ? static_cast<block_list*>( md ) : sd;
+	block_list* target = scenario.mob_attacks ? static_cast<block_list*>( sd ) : md;
+	uint64 scenario_checksum = 0xCBF29CE484222325ULL;
+
+	generator.seed( BATTLE_SIMULATION_SEED );
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for( int32 i = 0; i < BATTLE_SIMULATION_ITERATIONS; i++ ){
+		Damage dmg = battle_calc_attack( scenario.attack_type, src, target, scenario.skill_id, scenario.skill_lv, 0 );
+
+		battle_simulation_checksum( scenario_checksum, dmg.damage );
+		battle_simulation_checksum( scenario_checksum, dmg.damage2 );
+		battle_simulation_checksum( scenario_checksum, dmg.type );
+		battle_simulation_checksum( scenario_checksum, dmg.dmg_lv );
+		battle_simulation_checksum( scenario_checksum, dmg.div_ );
+	}
+
+	std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+	uint64 rate = static_cast<uint64>( BATTLE_SIMULATION_ITERATIONS * 1000000000.0 / std::max<int64>( time.count(), 1 ) );
+
+	ShowInfo( "Battle simulation '" CL_WHITE "%s" CL_RESET "': " CL_WHITE "%" PRIu64 CL_RESET " calculations/s, checksum " CL_WHITE "%016" PRIx64 CL_RESET ".\n", scenario.name, rate, scenario_checksum );
+
+	battle_simulation_checksum( checksum, static_cast<int64>( scenario_checksum ) );
+
+	unit_free( md, CLR_OUTSIGHT );
+	battle_simulation_free_pc( sd );
+
+	return true;
+}
+
+/**
+ * Starts and ends a status change on the player of the first scenario, with and without
+ * reusing the equipment layer (status_calc_layer_cache)
+ * Both checksums have to match, the battle status must not depend on the cache.
+ * @param m: Map ID
+ */
+static void battle_simulation_run_status( int16 m ){
+	int32 layer_cache = battle_config.status_calc_layer_cache;
+
+	for( int32 cache = 0; cache < 2; cache++ ){
+		battle_config.status_calc_layer_cache = cache;
+
+		map_session_data* sd = battle_simulation_create_pc( battle_simulation_scenarios.front().pc, m );
+
+		if( sd == nullptr )
+			break;
+
+		uint64 scenario_checksum = 0xCBF29CE484222325ULL;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for( int32 i = 0; i < BATTLE_SIMULATION_STATUS_ITERATIONS; i++ ){
+			sc_start( sd, sd, SC_ATKPOTION, 100, 5 + i % 10, INFINITE_TICK );
+
+			battle_simulation_checksum( scenario_checksum, sd->battle_status.batk );
+			battle_simulation_checksum( scenario_checksum, sd->battle_status.rhw.atk );
+			battle_simulation_checksum( scenario_checksum, sd->battle_status.max_hp );
+			battle_simulation_checksum( scenario_checksum, sd->battle_status.hit );
+			battle_simulation_checksum( scenario_checksum, sd->battle_status.flee );
+			battle_simulation_checksum( scenario_checksum, sd->battle_status.amotion );
+
+			status_change_end( sd, SC_ATKPOTION );
+		}
+
+		std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+		uint64 rate = static_cast<uint64>( BATTLE_SIMULATION_STATUS_ITERATIONS * 1000000000.0 / std::max<int64>( time.count(), 1 ) );
+
+		ShowInfo( "Battle simulation 'Status change %s layer cache': " CL_WHITE "%" PRIu64 CL_RESET " status changes/s, checksum " CL_WHITE "%016" PRIx64 CL_RESET ".\n", cache ? "with" : "without", rate, scenario_checksum );
+
+		battle_simulation_free_pc( sd );
+	}
+
+	battle_config.status_calc_layer_cache = layer_cache;
+}
+
+/**
+ * Finds a random walkable cell around a position
+ * @param m: Map ID
+ * @param x: Center, filled with the cell
+ * @param y: Center, filled with the cell
+ * @param range: Maximum distance from the center
+ * @return true if a cell was found
+ */
+static bool battle_simulation_cell( int16 m, int16& x, int16& y, int16 range ){
+	for( int32 i = 0; i < 1000; i++ ){
+		int16 cx = x + rnd_value<int16>( -range, range );
+		int16 cy = y + rnd_value<int16>( -range, range );
+
+		if( map_getcell( m, cx, cy, CELL_CHKPASS ) ){
+			x = cx;
+			y = cy;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Spawns monsters on random walkable cells around a position
+ * @param m: Map ID
+ * @param mob_id: Monster to spawn
+ * @param count: Number of monsters
+ * @param x: Center
+ * @param y: Center
+ * @param range: Maximum distance from the center
+ * @param monsters: Filled with the monsters
+ */
+static void battle_simulation_spawn_mobs( int16 m, uint16 mob_id, int32 count, int16 x, int16 y, int16 range, std::vector<mob_data*>& monsters ){
+	for( int32 i = 0; i < count; i++ ){
+		int16 mx = x, my = y;
+
+		if( !battle_simulation_cell( m, mx, my, range ) )
+			break;
+
+		mob_data* md = mob_once_spawn_sub( nullptr, m, mx, my, "--ja--", mob_id, "", SZ_SMALL, AI_NONE );
+
+		if( md == nullptr )
+			break;
+
+		mob_spawn( md );
+		monsters.push_back( md );
+	}
+}
+
+/**
+ * Removes monsters spawned by battle_simulation_spawn_mobs
+ * @param monsters: Monsters to remove
+ */
+static void battle_simulation_free_mobs( std::vector<mob_data*>& monsters ){
+	for( mob_data* md : monsters ){
+		unit_free( md, CLR_OUTSIGHT );
+	}
+
+	monsters.clear();
+}
+
+/**
+ * Counts the objects found by map_foreach*
+ */
+static int32 battle_simulation_count_sub( block_list* bl, va_list ap ){
+	int32* count = va_arg( ap, int32* );
+
+	(*count)++;
+	return 1;
+}
+
+/**
+ * Searches the monsters around a monster, with the va_list and the typed map_foreach* functions
+ * Both have to find the same monsters.
+ * @param m: Map ID
+ */
+static void battle_simulation_run_foreach( int16 m ){
+	std::vector<mob_data*> monsters;
+
+	generator.seed( BATTLE_SIMULATION_SEED );
+	battle_simulation_spawn_mobs( m, 1002, BATTLE_SIMULATION_AREA_MOBS, 150, 150, AREA_SIZE, monsters ); // Poring
+
+	if( monsters.empty() )
+		return;
+
+	for( int32 typed = 0; typed < 2; typed++ ){
+		int64 found = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for( int32 i = 0; i < BATTLE_SIMULATION_AREA_ITERATIONS; i++ ){
+			mob_data* center = monsters[i % monsters.size()];
+			int32 count = 0;
+
+			if( typed ){
+				map_foreachinallrange( [&count]( block_list* bl ){ count++; return 1; }, center, AREA_SIZE, BL_MOB );
+				map_foreachinallarea( [&count]( block_list* bl ){ count++; return 1; }, m, center->x - 5, center->y - 5, center->x + 5, center->y + 5, BL_MOB );
+			}else{
+				map_foreachinallrange( battle_simulation_count_sub, center, AREA_SIZE, BL_MOB, &count );
+				map_foreachinallarea( battle_simulation_count_sub, m, center->x - 5, center->y - 5, center->x + 5, center->y + 5, BL_MOB, &count );
+			}
+
+			found += count;
+		}
+
+		std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+		uint64 rate = static_cast<uint64>( BATTLE_SIMULATION_AREA_ITERATIONS * 1000000000.0 / std::max<int64>( time.count(), 1 ) );
+
+		ShowInfo( "Battle simulation 'Area searches %s': " CL_WHITE "%" PRIu64 CL_RESET " searches/s, " CL_WHITE "%" PRId64 CL_RESET " monsters found.\n", typed ? "typed" : "va_list", rate, found );
+	}
+
+	battle_simulation_free_mobs( monsters );
+}
+
+/**
+ * Runs the hard monster AI for many monsters around a group of players
+ * @param m: Map ID
+ */
+static void battle_simulation_run_ai( int16 m ){
+	std::vector<map_session_data*> players;
+	std::vector<mob_data*> monsters;
+
+	generator.seed( BATTLE_SIMULATION_SEED );
+
+	for( int32 i = 0; i < BATTLE_SIMULATION_AI_PLAYERS; i++ ){
+		map_session_data* sd = battle_simulation_create_pc( battle_simulation_scenarios.front().pc, m, i );
+
+		if( sd == nullptr )
+			break;
+
+		if( !battle_simulation_cell( m, sd->x, sd->y, 5 ) ){
+			battle_simulation_free_pc( sd );
+			break;
+		}
+
+		map_addblock( sd );
+		players.push_back( sd );
+	}
+
+	battle_simulation_spawn_mobs( m, 1002, BATTLE_SIMULATION_AI_MOBS, 150, 150, AREA_SIZE, monsters ); // Poring
+
+	t_tick tick = gettick();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for( int32 i = 0; i < BATTLE_SIMULATION_AI_TICKS; i++ ){
+		tick += MIN_MOBTHINKTIME;
+		mob_ai_hard( INVALID_TIMER, tick, 0, 0 );
+	}
+
+	std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+
+	ShowInfo( "Battle simulation 'Monster AI': " CL_WHITE "%" PRId64 CL_RESET " us per AI tick with " CL_WHITE "%" PRIuPTR CL_RESET " monsters around " CL_WHITE "%" PRIuPTR CL_RESET " players.\n",
+		static_cast<int64>( std::chrono::duration_cast<std::chrono::microseconds>( time ).count() / BATTLE_SIMULATION_AI_TICKS ), monsters.size(), players.size() );
+
+	battle_simulation_free_mobs( monsters );
+
+	for( map_session_data* sd : players ){
+		map_delblock( sd );
+		battle_simulation_free_pc( sd );
+	}
+}
+
+/**
+ * Searches walking and shooting paths between random cells
+ * @param m: Map ID
+ */
+static void battle_simulation_run_path( int16 m ){
+	std::vector<std::array<int16, 4>> searches;
+
+	generator.seed( BATTLE_SIMULATION_SEED );
+
+	while( searches.size() < BATTLE_SIMULATION_PATH_ITERATIONS ){
+		int16 x0 = 150, y0 = 150;
+
+		if( !battle_simulation_cell( m, x0, y0, 100 ) )
+			return;
+
+		int16 x1 = x0, y1 = y0;
+
+		if( battle_simulation_cell( m, x1, y1, AREA_SIZE ) )
+			searches.push_back( { x0, y0, x1, y1 } );
+	}
+
+	// The first search may set up the map
+	struct walkpath_data wpd;
+	struct shootpath_data spd;
+
+	path_search( &wpd, m, searches[0][0], searches[0][1], searches[0][2], searches[0][3], 0, CELL_CHKNOPASS );
+
+	for( int32 shoot = 0; shoot < 2; shoot++ ){
+		uint64 checksum = 0xCBF29CE484222325ULL;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for( const auto& search : searches ){
+			if( shoot ){
+				bool found = path_search_long( &spd, m, search[0], search[1], search[2], search[3], CELL_CHKWALL );
+
+				battle_simulation_checksum( checksum, found ? spd.len : -1 );
+			}else{
+				bool found = path_search( &wpd, m, search[0], search[1], search[2], search[3], 0, CELL_CHKNOPASS );
+
+				battle_simulation_checksum( checksum, found ? wpd.path_len : -1 );
+			}
+		}
+
+		std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+		uint64 rate = static_cast<uint64>( searches.size() * 1000000000.0 / std::max<int64>( time.count(), 1 ) );
+
+		ShowInfo( "Battle simulation '%s paths': " CL_WHITE "%" PRIu64 CL_RESET " searches/s, checksum " CL_WHITE "%016" PRIx64 CL_RESET ".\n", shoot ? "Shooting" : "Walking", rate, checksum );
+	}
+}
+
+/**
+ * Runs an event label that no NPC exports, like most of the OnClock, OnHour and OnMinute labels
+ */
+static void battle_simulation_run_events(){
+	int64 found = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for( int32 i = 0; i < BATTLE_SIMULATION_EVENT_ITERATIONS; i++ ){
+		found += npc_event_doall( "OnBattleSimulation" );
+	}
+
+	std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+	uint64 rate = static_cast<uint64>( BATTLE_SIMULATION_EVENT_ITERATIONS * 1000000000.0 / std::max<int64>( time.count(), 1 ) );
+
+	ShowInfo( "Battle simulation 'Unused event label': " CL_WHITE "%" PRIu64 CL_RESET " labels/s, " CL_WHITE "%" PRId64 CL_RESET " events run.\n", rate, found );
+}
+
+static int32 battle_simulation_timers[3]; ///< Timers of battle_simulation_run_timers
+static t_tick battle_simulation_timer_ticks[3][2]; ///< Ticks each of the timers ran at, first and second run
+
+/**
+ * Timer of battle_simulation_run_timers, the first one moves itself and the second one on its first run
+ * @param data: Index of the timer
+ */
+static TIMER_FUNC( battle_simulation_timer ){
+	t_tick* ticks = battle_simulation_timer_ticks[data];
+
+	ticks[ticks[0] == 0 ? 0 : 1] = tick;
+
+	if( data == 0 && ticks[1] == 0 ){
+		settick_timer( battle_simulation_timers[1], tick + 50 );
+		settick_timer( tid, tick + 100 );
+	}
+
+	return 0;
+}
+
+/**
+ * Checks that batched timers can move themselves and other timers of their batch while it runs
+ * Timer 0 moves timer 1 by 50 ms and itself by 100 ms, timer 2 is not touched.
+ */
+static void battle_simulation_run_timers(){
+	t_tick tick = gettick();
+
+	memset( battle_simulation_timer_ticks, 0, sizeof( battle_simulation_timer_ticks ) );
+
+	for( intptr_t i = 0; i < ARRAYLENGTH( battle_simulation_timers ); i++ ){
+		battle_simulation_timers[i] = add_timer_batch( tick, battle_simulation_timer, 0, i );
+	}
+
+	do_timer( tick );
+	do_timer( tick + 50 );
+	do_timer( tick + 100 );
+
+	const t_tick expected[3][2] = { { tick, tick + 100 }, { tick + 50, 0 }, { tick, 0 } };
+
+	if( memcmp( battle_simulation_timer_ticks, expected, sizeof( expected ) ) != 0 ){
+		ShowError( "Battle simulation 'Batched timers': timers ran at the wrong ticks.\n" );
+		return;
+	}
+
+	ShowInfo( "Battle simulation 'Batched timers': moved timers ran on their new ticks.\n" );
+}
+
+/**
+ * Repeats the damage calculation of fixed players and monsters with a fixed seed.
+ * The checksum only changes if the results do, which makes it possible to compare
+ * the outcome and the speed of the calculation before and after a change.
+ * Checksums are only comparable between builds with the same standard library.
+ */
+void battle_simulation_run(){
+	int16 m = map_mapname2mapid( MAP_PRONTERA );
+
+	if( m < 0 ){
+		ShowError( "battle_simulation_run: Map '%s' is not loaded.\n", MAP_PRONTERA );
+		return;
+	}
+
+	ShowStatus( "Running " CL_WHITE "%" PRIuPTR CL_RESET " battle simulation scenarios with " CL_WHITE "%d" CL_RESET " calculations each...\n", battle_simulation_scenarios.size(), BATTLE_SIMULATION_ITERATIONS );
+
+	uint64 checksum = 0xCBF29CE484222325ULL;
+
+	for( const s_battle_simulation_scenario& scenario : battle_simulation_scenarios ){
+		if( !battle_simulation_run_scenario( scenario, m, checksum ) )
+			return;
+	}
+
+	ShowStatus( "Battle simulation finished, checksum " CL_WHITE "%016" PRIx64 CL_RESET ".\n", checksum );
+
+	battle_simulation_run_status( m );
+	battle_simulation_run_foreach( m );
+	battle_simulation_run_ai( m );
+	battle_simulation_run_path( m );
+	battle_simulation_run_events();
+	battle_simulation_run_timers();
+}
+
+#endif /* MAP_GENERATOR */
@@ -0,0 +1,33 @@
+// Copyright (c) rAthena Dev Teams - Licensed under GNU GPL
+// For more information, see LICENCE in the main folder
+
+#ifndef BATTLE_SIMULATION_HPP
+#define BATTLE_SIMULATION_HPP
+
+#include <config/core.hpp>
+
+#ifdef MAP_GENERATOR
+
+/// Seed of the random number generator, reset before every scenario
+#define BATTLE_SIMULATION_SEED 20060101
+/// Damage calculations per scenario
+#define BATTLE_SIMULATION_ITERATIONS 1000000
+/// Status changes started and ended with and without the equipment layer cache
+#define BATTLE_SIMULATION_STATUS_ITERATIONS 100000
+/// Monsters searched for by area searches, and the number of searches
+#define BATTLE_SIMULATION_AREA_MOBS 200
+#define BATTLE_SIMULATION_AREA_ITERATIONS 200000
+/// Players and monsters of the monster AI scenario, and the number of AI ticks
+#define BATTLE_SIMULATION_AI_PLAYERS 20
+#define BATTLE_SIMULATION_AI_MOBS 1000
+#define BATTLE_SIMULATION_AI_TICKS 1000
+/// Path searches between random cells
+#define BATTLE_SIMULATION_PATH_ITERATIONS 200000
+/// Runs of an unused event label
+#define BATTLE_SIMULATION_EVENT_ITERATIONS 10000
+
+void battle_simulation_run();
+
+#endif /* MAP_GENERATOR */
+
+#endif /* BATTLE_SIMULATION_HPP */
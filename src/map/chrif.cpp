@@ -1288,8 +1288,8 @@ int32 chrif_save_scdata(map_session_data *sd) { //parses the sc_data of the play
 	WFIFOL(char_fd,8) = sd->status.char_id;
 
 	for( const auto& [type, sce] : *sc ){
-		if (sce.timer != INVALID_TIMER) {
-			timer = get_timer(sce.timer);
+		if (sce->timer != INVALID_TIMER) {
+			timer = get_timer(sce->timer);
 			if (timer == nullptr || timer->func != status_change_timer)
 				continue;
 			if (DIFF_TICK(timer->tick,tick) > 0)
@@ -1299,10 +1299,10 @@ int32 chrif_save_scdata(map_session_data *sd) { //parses the sc_data of the play
 		} else
 			data.tick = INFINITE_TICK; //Infinite duration
 		data.type = type;
-		data.val1 = sce.val1;
-		data.val2 = sce.val2;
-		data.val3 = sce.val3;
-		data.val4 = sce.val4;
+		data.val1 = sce->val1;
+		data.val2 = sce->val2;
+		data.val3 = sce->val3;
+		data.val4 = sce->val4;
 		memcpy(WFIFOP(char_fd,14 +count*sizeof(struct status_change_data)),
 			&data, sizeof(struct status_change_data));
 		count++;
@@ -5570,14 +5570,10 @@ void clif_skillunit_update( block_list& bl ){
 /*==========================================
  *
  *------------------------------------------*/
-static int32 clif_getareachar(block_list* bl,va_list ap)
+static int32 clif_getareachar(block_list* bl, map_session_data* sd)
 {
-	map_session_data *sd;
-
 	nullpo_ret(bl);
 
-	sd=va_arg(ap,map_session_data*);
-
 	if (!clif_session_isValid(sd))
 		return 0;
 
@@ -5600,12 +5596,10 @@ static int32 clif_getareachar(block_list* bl,va_list ap)
 /*==========================================
  * tbl has gone out of view-size of bl
  *------------------------------------------*/
-int32 clif_outsight(block_list *bl,va_list ap)
+int32 clif_outsight(block_list *bl, block_list *tbl)
 {
-	block_list *tbl;
 	struct view_data *vd;
 	TBL_PC *sd, *tsd;
-	tbl=va_arg(ap,block_list*);
 	if(bl == tbl) return 0;
 	sd = BL_CAST(BL_PC, bl);
 	tsd = BL_CAST(BL_PC, tbl);
@@ -5658,11 +5652,9 @@ int32 clif_outsight(block_list *bl,va_list ap)
 /*==========================================
  * tbl has come into view of bl
  *------------------------------------------*/
-int32 clif_insight(block_list *bl,va_list ap)
+int32 clif_insight(block_list *bl, block_list *tbl)
 {
-	block_list *tbl;
 	TBL_PC *sd, *tsd;
-	tbl=va_arg(ap,block_list*);
 
 	if (bl == tbl) return 0;
 
@@ -9885,7 +9877,7 @@ void clif_refresh(map_session_data *sd)
 	}
 	if( sd->ed )
 		clif_elemental_info(sd);
-	map_foreachinallrange(clif_getareachar,sd,AREA_SIZE,BL_ALL,sd);
+	map_foreachinallrange([sd]( block_list* target ){ return clif_getareachar( target, sd ); }, sd, AREA_SIZE, BL_ALL);
 	clif_weather_check(sd);
 	if( sd->chatID )
 		chat_leavechat(sd,0);
@@ -10843,7 +10835,7 @@ void clif_parse_LoadEndAck(int32 fd,map_session_data *sd)
 
 	// info about nearby objects
 	// must use foreachinarea (CIRCULAR_AREA interferes with foreachinrange)
-	map_foreachinallarea(clif_getareachar, sd->m, sd->x-AREA_SIZE, sd->y-AREA_SIZE, sd->x+AREA_SIZE, sd->y+AREA_SIZE, BL_ALL, sd);
+	map_foreachinallarea([sd]( block_list* target ){ return clif_getareachar( target, sd ); }, sd->m, sd->x-AREA_SIZE, sd->y-AREA_SIZE, sd->x+AREA_SIZE, sd->y+AREA_SIZE, BL_ALL);
 
 	// pet
 	if( sd->pd ) {
@@ -968,8 +968,8 @@ void clif_storageitemadded(map_session_data* sd, struct item* i, int32 index, in
 void clif_storageitemremoved( map_session_data& sd, uint16 index, uint32 amount );
 void clif_storageclose( map_session_data& sd );
 
-int32 clif_insight(block_list *bl,va_list ap);	// map_forallinmovearea callback
-int32 clif_outsight(block_list *bl,va_list ap);	// map_forallinmovearea callback
+int32 clif_insight(block_list *bl, block_list *tbl);	// map_foreachinmovearea callback
+int32 clif_outsight(block_list *bl, block_list *tbl);	// map_foreachinmovearea callback
 
 void clif_class_change( block_list& bl, int32 class_, enum send_target target = AREA, map_session_data* sd = nullptr );
 
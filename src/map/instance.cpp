@@ -3,6 +3,7 @@
 
 #include "instance.hpp"
 
+#include <chrono>
 #include <cstdlib>
 #include <cmath>
 
@@ -736,6 +737,7 @@ size_t instance_addmap( int32 instance_id ){
 	idata->nomapflag = db->nomapflag;
 	idata->nonpc = db->nonpc;
 
+	auto start = std::chrono::steady_clock::now();
 	int16 m;
 
 	// Add initial map
@@ -766,6 +768,14 @@ size_t instance_addmap( int32 instance_id ){
 	if(!db->nonpc)
 		instance_addnpc(idata);
 
+	size_t memory = 0;
+
+	for (const auto &it : idata->map)
+		memory += map_memory_size(map_getmapdata(it.m));
+
+	ShowInfo("[Instance] Maps of %s (%d) created in %" PRId64 " us, using %" PRIuPTR " KB.\n", db->name.c_str(), instance_id,
+		static_cast<int64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()), memory / 1024);
+
 	switch(idata->mode) {
 		case IM_NONE:
 			break;
@@ -1197,6 +1197,9 @@ void ItemDatabase::loadingFinished(){
 			ShowWarning( "Item %s (%u) is a shield and should have a view id. Defaulting to Guard...\n", item->name.c_str(), item->nameid );
 			item->look = 1;
 		}
+
+		// Constant bonus scripts of equipment and cards do not need the script engine on every status calculation
+		item->script_compiled = script_compile_bonus( item->script, item->script_bonus );
 	}
 
 	if( !this->exists( ITEMID_DUMMY ) ){
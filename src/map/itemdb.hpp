@@ -3420,6 +3420,8 @@ struct item_data
 	struct script_code *script;	//Default script for everything.
 	struct script_code *equip_script;	//Script executed once when equipping.
 	struct script_code *unequip_script;//Script executed once when unequipping.
+	std::vector<s_script_bonus> script_bonus; ///< Bonus calls of script, if it only consists of constant bonuses
+	bool script_compiled; ///< Whether script is applied through script_bonus instead of the script engine
 	struct {
 		unsigned available : 1;
 		uint32 no_equip;
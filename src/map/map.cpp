@@ -6,6 +6,15 @@
 #include <cstdlib>
 #include <cmath>
 
+#ifdef WIN32
+	#include <common/winapi.hpp>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
 #include <config/core.hpp>
 
 #include <common/cbasetypes.hpp>
@@ -26,6 +35,7 @@
 #include "achievement.hpp"
 #include "atcommand.hpp"
 #include "battle.hpp"
+#include "battle_simulation.hpp"
 #include "battleground.hpp"
 #include "cashshop.hpp"
 #include "channel.hpp"
@@ -57,6 +67,7 @@ using namespace rathena;
 using namespace rathena::server_map;
 
 std::string default_codepage = "";
+std::string log_codepage = "";
 
 int32 map_server_port = 3306;
 std::string map_server_ip = "127.0.0.1";
@@ -112,12 +123,10 @@ static DBMap* bossid_db=nullptr; /// int32 id -> mob_data* (MVP db)
 static DBMap* map_db=nullptr; /// uint32 mapindex -> struct map_data*
 static DBMap* nick_db=nullptr; /// uint32 char_id -> struct charid2nick* (requested names of offline characters)
 static DBMap* charid_db=nullptr; /// uint32 char_id -> map_session_data*
-static DBMap* regen_db=nullptr; /// int32 id -> block_list* (status_natural_heal processing)
 static DBMap* map_msg_db=nullptr;
 
 static int32 map_users=0;
 
-#define BLOCK_SIZE 8
 #define block_free_max 1048576
 block_list *block_free[block_free_max];
 static int32 block_free_count = 0, block_free_lock = 0;
@@ -166,6 +175,49 @@ struct map_cache_map_info {
 	int32 len;
 };
 
+#define MAP_CACHE_GRID_MAGIC "RAMG"
+#define MAP_CACHE_GRID_VERSION 1
+
+// Main header of the uncompressed map cache, written by the mapcache tool with -grid
+// Its cell grids are mapped into memory as they are and decoded on first use of a map
+struct map_cache_grid_header {
+	char magic[4]; // MAP_CACHE_GRID_MAGIC
+	uint16 version;
+	uint16 map_count;
+	uint32 alignment; // Every grid starts at a multiple of this
+};
+
+// Follows the main header once for each map
+struct map_cache_grid_info {
+	char name[MAP_NAME_LENGTH];
+	int16 xs;
+	int16 ys;
+	uint32 offset; // Start of the grid in the file, one gat type byte per cell
+};
+
+// A loaded map cache file
+struct s_map_cache {
+	char* buffer; // File contents, mapped into memory for the grid format
+	size_t size;
+	bool grid; // Whether the file has the uncompressed grid format
+	std::unordered_map<std::string, const struct map_cache_grid_info*> grids; // Map name -> grid, grid format only
+};
+
+static std::vector<struct s_map_cache> map_caches; // Grid caches stay mapped until shutdown, the maps point into them
+static struct mapcell map_cells_pending[1]; // Marks the cells of a map as not decoded yet, see map_data::cell_grid
+
+// Cells changed on a map that is not decoded yet are kept in its overlay, until they are more than 1/ratio of the map
+#define MAP_CELL_OVERLAY_RATIO 32
+
+static void map_cells_decode(struct map_data* mapdata);
+static void map_cells_unshare(struct map_data* mapdata);
+static void map_cells_free(struct map_data* mapdata);
+static inline struct mapcell map_cell_read(const struct map_data* mapdata, int16 x, int16 y);
+
+// Block lists of instance maps that never had an object, large enough for every map, see map_blocks_alloc
+static std::vector<block_list*> map_blocks_empty;
+static std::vector<struct s_block_presence> map_presence_empty;
+
 char motd_txt[256] = "conf/motd.txt";
 char charhelp_txt[256] = "conf/charhelp.txt";
 char channel_conf[256] = "conf/channels.conf";
@@ -185,12 +237,30 @@ char wisp_server_name[NAME_LENGTH] = "Server"; // can be modified in char-server
 int32 console = 0;
 int32 enable_spy = 0; //To enable/disable @spy commands, which consume too much cpu time when sending packets. [Skotlex]
 int32 enable_grf = 0;	//To enable/disable reading maps from GRF files, bypassing mapcache [blackhole89]
+int32 block_hugepages = 0; // Allocate the object pools from huge pages
+
+/// Slab pool of a block type, see map_block_alloc
+struct s_block_pool {
+	enum bl_type type;
+	const char* name;
+	uint32 size; // Size of an object
+	uint32 chunk; // Objects per chunk
+	ERS* ers;
+};
+
+static struct s_block_pool block_pools[] = {
+	{ BL_MOB, "map.cpp::block_pool_mob", sizeof(mob_data), 512, nullptr },
+	{ BL_NPC, "map.cpp::block_pool_npc", sizeof(npc_data), 512, nullptr },
+	{ BL_ITEM, "map.cpp::block_pool_item", sizeof(flooritem_data), 1024, nullptr },
+};
 
 #ifdef MAP_GENERATOR
 struct s_generator_options {
 	bool navi;
 	bool itemmoveinfo;
 	bool reputation;
+	bool battle_simulation;
+	bool navi_compare;
 } gen_options;
 #endif
 
@@ -228,11 +298,89 @@ int32 map_usercount(void)
 	return pc_db->size(pc_db);
 }
 
+/**
+ * Returns the pool of a block type
+ * @param type: Block type
+ * @return Pool or nullptr if the type is not pooled
+ */
+static struct s_block_pool* map_block_pool( enum bl_type type ){
+	for( struct s_block_pool& pool : block_pools ){
+		if( pool.type == type ){
+			return &pool;
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * Allocates zeroed memory for an object from the pool of its type
+ * Objects of a type are kept in chunks and reuse the memory of freed objects, so respawning
+ * mobs or dropped items do not fragment the heap. The addresses are stable until the object is freed.
+ * @param type: Block type, one of BL_MOB, BL_NPC or BL_ITEM
+ * @return Memory for the object, the constructor has to be called by the caller
+ */
+void* map_block_alloc( enum bl_type type ){
+	struct s_block_pool* pool = map_block_pool( type );
+
+	if( pool == nullptr ){
+		ShowError( "map_block_alloc: no pool for type %d\n", type );
+		return nullptr;
+	}
+
+	if( pool->ers == nullptr ){
+		return aCalloc( 1, pool->size );
+	}
+
+	void* entry = ers_alloc( pool->ers, void );
+
+	memset( entry, 0, pool->size );
+
+	return entry;
+}
+
+/**
+ * Returns memory allocated by map_block_alloc, the destructor has to be called before
+ * @param type: Block type it was allocated for
+ * @param entry: Memory of the object
+ */
+void map_block_free( enum bl_type type, void* entry ){
+	struct s_block_pool* pool = map_block_pool( type );
+
+	if( pool == nullptr || pool->ers == nullptr ){
+		aFree( entry );
+		return;
+	}
+
+	ers_free( pool->ers, entry );
+}
+
+/**
+ * Creates the object pools, configuration has to be read before
+ */
+static void map_block_pools_init( void ){
+	for( struct s_block_pool& pool : block_pools ){
+		pool.ers = ers_new( pool.size, pool.name, (ERSOptions)( ERS_OPT_FLEX_CHUNK | ( block_hugepages ? ERS_OPT_HUGEPAGES : 0 ) ) );
+		ers_chunk_size( pool.ers, pool.chunk );
+	}
+}
+
+static void map_block_pools_final( void ){
+	for( struct s_block_pool& pool : block_pools ){
+		if( pool.ers != nullptr ){
+			ers_destroy( pool.ers );
+			pool.ers = nullptr;
+		}
+	}
+}
+
 void map_destroyblock( block_list* bl ){
 	if( bl == nullptr ){
 		return;
 	}
 
+	enum bl_type type = bl->type;
+
 	switch( bl->type ){
 		case BL_NUL:
 			// Dummy type, has no destructor
@@ -284,7 +432,7 @@ void map_destroyblock( block_list* bl ){
 			break;
 	}
 
-	aFree( bl );
+	map_block_free( type, bl );
 }
 
 /*==========================================
@@ -386,6 +534,8 @@ static void map_addblcell(block_list *bl)
 
 	if( bl->m<0 || bl->x<0 || bl->x>=mapdata->xs || bl->y<0 || bl->y>=mapdata->ys || !(bl->type&BL_CHAR) )
 		return;
+	map_cells_decode(mapdata);
+	map_cells_unshare(mapdata);
 	mapdata->cell[bl->x+bl->y*mapdata->xs].cell_bl++;
 	return;
 }
@@ -396,10 +546,201 @@ static void map_delblcell(block_list *bl)
 
 	if( bl->m <0 || bl->x<0 || bl->x>=mapdata->xs || bl->y<0 || bl->y>=mapdata->ys || !(bl->type&BL_CHAR) )
 		return;
+	map_cells_decode(mapdata);
+	map_cells_unshare(mapdata);
 	mapdata->cell[bl->x+bl->y*mapdata->xs].cell_bl--;
 }
 #endif
 
+/**
+ * Monsters with a special AI are enemies of normal monsters and count as targets
+ * @param md: Monster
+ * @return true if the monster is a target for other monsters
+ */
+static bool map_presence_is_target( const mob_data& md ){
+	return md.special_state.ai != AI_NONE && md.special_state.ai != AI_WAVEMODE;
+}
+
+/**
+ * Updates the block presence counters a block is accounted in
+ * @param mapdata: Map Data
+ * @param pos: Index of the map block
+ * @param bl: Block
+ * @param add: true if the block enters the map block, false if it leaves it
+ */
+static void map_presence_update( struct map_data* mapdata, int32 pos, block_list& bl, bool add ){
+	if( mapdata->block_presence == nullptr )
+		return;
+
+	s_block_presence& presence = mapdata->block_presence[pos];
+
+	auto update = [&presence, add]( e_map_presence type ){
+		if( add )
+			presence.count[type]++;
+		else if( presence.count[type] > 0 )
+			presence.count[type]--;
+	};
+
+	switch( bl.type ){
+		case BL_PC:
+		case BL_HOM:
+		case BL_MER:
+			update( PRESENCE_TARGET );
+			update( PRESENCE_CHAR );
+			break;
+		case BL_MOB:
+			if( reinterpret_cast<mob_data&>( bl ).presence_target )
+				update( PRESENCE_TARGET );
+			update( PRESENCE_CHAR );
+			break;
+		case BL_ELEM:
+			update( PRESENCE_CHAR );
+			break;
+		case BL_ITEM:
+			update( PRESENCE_ITEM );
+			break;
+		case BL_SKILL:
+			update( PRESENCE_SKILL );
+			break;
+	}
+}
+
+/**
+ * Refreshes the block presence of a monster after its AI was changed while it is on the map
+ * @param md: Monster
+ */
+void map_presence_refresh( mob_data& md ){
+	bool target = map_presence_is_target( md );
+
+	if( target == md.presence_target )
+		return;
+
+	// Not in a map block, map_addblock takes care of it
+	if( md.prev == nullptr ){
+		md.presence_target = target;
+		return;
+	}
+
+	struct map_data* mapdata = map_getmapdata( md.m );
+
+	if( mapdata != nullptr && mapdata->block_presence != nullptr ){
+		s_block_presence& presence = mapdata->block_presence[md.x / BLOCK_SIZE + ( md.y / BLOCK_SIZE ) * mapdata->bxs];
+
+		if( target )
+			presence.count[PRESENCE_TARGET]++;
+		else if( presence.count[PRESENCE_TARGET] > 0 )
+			presence.count[PRESENCE_TARGET]--;
+	}
+
+	md.presence_target = target;
+}
+
+/**
+ * Checks if any block of a kind is in the map blocks covering a range
+ * The check is by map block and therefore may report blocks slightly out of range, but never misses one
+ * @param m: Map ID
+ * @param x: Center X
+ * @param y: Center Y
+ * @param range: Range in cells
+ * @param type: Kind of block
+ * @return true if there might be one in range, false if there is none
+ */
+bool map_presence_inrange( int16 m, int16 x, int16 y, int16 range, e_map_presence type ){
+	struct map_data* mapdata = map_getmapdata( m );
+
+	if( mapdata == nullptr || mapdata->block_presence == nullptr )
+		return true;
+
+	int32 bx0 = i16max( x - range, 0 ) / BLOCK_SIZE;
+	int32 by0 = i16max( y - range, 0 ) / BLOCK_SIZE;
+	int32 bx1 = i16min( x + range, mapdata->xs - 1 ) / BLOCK_SIZE;
+	int32 by1 = i16min( y + range, mapdata->ys - 1 ) / BLOCK_SIZE;
+
+	for( int32 by = by0; by <= by1; by++ ){
+		for( int32 bx = bx0; bx <= bx1; bx++ ){
+			if( mapdata->block_presence[bx + by * mapdata->bxs].count[type] > 0 )
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Checks if any block of the given block types might be in the map blocks covering a range
+ * Types without a presence counter are always reported as present
+ * @param m: Map ID
+ * @param x: Center X
+ * @param y: Center Y
+ * @param range: Range in cells
+ * @param type: Block types, see enum bl_type
+ * @return true if there might be one in range, false if there is none
+ */
+bool map_presence_inrange_type( int16 m, int16 x, int16 y, int16 range, int32 type ){
+	if( type&~( BL_CHAR|BL_ITEM|BL_SKILL ) )
+		return true;
+
+	return ( ( type&BL_CHAR ) && map_presence_inrange( m, x, y, range, PRESENCE_CHAR ) )
+		|| ( ( type&BL_ITEM ) && map_presence_inrange( m, x, y, range, PRESENCE_ITEM ) )
+		|| ( ( type&BL_SKILL ) && map_presence_inrange( m, x, y, range, PRESENCE_SKILL ) );
+}
+
+/**
+ * Counts the blocks of a kind on a map
+ * @param m: Map ID
+ * @param type: Kind of block
+ * @return Number of blocks
+ */
+size_t map_presence_count( int16 m, e_map_presence type ){
+	struct map_data* mapdata = map_getmapdata( m );
+
+	if( mapdata == nullptr || mapdata->block_presence == nullptr )
+		return 0;
+
+	size_t count = 0;
+
+	for( int32 i = 0; i < mapdata->bxs * mapdata->bys; i++ ){
+		count += mapdata->block_presence[i].count[type];
+	}
+
+	return count;
+}
+
+/**
+ * Allocates the block lists of a map that still uses the shared empty ones
+ * @param mapdata: Map Data
+ */
+static void map_blocks_alloc(struct map_data* mapdata)
+{
+	if (mapdata->block != map_blocks_empty.data())
+		return;
+
+	size_t count = static_cast<size_t>(mapdata->bxs) * mapdata->bys;
+
+	mapdata->block = (block_list**)aCalloc(count, sizeof(block_list*));
+	mapdata->block_mob = (block_list**)aCalloc(count, sizeof(block_list*));
+	mapdata->block_presence = (struct s_block_presence*)aCalloc(count, sizeof(struct s_block_presence));
+}
+
+/**
+ * Frees the block lists of a map
+ * @param mapdata: Map Data
+ */
+static void map_blocks_free(struct map_data* mapdata)
+{
+	if (mapdata->block != map_blocks_empty.data()) {
+		if (mapdata->block)
+			aFree(mapdata->block);
+		if (mapdata->block_mob)
+			aFree(mapdata->block_mob);
+		if (mapdata->block_presence)
+			aFree(mapdata->block_presence);
+	}
+	mapdata->block = nullptr;
+	mapdata->block_mob = nullptr;
+	mapdata->block_presence = nullptr;
+}
+
 /*==========================================
  * Adds a block to the map.
  * Returns 0 on success, 1 on failure (illegal coordinates).
@@ -431,6 +772,8 @@ int32 map_addblock(block_list* bl)
 	if (mapdata == nullptr || mapdata->cell == nullptr) // Player warped to a freed map. Stop them!
 		return 1;
 
+	map_blocks_alloc(mapdata);
+
 	if( x < 0 || x >= mapdata->xs || y < 0 || y >= mapdata->ys )
 	{
 		ShowError("map_addblock: out-of-bounds coordinates (\"%s\",%d,%d), map is %dx%d\n", mapdata->name, x, y, mapdata->xs, mapdata->ys);
@@ -451,6 +794,15 @@ int32 map_addblock(block_list* bl)
 		mapdata->block[pos] = bl;
 	}
 
+	if( bl->type == BL_MOB ){
+		mob_data* md = reinterpret_cast<mob_data*>( bl );
+
+		// Remember it, so that leaving the block undoes exactly what was counted here
+		md->presence_target = map_presence_is_target( *md );
+	}
+
+	map_presence_update( mapdata, pos, *bl, true );
+
 #ifdef CELL_NOSTACK
 	map_addblcell(bl);
 #endif
@@ -502,6 +854,8 @@ int32 map_delblock(block_list* bl)
 	bl->next = nullptr;
 	bl->prev = nullptr;
 
+	map_presence_update( mapdata, pos, *bl, false );
+
 	return 0;
 }
 
@@ -696,6 +1050,9 @@ skill_unit* map_find_skill_unit_oncell(block_list* target,int16 x,int16 y,uint16
 	if (x < 0 || y < 0 || (x >= mapdata->xs) || (y >= mapdata->ys))
 		return nullptr;
 
+	if (!map_presence_inrange(target->m, x, y, 0, PRESENCE_SKILL))
+		return nullptr;
+
 	bx = x/BLOCK_SIZE;
 	by = y/BLOCK_SIZE;
 
@@ -713,26 +1070,44 @@ skill_unit* map_find_skill_unit_oncell(block_list* target,int16 x,int16 y,uint16
 	return nullptr;
 }
 
+/**
+ * Releases the objects collected by a map_collect* function
+ * Collections have to be released in reverse order, callbacks can collect again while one is processed.
+ * @param list: Start of the collection
+ */
+void map_collect_release( block_list** list ){
+	bl_list_count = static_cast<int32>( list - bl_list );
+}
+
+/**
+ * Whether map_foreachinrange and map_foreachinarea check for walls between the center and the objects
+ */
+bool map_skill_wall_check( void ){
+	return battle_config.skill_wall_check > 0;
+}
+
 /*==========================================
  * Adapted from foreachinarea for an easier invocation. [Skotlex]
+ * Collects the objects in range of center into the buffer of map_foreach*
+ * @param count: Set to the number of objects collected
+ * @return Start of the collection, see map_collect_release
  *------------------------------------------*/
-int32 map_foreachinrangeV(int32 (*func)(block_list*,va_list),block_list* center, int16 range, int32 type, va_list ap, bool wall_check)
+block_list** map_collectinrange(block_list* center, int16 range, int32 type, bool wall_check, int32& count)
 {
 	int32 bx, by, m;
-	int32 returnCount = 0;	//total sum of returned values of func() [Skotlex]
 	block_list *bl;
-	int32 blockcount = bl_list_count, i;
+	int32 blockcount = bl_list_count;
 	int32 x0, x1, y0, y1;
-	va_list ap_copy;
 
+	count = 0;
 	m = center->m;
 	if( m < 0 )
-		return 0;
+		return &bl_list[blockcount];
 
 	struct map_data *mapdata = map_getmapdata(m);
 
 	if( mapdata == nullptr || mapdata->block == nullptr ){
-		return 0;
+		return &bl_list[blockcount];
 	}
 
 	x0 = i16max(center->x - range, 0);
@@ -776,18 +1151,29 @@ int32 map_foreachinrangeV(int32 (*func)(block_list*,va_list),block_list* center,
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinrange: block count too many!\n");
 
+	count = bl_list_count - blockcount;
+	return &bl_list[blockcount];
+}
+
+int32 map_foreachinrangeV(int32 (*func)(block_list*,va_list),block_list* center, int16 range, int32 type, va_list ap, bool wall_check)
+{
+	int32 returnCount = 0;	//total sum of returned values of func() [Skotlex]
+	int32 count;
+	block_list** list = map_collectinrange( center, range, type, wall_check, count );
+	va_list ap_copy;
+
 	FreeBlockLock freeLock;
 
-	for( i = blockcount; i < bl_list_count; i++ ) {
-		if( bl_list[ i ]->prev ) { //func() may delete this bl_list[] slot, checking for prev ensures it wasn't queued for deletion.
+	for( int32 i = 0; i < count; i++ ) {
+		if( list[i]->prev ) { //func() may delete this list[] slot, checking for prev ensures it wasn't queued for deletion.
 			va_copy(ap_copy, ap);
-			returnCount += func(bl_list[i], ap_copy);
+			returnCount += func(list[i], ap_copy);
 			va_end(ap_copy);
 		}
 	}
 
-	bl_list_count = blockcount;
-	return returnCount;	//[Skotlex]
+	map_collect_release( list );
+	return returnCount;
 }
 
 int32 map_foreachinrange(int32 (*func)(block_list*,va_list), block_list* center, int16 range, int32 type, ...)
@@ -833,17 +1219,18 @@ int32 map_foreachinshootrange(int32 (*func)(block_list*,va_list),block_list* cen
  * @param x1: East end of area
  * @param y1: North end of area
  * @param type: Type of bl to search for
+ * @param count: Set to the number of objects collected
+ * @return Start of the collection, see map_collect_release
 *------------------------------------------*/
-int32 map_foreachinareaV(int32 (*func)(block_list*, va_list), int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type, va_list ap, bool wall_check)
+block_list** map_collectinarea(int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type, bool wall_check, int32& count)
 {
 	int32 bx, by, cx, cy;
-	int32 returnCount = 0;	//total sum of returned values of func()
 	block_list *bl;
-	int32 blockcount = bl_list_count, i;
-	va_list ap_copy;
+	int32 blockcount = bl_list_count;
 
+	count = 0;
 	if (m < 0)
-		return 0;
+		return &bl_list[blockcount];
 
 	if (x1 < x0)
 		std::swap(x0, x1);
@@ -853,7 +1240,7 @@ int32 map_foreachinareaV(int32 (*func)(block_list*, va_list), int16 m, int16 x0,
 	struct map_data *mapdata = map_getmapdata(m);
 
 	if( mapdata == nullptr || mapdata->block == nullptr ){
-		return 0;
+		return &bl_list[blockcount];
 	}
 
 	x0 = i16max(x0, 0);
@@ -896,17 +1283,28 @@ int32 map_foreachinareaV(int32 (*func)(block_list*, va_list), int16 m, int16 x0,
 	if (bl_list_count >= BL_LIST_MAX)
 		ShowWarning("map_foreachinarea: block count too many!\n");
 
+	count = bl_list_count - blockcount;
+	return &bl_list[blockcount];
+}
+
+int32 map_foreachinareaV(int32 (*func)(block_list*, va_list), int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type, va_list ap, bool wall_check)
+{
+	int32 returnCount = 0;	//total sum of returned values of func() [Skotlex]
+	int32 count;
+	block_list** list = map_collectinarea( m, x0, y0, x1, y1, type, wall_check, count );
+	va_list ap_copy;
+
 	FreeBlockLock freeLock;
 
-	for (i = blockcount; i < bl_list_count; i++) {
-		if (bl_list[i]->prev) { //func() may delete this bl_list[] slot, checking for prev ensures it wasn't queued for deletion.
+	for( int32 i = 0; i < count; i++ ) {
+		if( list[i]->prev ) { //func() may delete this list[] slot, checking for prev ensures it wasn't queued for deletion.
 			va_copy(ap_copy, ap);
-			returnCount += func(bl_list[i], ap_copy);
+			returnCount += func(list[i], ap_copy);
 			va_end(ap_copy);
 		}
 	}
 
-	bl_list_count = blockcount;
+	map_collect_release( list );
 	return returnCount;
 }
 
@@ -1073,25 +1471,27 @@ int32 map_forcountinarea(int32 (*func)(block_list*,va_list), int16 m, int16 x0,
 /*==========================================
  * Move bl and do func* with va_list while moving.
  * Movement is set by dx dy which are distance in x and y
+ * Collects the objects that come into or leave sight into the buffer of map_foreach*
+ * @param count: Set to the number of objects collected
+ * @return Start of the collection, see map_collect_release
  *------------------------------------------*/
-int32 map_foreachinmovearea(int32 (*func)(block_list*,va_list), block_list* center, int16 range, int16 dx, int16 dy, int32 type, ...)
+block_list** map_collectinmovearea(block_list* center, int16 range, int16 dx, int16 dy, int32 type, int32& count)
 {
 	int32 bx, by, m;
-	int32 returnCount = 0;  //total sum of returned values of func() [Skotlex]
 	block_list *bl;
-	int32 blockcount = bl_list_count, i;
+	int32 blockcount = bl_list_count;
 	int16 x0, x1, y0, y1;
-	va_list ap;
 
-	if ( !range ) return 0;
-	if ( !dx && !dy ) return 0; //No movement.
+	count = 0;
+	if ( !range ) return &bl_list[blockcount];
+	if ( !dx && !dy ) return &bl_list[blockcount]; //No movement.
 
 	m = center->m;
 
 	struct map_data *mapdata = map_getmapdata(m);
 
 	if( mapdata == nullptr || mapdata->block == nullptr ){
-		return 0;
+		return &bl_list[blockcount];
 	}
 
 	x0 = center->x - range;
@@ -1185,17 +1585,28 @@ int32 map_foreachinmovearea(int32 (*func)(block_list*,va_list), block_list* cent
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinmovearea: block count too many!\n");
 
+	count = bl_list_count - blockcount;
+	return &bl_list[blockcount];
+}
+
+int32 map_foreachinmovearea(int32 (*func)(block_list*,va_list), block_list* center, int16 range, int16 dx, int16 dy, int32 type, ...)
+{
+	int32 returnCount = 0;	//total sum of returned values of func() [Skotlex]
+	int32 count;
+	block_list** list = map_collectinmovearea( center, range, dx, dy, type, count );
+	va_list ap;
+
 	FreeBlockLock freeLock;
 
-	for( i = blockcount; i < bl_list_count; i++ ) {
-		if( bl_list[ i ]->prev ) { //func() may delete this bl_list[] slot, checking for prev ensures it wasn't queued for deletion.
+	for( int32 i = 0; i < count; i++ ) {
+		if( list[i]->prev ) { //func() may delete this list[] slot, checking for prev ensures it wasn't queued for deletion.
 			va_start(ap, type);
-			returnCount += func(bl_list[ i ], ap);
+			returnCount += func(list[i], ap);
 			va_end(ap);
 		}
 	}
 
-	bl_list_count = blockcount;
+	map_collect_release( list );
 	return returnCount;
 }
 
@@ -1203,20 +1614,19 @@ int32 map_foreachinmovearea(int32 (*func)(block_list*,va_list), block_list* cent
 //			 which only checks the exact single x/y passed to it rather than an
 //			 area radius - may be more useful in some instances)
 //
-int32 map_foreachincell(int32 (*func)(block_list*,va_list), int16 m, int16 x, int16 y, int32 type, ...)
+block_list** map_collectincell(int16 m, int16 x, int16 y, int32 type, int32& count)
 {
 	int32 bx, by;
-	int32 returnCount = 0;  //total sum of returned values of func() [Skotlex]
 	block_list *bl;
-	int32 blockcount = bl_list_count, i;
+	int32 blockcount = bl_list_count;
 	struct map_data *mapdata = map_getmapdata(m);
-	va_list ap;
 
+	count = 0;
 	if( mapdata == nullptr || mapdata->block == nullptr ){
-		return 0;
+		return &bl_list[blockcount];
 	}
 
-	if ( x < 0 || y < 0 || x >= mapdata->xs || y >= mapdata->ys ) return 0;
+	if ( x < 0 || y < 0 || x >= mapdata->xs || y >= mapdata->ys ) return &bl_list[blockcount];
 
 	by = y / BLOCK_SIZE;
 	bx = x / BLOCK_SIZE;
@@ -1233,17 +1643,28 @@ int32 map_foreachincell(int32 (*func)(block_list*,va_list), int16 m, int16 x, in
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachincell: block count too many!\n");
 	
+	count = bl_list_count - blockcount;
+	return &bl_list[blockcount];
+}
+
+int32 map_foreachincell(int32 (*func)(block_list*,va_list), int16 m, int16 x, int16 y, int32 type, ...)
+{
+	int32 returnCount = 0;	//total sum of returned values of func() [Skotlex]
+	int32 count;
+	block_list** list = map_collectincell( m, x, y, type, count );
+	va_list ap;
+
 	FreeBlockLock freeLock;
 
-	for( i = blockcount; i < bl_list_count; i++ ) {
-		if( bl_list[ i ]->prev ) { //func() may delete this bl_list[] slot, checking for prev ensures it wasn't queued for deletion.
+	for( int32 i = 0; i < count; i++ ) {
+		if( list[i]->prev ) { //func() may delete this list[] slot, checking for prev ensures it wasn't queued for deletion.
 			va_start(ap, type);
-			returnCount += func(bl_list[ i ], ap);
+			returnCount += func(list[i], ap);
 			va_end(ap);
 		}
 	}
 
-	bl_list_count = blockcount;
+	map_collect_release( list );
 	return returnCount;
 }
 
@@ -2026,7 +2447,7 @@ int32 map_addflooritem(struct item *item, int32 amount, int16 m, int16 x, int16
 		}
 	}
 
-	CREATE(fitem, flooritem_data, 1);
+	fitem = (flooritem_data*)map_block_alloc(BL_ITEM);
 	fitem->type=BL_ITEM;
 	fitem->prev = fitem->next = nullptr;
 	fitem->m=m;
@@ -2034,7 +2455,7 @@ int32 map_addflooritem(struct item *item, int32 amount, int16 m, int16 x, int16
 	fitem->y=y;
 	fitem->id = map_get_new_object_id();
 	if (fitem->id==0) {
-		aFree(fitem);
+		map_block_free(BL_ITEM, fitem);
 		return 0;
 	}
 
@@ -2185,7 +2606,7 @@ void map_addiddb(block_list *bl)
 	}
 
 	if( bl->type & BL_REGEN )
-		idb_put(regen_db, bl->id, bl);
+		status_natural_heal_add(bl);
 
 	idb_put(id_db,bl->id,bl);
 }
@@ -2210,7 +2631,7 @@ void map_deliddb(block_list *bl)
 	}
 
 	if( bl->type & BL_REGEN )
-		idb_remove(regen_db,bl->id);
+		status_natural_heal_remove(bl);
 
 	idb_remove(id_db,bl->id);
 }
@@ -2563,28 +2984,6 @@ void map_foreachnpc(int32 (*func)(npc_data* nd, va_list args), ...)
 	dbi_destroy(iter);
 }
 
-/// Applies func to everything in the db.
-/// Stops iterating if func returns -1.
-void map_foreachregen(int32 (*func)(block_list* bl, va_list args), ...)
-{
-	DBIterator* iter;
-	block_list* bl;
-
-	iter = db_iterator(regen_db);
-	for( bl = (block_list*)dbi_first(iter); dbi_exists(iter); bl = (block_list*)dbi_next(iter) )
-	{
-		va_list args;
-		int32 ret;
-
-		va_start(args, func);
-		ret = func(bl, args);
-		va_end(args);
-		if( ret == -1 )
-			break;// stop iterating
-	}
-	dbi_destroy(iter);
-}
-
 /// Applies func to everything in the db.
 /// Stops iterating if func returns -1.
 void map_foreachiddb(int32 (*func)(block_list* bl, va_list args), ...)
@@ -2813,6 +3212,20 @@ bool map_addnpc(int16 m,npc_data *nd)
 	return true;
 }
 
+/**
+ * Gives a map a new cell generation, invalidating the cached path search results on it
+ * The generation is unique over all maps, so instance maps reusing a map ID never match old results
+ * @param mapdata: Map whose walkable or shootable cells changed
+ */
+static void map_cell_changed( struct map_data* mapdata ){
+	static uint32 generation = 0;
+
+	if( ++generation == 0 )
+		generation = 1;
+
+	mapdata->cell_generation = generation;
+}
+
 /*==========================================
  * Add an instance map
  *------------------------------------------*/
@@ -2867,16 +3280,38 @@ int32 map_addinstancemap(int32 src_m, int32 instance_id, bool no_mapflag)
 	dst_map->npc_num_area = 0;
 	dst_map->npc_num_warp = 0;
 
-	// Reallocate cells
-	size_t num_cell = dst_map->xs * dst_map->ys;
+	// Share the cells of the source map, modified cells are copied on write
+	// The source map takes new ones when its cells changed since the last instance, older instance maps keep theirs
+	if( src_map->cell_base == nullptr ){
+		src_map->cell_base = std::make_shared<std::vector<struct mapcell>>( static_cast<size_t>( src_map->xs ) * src_map->ys );
+
+		for( int16 y = 0; y < src_map->ys; y++ ){
+			for( int16 x = 0; x < src_map->xs; x++ ){
+				struct mapcell& cell = ( *src_map->cell_base )[x + y * src_map->xs];
 
-	CREATE( dst_map->cell, struct mapcell, num_cell );
-	memcpy( dst_map->cell, src_map->cell, num_cell * sizeof(struct mapcell) );
+				cell = map_cell_read( src_map, x, y );
+#ifdef CELL_NOSTACK
+				cell.cell_bl = 0;
+#endif
+			}
+		}
+	}
 
-	size_t size = dst_map->bxs * dst_map->bys * sizeof(block_list*);
+	dst_map->cell_base = src_map->cell_base;
+	dst_map->cell = dst_map->cell_base->data();
+	dst_map->cell_grid = nullptr;
+	dst_map->cell_modified = nullptr;
+	dst_map->cell_overlay.clear();
+	dst_map->cell_walkable = nullptr;
+	dst_map->cell_shootable = nullptr;
+	dst_map->cell_words = src_map->cell_words;
+	dst_map->cell_modified = (uint64*)aCalloc(static_cast<size_t>(dst_map->cell_words) * dst_map->ys, sizeof(uint64));
 
-	dst_map->block = (block_list **)aCalloc(1,size);
-	dst_map->block_mob = (block_list **)aCalloc(1,size);
+	// The block lists are allocated once the first object enters the map
+	dst_map->block = map_blocks_empty.data();
+	dst_map->block_mob = map_blocks_empty.data();
+	dst_map->block_presence = map_presence_empty.data();
+	map_cell_changed(dst_map);
 
 	dst_map->index = mapindex_addmap(-1, dst_map->name);
 	dst_map->channel = nullptr;
@@ -2958,15 +3393,9 @@ int32 map_delinstancemap(int32 m)
 	mapdata->mob_delete_timer = INVALID_TIMER;
 
 	// Free memory
-	if (mapdata->cell)
-		aFree(mapdata->cell);
-	mapdata->cell = nullptr;
-	if (mapdata->block)
-		aFree(mapdata->block);
-	mapdata->block = nullptr;
-	if (mapdata->block_mob)
-		aFree(mapdata->block_mob);
-	mapdata->block_mob = nullptr;
+	map_cells_free(mapdata);
+	map_cellbits_free(mapdata);
+	map_blocks_free(mapdata);
 
 	map_free_questinfo(mapdata);
 	mapdata->damage_adjust = {};
@@ -3298,6 +3727,140 @@ inline static struct mapcell map_gat2cell(int32 gat) {
 	return cell;
 }
 
+/**
+ * Decodes the cells of a map that were mapped from the map cache
+ * Called once many cells are modified, reading works on the mapped grid and the overlay.
+ * @param mapdata: Map Data
+ */
+static void map_cells_decode(struct map_data* mapdata)
+{
+	if (mapdata->cell_grid == nullptr)
+		return;
+
+	size_t num_cells = static_cast<size_t>(mapdata->xs) * mapdata->ys;
+	struct mapcell* cells;
+
+	CREATE(cells, struct mapcell, num_cells);
+
+	for (size_t xy = 0; xy < num_cells; xy++)
+		cells[xy] = map_gat2cell(mapdata->cell_grid[xy]);
+
+	for (const auto& it : mapdata->cell_overlay)
+		cells[it.first] = it.second;
+
+	if (mapdata->cell_modified != nullptr)
+		aFree(mapdata->cell_modified);
+	mapdata->cell_modified = nullptr;
+	mapdata->cell_overlay.clear();
+	mapdata->cell = cells;
+	mapdata->cell_grid = nullptr;
+}
+
+/**
+ * Frees the cells of a map, decoded or not
+ * @param mapdata: Map Data
+ */
+static void map_cells_free(struct map_data* mapdata)
+{
+	// The cells of instance maps are shared, see map_data::cell_base
+	if (mapdata->cell != nullptr && mapdata->cell != map_cells_pending && mapdata->cell_modified == nullptr)
+		aFree(mapdata->cell);
+	mapdata->cell = nullptr;
+	mapdata->cell_grid = nullptr;
+	mapdata->cell_base = nullptr;
+	if (mapdata->cell_modified != nullptr)
+		aFree(mapdata->cell_modified);
+	mapdata->cell_modified = nullptr;
+	mapdata->cell_overlay.clear();
+}
+
+/**
+ * Gives an instance map its own copy of all cells
+ * @param mapdata: Map Data
+ */
+static void map_cells_unshare(struct map_data* mapdata)
+{
+	if (mapdata->cell_modified == nullptr)
+		return;
+
+	size_t num_cells = static_cast<size_t>(mapdata->xs) * mapdata->ys;
+	struct mapcell* cells;
+
+	CREATE(cells, struct mapcell, num_cells);
+	memcpy(cells, mapdata->cell, num_cells * sizeof(struct mapcell));
+
+	for (const auto& it : mapdata->cell_overlay)
+		cells[it.first] = it.second;
+
+	aFree(mapdata->cell_modified);
+	mapdata->cell_modified = nullptr;
+	mapdata->cell_overlay.clear();
+	mapdata->cell = cells;
+	mapdata->cell_base = nullptr;
+}
+
+/**
+ * Reads a cell of a map, whether it is decoded, mapped or shared
+ * @param mapdata: Map Data
+ * @param x: X coordinate, must be on the map
+ * @param y: Y coordinate, must be on the map
+ * @return Cell
+ */
+static inline struct mapcell map_cell_read(const struct map_data* mapdata, int16 x, int16 y)
+{
+	int32 j = x + y * mapdata->xs;
+
+	if (mapdata->cell_modified != nullptr && map_cellbit(mapdata, mapdata->cell_modified, x, y))
+		return mapdata->cell_overlay.find(j)->second;
+
+	// Cells that are not decoded yet only have their terrain flags
+	if (mapdata->cell_grid != nullptr)
+		return map_gat2cell(mapdata->cell_grid[j]);
+
+	return mapdata->cell[j];
+}
+
+/**
+ * Returns a cell of a map for modification
+ * Instance maps and maps that are not decoded yet copy only the cell into their overlay.
+ * Mapped cells are decoded once too many of them are modified.
+ * @param mapdata: Map Data
+ * @param x: X coordinate, must be on the map
+ * @param y: Y coordinate, must be on the map
+ * @return Cell
+ */
+static struct mapcell& map_cell_modify(struct map_data* mapdata, int16 x, int16 y)
+{
+	int32 j = x + y * mapdata->xs;
+
+	if (mapdata->cell_grid != nullptr) {
+		// Instance maps created from now on have to see the change
+		mapdata->cell_base = nullptr;
+
+		if (mapdata->cell_overlay.size() >= static_cast<size_t>(mapdata->xs) * mapdata->ys / MAP_CELL_OVERLAY_RATIO)
+			map_cells_decode(mapdata);
+		else if (mapdata->cell_modified == nullptr)
+			mapdata->cell_modified = (uint64*)aCalloc(static_cast<size_t>(mapdata->cell_words) * mapdata->ys, sizeof(uint64));
+	}
+
+	if (mapdata->cell_modified != nullptr) {
+		uint64& word = mapdata->cell_modified[y * mapdata->cell_words + (x >> 6)];
+		uint64 bit = 1ULL << (x & 63);
+
+		if (!(word & bit)) {
+			mapdata->cell_overlay[j] = map_cell_read(mapdata, x, y);
+			word |= bit;
+		}
+
+		return mapdata->cell_overlay[j];
+	}
+
+	// Instance maps created from now on have to see the change
+	mapdata->cell_base = nullptr;
+
+	return mapdata->cell[j];
+}
+
 static int32 map_cell2gat(struct mapcell cell)
 {
 	if( cell.walkable == 1 && cell.shootable == 1 && cell.water == 0 ) return 0;
@@ -3330,7 +3893,7 @@ int32 map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
 	if(x<0 || x>=m->xs-1 || y<0 || y>=m->ys-1)
 		return( cellchk == CELL_CHKNOPASS );
 
-	cell = m->cell[x + y*m->xs];
+	cell = map_cell_read(m, x, y);
 
 	switch(cellchk)
 	{
@@ -3394,6 +3957,23 @@ int32 map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
 	}
 }
 
+/**
+ * Updates the bit of a cell in a cell bitmap
+ */
+static inline void map_cellbits_set(struct map_data* mapdata, uint64* bitmap, int16 x, int16 y, bool flag)
+{
+	if (bitmap == nullptr)
+		return;
+
+	uint64& word = bitmap[y * mapdata->cell_words + (x >> 6)];
+	uint64 bit = 1ULL << (x & 63);
+
+	if (flag)
+		word |= bit;
+	else
+		word &= ~bit;
+}
+
 /*==========================================
  * Change the type/flags of a map cell
  * 'cell' - which flag to modify
@@ -3401,27 +3981,26 @@ int32 map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
  *------------------------------------------*/
 void map_setcell(int16 m, int16 x, int16 y, cell_t cell, bool flag)
 {
-	int32 j;
 	struct map_data *mapdata = map_getmapdata(m);
 
 	if( m < 0 || x < 0 || x >= mapdata->xs || y < 0 || y >= mapdata->ys )
 		return;
 
-	j = x + y*mapdata->xs;
+	struct mapcell& target = map_cell_modify(mapdata, x, y);
 
 	switch( cell ) {
-		case CELL_WALKABLE:      mapdata->cell[j].walkable = flag;      break;
-		case CELL_SHOOTABLE:     mapdata->cell[j].shootable = flag;     break;
-		case CELL_WATER:         mapdata->cell[j].water = flag;         break;
-
-		case CELL_NPC:           mapdata->cell[j].npc = flag;           break;
-		case CELL_BASILICA:      mapdata->cell[j].basilica = flag;      break;
-		case CELL_LANDPROTECTOR: mapdata->cell[j].landprotector = flag; break;
-		case CELL_NOVENDING:     mapdata->cell[j].novending = flag;     break;
-		case CELL_NOCHAT:        mapdata->cell[j].nochat = flag;        break;
-		case CELL_MAELSTROM:	 mapdata->cell[j].maelstrom = flag;	  break;
-		case CELL_ICEWALL:		 mapdata->cell[j].icewall = flag;		  break;
-		case CELL_NOBUYINGSTORE: mapdata->cell[j].nobuyingstore = flag; break;
+		case CELL_WALKABLE:      target.walkable = flag;      map_cellbits_set(mapdata, mapdata->cell_walkable, x, y, flag); map_cell_changed(mapdata); break;
+		case CELL_SHOOTABLE:     target.shootable = flag;     map_cellbits_set(mapdata, mapdata->cell_shootable, x, y, flag); map_cell_changed(mapdata); break;
+		case CELL_WATER:         target.water = flag;         break;
+
+		case CELL_NPC:           target.npc = flag;           break;
+		case CELL_BASILICA:      target.basilica = flag;      break;
+		case CELL_LANDPROTECTOR: target.landprotector = flag; break;
+		case CELL_NOVENDING:     target.novending = flag;     break;
+		case CELL_NOCHAT:        target.nochat = flag;        break;
+		case CELL_MAELSTROM:	 target.maelstrom = flag;	  break;
+		case CELL_ICEWALL:		 target.icewall = flag;		  break;
+		case CELL_NOBUYINGSTORE: target.nobuyingstore = flag; break;
 		default:
 			ShowWarning("map_setcell: invalid cell type '%d'\n", (int32)cell);
 			break;
@@ -3430,19 +4009,93 @@ void map_setcell(int16 m, int16 x, int16 y, cell_t cell, bool flag)
 
 void map_setgatcell(int16 m, int16 x, int16 y, int32 gat)
 {
-	int32 j;
 	struct mapcell cell;
 	struct map_data *mapdata = map_getmapdata(m);
 
 	if( m < 0 || x < 0 || x >= mapdata->xs || y < 0 || y >= mapdata->ys )
 		return;
 
-	j = x + y*mapdata->xs;
+	struct mapcell& target = map_cell_modify(mapdata, x, y);
 
 	cell = map_gat2cell(gat);
-	mapdata->cell[j].walkable = cell.walkable;
-	mapdata->cell[j].shootable = cell.shootable;
-	mapdata->cell[j].water = cell.water;
+	target.walkable = cell.walkable;
+	target.shootable = cell.shootable;
+	target.water = cell.water;
+	map_cellbits_set(mapdata, mapdata->cell_walkable, x, y, cell.walkable);
+	map_cellbits_set(mapdata, mapdata->cell_shootable, x, y, cell.shootable);
+	map_cell_changed(mapdata);
+}
+
+/**
+ * Builds the cell bitmaps of a map from its cells, see map_cellbits_ready
+ * @param mapdata: Map with loaded cells
+ */
+void map_cellbits_build(struct map_data* mapdata)
+{
+	map_cellbits_free(mapdata);
+
+	if (mapdata->cell == nullptr)
+		return;
+
+	size_t words = static_cast<size_t>(mapdata->cell_words) * mapdata->ys;
+
+	CREATE(mapdata->cell_walkable, uint64, words);
+	CREATE(mapdata->cell_shootable, uint64, words);
+
+	for (int16 y = 0; y < mapdata->ys; y++) {
+		for (int16 x = 0; x < mapdata->xs; x++) {
+			struct mapcell cell = map_cell_read(mapdata, x, y);
+
+			map_cellbits_set(mapdata, mapdata->cell_walkable, x, y, cell.walkable);
+			map_cellbits_set(mapdata, mapdata->cell_shootable, x, y, cell.shootable);
+		}
+	}
+}
+
+void map_cellbits_free(struct map_data* mapdata)
+{
+	if (mapdata->cell_walkable != nullptr)
+		aFree(mapdata->cell_walkable);
+	mapdata->cell_walkable = nullptr;
+	if (mapdata->cell_shootable != nullptr)
+		aFree(mapdata->cell_shootable);
+	mapdata->cell_shootable = nullptr;
+}
+
+/**
+ * Memory owned by a map for its cells and blocks, without the cells an instance map shares with its source map
+ * @param mapdata: Map Data
+ * @return Size in bytes
+ */
+size_t map_memory_size(struct map_data* mapdata)
+{
+	size_t size = map_cellbits_size(mapdata);
+	size_t num_cells = static_cast<size_t>(mapdata->xs) * mapdata->ys;
+
+	if (mapdata->cell_modified != nullptr) {
+		size += sizeof(uint64) * mapdata->cell_words * mapdata->ys;
+		// Rough node size of the overlay, key and cell plus the hash chain and bucket
+		size += mapdata->cell_overlay.size() * (sizeof(std::pair<const int32, struct mapcell>) + 2 * sizeof(void*));
+	} else if (mapdata->cell != nullptr && mapdata->cell != map_cells_pending)
+		size += num_cells * sizeof(struct mapcell);
+
+	if (mapdata->block != nullptr && mapdata->block != map_blocks_empty.data())
+		size += static_cast<size_t>(mapdata->bxs) * mapdata->bys * (2 * sizeof(block_list*) + sizeof(struct s_block_presence));
+
+	return size;
+}
+
+/**
+ * Memory used by the cell bitmaps of a map
+ * @param mapdata: Map Data
+ * @return Size in bytes
+ */
+size_t map_cellbits_size(struct map_data* mapdata)
+{
+	if (mapdata->cell_walkable == nullptr)
+		return 0;
+
+	return 2 * sizeof(uint64) * mapdata->cell_words * mapdata->ys;
 }
 
 /*==========================================
@@ -3665,16 +4318,143 @@ static char *map_init_mapcache(FILE *fp)
 	return buffer;
 }
 
+/*==========================================
+ * Frees a map cache, unmapping it for the grid format
+ *------------------------------------------*/
+static void map_free_mapcache(struct s_map_cache& cache)
+{
+	if (cache.buffer == nullptr)
+		return;
+
+	if (cache.grid) {
+#ifdef WIN32
+		UnmapViewOfFile(cache.buffer);
+#else
+		munmap(cache.buffer, cache.size);
+#endif
+	} else
+		aFree(cache.buffer);
+
+	cache.buffer = nullptr;
+	cache.grids.clear();
+}
+
+/*==========================================
+ * Maps a map cache in the grid format into memory
+ * @param path: Map cache file
+ * @param cache: Filled with the mapping and the grid index
+ * @return true on success
+ *------------------------------------------*/
+static bool map_init_mapcache_grid(const char* path, struct s_map_cache& cache)
+{
+	void* view;
+	size_t size;
+
+#ifdef WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER file_size;
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (!GetFileSizeEx(file, &file_size)) {
+		CloseHandle(file);
+		return false;
+	}
+
+	// The view keeps the mapping alive, the handles are not needed anymore
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+		return false;
+
+	view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (view == nullptr)
+		return false;
+
+	size = static_cast<size_t>(file_size.QuadPart);
+#else
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return false;
+	}
+
+	size = static_cast<size_t>(st.st_size);
+	view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (view == MAP_FAILED)
+		return false;
+#endif
+
+	cache.buffer = static_cast<char*>(view);
+	cache.size = size;
+	cache.grid = true;
+
+	const struct map_cache_grid_header* header = reinterpret_cast<const struct map_cache_grid_header*>(cache.buffer);
+
+	if (size < sizeof(struct map_cache_grid_header) || header->version != MAP_CACHE_GRID_VERSION || size < sizeof(struct map_cache_grid_header) + header->map_count * sizeof(struct map_cache_grid_info)) {
+		ShowError("map_init_mapcache_grid: Unsupported version or truncated file (%s)\n", path);
+		map_free_mapcache(cache);
+		return false;
+	}
+
+	const struct map_cache_grid_info* info = reinterpret_cast<const struct map_cache_grid_info*>(cache.buffer + sizeof(struct map_cache_grid_header));
+
+	for (uint16 i = 0; i < header->map_count; i++, info++) {
+		if (info->xs <= 0 || info->ys <= 0 || info->offset + static_cast<size_t>(info->xs) * info->ys > size) {
+			ShowWarning("map_init_mapcache_grid: Invalid grid of map %.*s, skipping...\n", MAP_NAME_LENGTH, info->name);
+			continue;
+		}
+
+		cache.grids[std::string(info->name, strnlen(info->name, MAP_NAME_LENGTH))] = info;
+	}
+
+	return true;
+}
+
 /*==========================================
  * Map cache reading
  * [Shinryo]: Optimized some behaviour to speed this up
+ * Maps from a grid map cache are only pointed to, their cells are decoded on first use.
  *==========================================*/
-int32 map_readfromcache(struct map_data *m, char *buffer, char *decode_buffer)
+int32 map_readfromcache(struct map_data *m, struct s_map_cache& cache, char *decode_buffer)
 {
+	if (cache.grid) {
+		auto it = cache.grids.find(m->name);
+
+		if (it == cache.grids.end())
+			return 0; // Not found
+
+		const struct map_cache_grid_info* info = it->second;
+
+		if ((size_t)info->xs * (size_t)info->ys > MAX_MAP_SIZE) {
+			ShowWarning("map_readfromcache: %s exceeded MAX_MAP_SIZE of %d\n", m->name, MAX_MAP_SIZE);
+			return 0;
+		}
+
+		m->xs = info->xs;
+		m->ys = info->ys;
+		m->cell = map_cells_pending;
+		m->cell_grid = reinterpret_cast<const uint8*>(cache.buffer + info->offset);
+
+		return 1;
+	}
+
 	int32 i;
-	struct map_cache_main_header *header = (struct map_cache_main_header *)buffer;
+	struct map_cache_main_header *header = (struct map_cache_main_header *)cache.buffer;
 	struct map_cache_map_info *info = nullptr;
-	char *p = buffer + sizeof(struct map_cache_main_header);
+	char *p = cache.buffer + sizeof(struct map_cache_main_header);
 
 	for(i = 0; i < header->map_count; i++) {
 		info = (struct map_cache_map_info *)p;
@@ -3911,8 +4691,7 @@ void map_removemapdb(struct map_data *m)
 int32 map_readallmaps (void)
 {
 	FILE* fp;
-	// Has the uncompressed gat data of all maps, so just one allocation has to be made
-	std::vector<char *> map_cache_buffer = {};
+	int32 maps_pending = 0;
 
 	if( enable_grf )
 		ShowStatus("Loading maps (using GRF files)...\n");
@@ -3932,15 +4711,30 @@ int32 map_readallmaps (void)
 				continue;
 			}
 
-			// Init mapcache data. [Shinryo]
-			map_cache_buffer.push_back(map_init_mapcache(fp));
+			struct s_map_cache cache = {};
+			char magic[sizeof(MAP_CACHE_GRID_MAGIC) - 1] = {};
+
+			// Uncompressed caches are mapped into memory, compressed ones read completely
+			if( fread(magic, 1, sizeof(magic), fp) == sizeof(magic) && memcmp(magic, MAP_CACHE_GRID_MAGIC, sizeof(magic)) == 0 ) {
+				fclose(fp);
+
+				if( !map_init_mapcache_grid(mapdat.c_str(), cache) ) {
+					ShowFatalError( "Failed to map mapcache data (%s)..\n", mapdat.c_str());
+					exit(EXIT_FAILURE);
+				}
+			} else {
+				// Init mapcache data. [Shinryo]
+				cache.buffer = map_init_mapcache(fp);
+
+				if( !cache.buffer ) {
+					ShowFatalError( "Failed to initialize mapcache data (%s)..\n", mapdat.c_str());
+					exit(EXIT_FAILURE);
+				}
 
-			if( !map_cache_buffer.back() ) {
-				ShowFatalError( "Failed to initialize mapcache data (%s)..\n", mapdat.c_str());
-				exit(EXIT_FAILURE);
+				fclose(fp);
 			}
 
-			fclose(fp);
+			map_caches.push_back(std::move(cache));
 		}
 	}
 
@@ -3965,7 +4759,7 @@ int32 map_readallmaps (void)
 			success = map_readgat(mapdata) != 0;
 		}else{
 			// try to load the map
-			for (const auto &cache : map_cache_buffer) {
+			for (auto &cache : map_caches) {
 				if ((success = map_readfromcache(mapdata, cache, map_cache_decode_buffer)) != 0)
 					break;
 			}
@@ -3983,10 +4777,7 @@ int32 map_readallmaps (void)
 
 		if (uidb_get(map_db,(uint32)mapdata->index) != nullptr) {
 			ShowWarning("Map %s already loaded!" CL_CLL "\n", mapdata->name);
-			if (mapdata->cell) {
-				aFree(mapdata->cell);
-				mapdata->cell = nullptr;
-			}
+			map_cells_free(mapdata);
 			map_delmapid(i);
 			maps_removed++;
 			i--;
@@ -4005,22 +4796,44 @@ int32 map_readallmaps (void)
 		size = mapdata->bxs * mapdata->bys * sizeof(block_list*);
 		mapdata->block = (block_list**)aCalloc(size, 1);
 		mapdata->block_mob = (block_list**)aCalloc(size, 1);
+		mapdata->block_presence = (struct s_block_presence*)aCalloc(mapdata->bxs * mapdata->bys, sizeof(struct s_block_presence));
+		map_cell_changed(mapdata);
+		// The cell bitmaps are built on first use
+		mapdata->cell_words = (mapdata->xs + 63) / 64;
+
+		if (mapdata->cell_grid != nullptr)
+			maps_pending++;
 
 		memset(&mapdata->save, 0, sizeof(struct point));
 		mapdata->damage_adjust = {};
 		mapdata->channel = nullptr;
 	}
 
+	// Instance maps share these until an object enters them, so they have to fit the largest map
+	size_t blocks_max = 0;
+
+	for (int32 i = 0; i < map_num; i++)
+		blocks_max = std::max(blocks_max, static_cast<size_t>(map[i].bxs) * map[i].bys);
+
+	map_blocks_empty.assign(blocks_max, nullptr);
+	map_presence_empty.assign(blocks_max, {});
+
 	// intialization and configuration-dependent adjustments of mapflags
 	map_flags_init();
 
 	if( !enable_grf ) {
-		// The cache isn't needed anymore, so free it. [Shinryo]
-		auto it = map_cache_buffer.begin();
+		// The compressed caches aren't needed anymore, so free them. [Shinryo]
+		// Grid caches stay mapped, the maps that were loaded from them point into them.
+		auto it = map_caches.begin();
+
+		while (it != map_caches.end()) {
+			if (it->grid) {
+				it++;
+				continue;
+			}
 
-		while (it != map_cache_buffer.end()) {
-			aFree(*it);
-			it = map_cache_buffer.erase(it);
+			map_free_mapcache(*it);
+			it = map_caches.erase(it);
 		}
 	}
 
@@ -4029,6 +4842,8 @@ int32 map_readallmaps (void)
 
 	// finished map loading
 	ShowInfo("Successfully loaded '" CL_WHITE "%d" CL_RESET "' maps." CL_CLL "\n",map_num);
+	if (maps_pending)
+		ShowInfo("'" CL_WHITE "%d" CL_RESET "' maps are mapped from the map cache and decoded on first use.\n", maps_pending);
 
 	return 0;
 }
@@ -4097,12 +4912,37 @@ int32 parse_console(const char* buf){
 	else if( strcmpi("ers_report", type) == 0 ){
 		ers_report();
 	}
+	else if( strcmpi("malloc_report", type) == 0 ){
+		malloc_report( n == 2 ? max( atoi( command ), 1 ) : 20 );
+	}
+	else if( strcmpi("script_report", type) == 0 ){
+		script_sleep_report();
+	}
+	else if( strcmpi("path_report", type) == 0 ){
+		path_cache_report();
+	}
+	else if( strcmpi("status_report", type) == 0 ){
+		status_calc_pc_report();
+		status_natural_heal_report();
+	}
+	else if( strcmpi("timer_report", type) == 0 ){
+		timer_report();
+	}
+	else if( strcmpi("skill_unit_report", type) == 0 ){
+		skill_unit_report();
+	}
 	else if( strcmpi("help", type) == 0 ) {
 		ShowInfo("Available commands:\n");
 		ShowInfo("\t admin:@<atcommand> => Uses an atcommand. Do NOT use commands requiring an attached player.\n");
 		ShowInfo("\t admin:map:<map> <x> <y> => Changes the map from which console commands are executed.\n");
 		ShowInfo("\t server:shutdown => Stops the server.\n");
 		ShowInfo("\t ers_report => Displays database usage.\n");
+		ShowInfo("\t malloc_report[:<count>] => Displays the call sites with the most memory in use.\n");
+		ShowInfo("\t script_report => Displays suspended script and asynchronous query statistics.\n");
+		ShowInfo("\t path_report => Displays path search cache statistics.\n");
+		ShowInfo("\t status_report => Displays player status calculation and natural heal statistics.\n");
+		ShowInfo("\t timer_report => Displays timer heap and batched timer statistics.\n");
+		ShowInfo("\t skill_unit_report => Displays the skill units of each map and skill unit timer statistics.\n");
 	}
 
 	return 0;
@@ -4199,6 +5039,8 @@ int32 map_config_read(const char *cfgName)
 			enable_spy = config_switch(w2);
 		else if (strcmpi(w1, "use_grf") == 0)
 			enable_grf = config_switch(w2);
+		else if (strcmpi(w1, "block_hugepages") == 0)
+			block_hugepages = config_switch(w2);
 		else if (strcmpi(w1, "console_msg_log") == 0)
 			console_msg_log = atoi(w2);//[Ind]
 		else if (strcmpi(w1, "console_log_filepath") == 0)
@@ -4367,6 +5209,9 @@ int32 inter_config_read(const char *cfgName)
 		if(strcmpi(w1,"log_db_db")==0)
 			log_db_db = w2;
 		else
+		if(strcmpi(w1,"log_codepage")==0)
+			log_codepage = w2;
+		else
 		if(strcmpi(w1,"start_status_points")==0)
 			inter_config.start_status_points=atoi(w2);
 		else
@@ -4455,9 +5300,13 @@ int32 log_sql_init(void)
 	}
 	ShowStatus("" CL_WHITE "[SQL]" CL_RESET ": Successfully '" CL_GREEN "connected" CL_RESET "' to Database '" CL_WHITE "%s" CL_RESET "'.\n", log_db_db.c_str());
 
-	if( !default_codepage.empty() )
+	if( !log_codepage.empty() ){
+		if ( SQL_ERROR == Sql_SetEncoding(logmysql_handle, log_codepage.c_str()) )
+			Sql_ShowDebug(logmysql_handle);
+	}else if( !default_codepage.empty() ){
 		if ( SQL_ERROR == Sql_SetEncoding(logmysql_handle, default_codepage.c_str()) )
 			Sql_ShowDebug(logmysql_handle);
+	}
 
 	return 0;
 }
@@ -4741,6 +5590,9 @@ bool map_setmapflag_sub(int16 m, enum e_mapflag mapflag, bool status, union u_ma
 		return false;
 	}
 
+	// Equipment may work differently now, this includes the zone of MF_RESTRICTED
+	status_calc_pc_layer_invalidate();
+
 	switch(mapflag) {
 		case MF_NOSAVE:
 			if (status) {
@@ -5078,9 +5930,9 @@ void MapServer::finalize(){
 	for (int32 i = 0; i < map_num; i++) {
 		struct map_data *mapdata = map_getmapdata(i);
 
-		if(mapdata->cell) aFree(mapdata->cell);
-		if(mapdata->block) aFree(mapdata->block);
-		if(mapdata->block_mob) aFree(mapdata->block_mob);
+		map_cells_free(mapdata);
+		map_cellbits_free(mapdata);
+		map_blocks_free(mapdata);
 		if(battle_config.dynamic_mobs) { //Dynamic mobs flag by [random]
 			if(mapdata->mob_delete_timer != INVALID_TIMER)
 				delete_timer(mapdata->mob_delete_timer, map_removemobs_timer);
@@ -5090,6 +5942,10 @@ void MapServer::finalize(){
 		mapdata->damage_adjust = {};
 	}
 
+	for (auto &cache : map_caches)
+		map_free_mapcache(cache);
+	map_caches.clear();
+
 	mapindex_final();
 	if(enable_grf)
 		grfio_final();
@@ -5101,9 +5957,9 @@ void MapServer::finalize(){
 	nick_db->destroy(nick_db, nick_db_final);
 	charid_db->destroy(charid_db, nullptr);
 	iwall_db->destroy(iwall_db, nullptr);
-	regen_db->destroy(regen_db, nullptr);
 
 	map_sql_close();
+	map_block_pools_final();
 
 	ShowStatus("Finished.\n");
 }
@@ -5263,6 +6119,11 @@ int32 mapgenerator_get_options(int32 argc, char** argv) {
 				gen_options.itemmoveinfo = true;
 			} else if (strcmp(arg, "generate-reputation") == 0) {
 				gen_options.reputation = true;
+			} else if (strcmp(arg, "benchmark-battle") == 0) {
+				gen_options.battle_simulation = true;
+			} else if (strcmp(arg, "benchmark-navi") == 0) {
+				gen_options.navi = true;
+				gen_options.navi_compare = true;
 			} else {
 				// pass through to default get_options
 				continue;
@@ -5390,6 +6251,8 @@ bool MapServer::initialize( int32 argc, char *argv[] ){
 	inter_config_read(INTER_CONF_NAME);
 	log_config_read(LOG_CONF_NAME);
 
+	map_block_pools_init();
+
 	id_db = idb_alloc(DB_OPT_BASE);
 	pc_db = idb_alloc(DB_OPT_BASE);	//Added for reliable map_id2sd() use. [Skotlex]
 	mobid_db = idb_alloc(DB_OPT_BASE);	//Added to lower the load of the lazy mob ai. [Skotlex]
@@ -5397,7 +6260,6 @@ bool MapServer::initialize( int32 argc, char *argv[] ){
 	map_db = uidb_alloc(DB_OPT_BASE);
 	nick_db = idb_alloc(DB_OPT_BASE);
 	charid_db = uidb_alloc(DB_OPT_BASE);
-	regen_db = idb_alloc(DB_OPT_BASE); // efficient status_natural_heal processing
 	iwall_db = strdb_alloc(DB_OPT_RELEASE_DATA,2*NAME_LENGTH+2+1); // [Zephyrus] Invisible Walls
 
 	map_sql_init();
@@ -5457,11 +6319,13 @@ bool MapServer::initialize( int32 argc, char *argv[] ){
 #else
 	// depending on gen_options, generate the correct things
 	if (gen_options.navi)
-		navi_create_lists();
+		navi_create_lists(gen_options.navi_compare);
 	if (gen_options.itemmoveinfo)
 		itemdb_gen_itemmoveinfo();
 	if (gen_options.reputation)
 		pc_reputation_generate();
+	if (gen_options.battle_simulation)
+		battle_simulation_run();
 	this->signal_shutdown();
 #endif
 
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstdarg>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -64,6 +65,7 @@ void map_msg_reload(void);
 
 #define MAX_NPC_PER_MAP 512
 #define AREA_SIZE battle_config.area_size
+#define BLOCK_SIZE 8 // Size of a map block in cells
 #ifndef DAMAGELOG_SIZE 
 	#define DAMAGELOG_SIZE 20
 #endif
@@ -816,12 +818,33 @@ struct iwall_data {
 	bool shootable;
 };
 
+/// Kinds of blocks counted per map block, used to skip area searches that cannot find anything
+enum e_map_presence : uint8 {
+	PRESENCE_TARGET = 0, ///< Potential targets of normal monsters (players, homunculi, mercenaries and monsters with a special AI)
+	PRESENCE_ITEM, ///< Floor items
+	PRESENCE_CHAR, ///< Characters of any kind (BL_CHAR), the targets of skill units
+	PRESENCE_SKILL, ///< Skill units
+	PRESENCE_MAX
+};
+
+struct s_block_presence {
+	uint16 count[PRESENCE_MAX];
+};
+
 struct map_data {
 	char name[MAP_NAME_LENGTH];
 	uint16 index; // The map index used by the mapindex* functions.
 	struct mapcell* cell; // Holds the information of each map cell (nullptr if the map is not on this map-server).
+	const uint8* cell_grid; // Gat type of each cell in the mapped map cache while the cells are not decoded yet, see map_cells_decode
+	std::shared_ptr<std::vector<struct mapcell>> cell_base; // Cells shared read-only by instance maps, taken when the map is instanced and dropped when one of its cells changes
+	uint64* cell_modified; // Cells that differ from the shared cells of an instance map or the grid of a map that is not decoded yet, their copies are in cell_overlay
+	std::unordered_map<int32, struct mapcell> cell_overlay; // Modified cells, see cell_modified, cell index -> cell
+	uint64* cell_walkable; // Walkable flag of each cell packed in bits, rows are cell_words long
+	uint64* cell_shootable; // Shootable flag of each cell packed in bits, rows are cell_words long
+	int16 cell_words; // Number of 64 bit words per row of the cell bitmaps and cell_modified
 	block_list **block;
 	block_list **block_mob;
+	struct s_block_presence* block_presence; // Counters of each map block, see e_map_presence
 	int16 m;
 	int16 xs,ys; // map dimensions (in cells)
 	int16 bxs,bys; // map dimensions (in blocks)
@@ -832,6 +855,7 @@ struct map_data {
 	int32 users;
 	int32 users_pvp;
 	int32 iwall_num; // Total of invisible walls in this map
+	uint32 cell_generation; // Changes whenever walkable or shootable cells change, see map_cell_changed
 
 	struct point save;
 	std::vector<s_drop_list> drop_list;
@@ -906,6 +930,68 @@ extern struct inter_conf inter_config;
 
 int32 map_getcell(int16 m,int16 x,int16 y,cell_chk cellchk);
 int32 map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk);
+void map_cellbits_build(struct map_data* mapdata);
+void map_cellbits_free(struct map_data* mapdata);
+size_t map_cellbits_size(struct map_data* mapdata);
+size_t map_memory_size(struct map_data* mapdata);
+
+/**
+ * Returns the bit of a cell in a cell bitmap
+ * @param mapdata: Map Data
+ * @param bitmap: Cell bitmap of the map
+ * @param x: X coordinate, must be on the map
+ * @param y: Y coordinate, must be on the map
+ * @return Bit of the cell
+ */
+inline bool map_cellbit(const struct map_data* mapdata, const uint64* bitmap, int16 x, int16 y) {
+	return (bitmap[y * mapdata->cell_words + (x >> 6)] >> (x & 63)) & 1;
+}
+
+/**
+ * Returns whether a map has cell bitmaps, they are built on first use
+ * @param mapdata: Map Data
+ * @return false if the map has no cells
+ */
+inline bool map_cellbits_ready(struct map_data* mapdata) {
+	if (mapdata->cell_walkable == nullptr && mapdata->cell != nullptr)
+		map_cellbits_build(mapdata);
+
+	return mapdata->cell_walkable != nullptr;
+}
+
+/**
+ * Same as map_getcellp, but answers the terrain checks from the cell bitmaps
+ * @param m: Map Data
+ * @param x: X coordinate
+ * @param y: Y coordinate
+ * @param cellchk: Cell check
+ * @return Result of the check
+ */
+inline int32 map_getcellbits(struct map_data* m, int16 x, int16 y, cell_chk cellchk) {
+	if (!map_cellbits_ready(m))
+		return map_getcellp(m, x, y, cellchk);
+
+	//NOTE: this intentionally overrides the last row and column, see map_getcellp
+	if (x < 0 || x >= m->xs - 1 || y < 0 || y >= m->ys - 1)
+		return (cellchk == CELL_CHKNOPASS);
+
+	switch (cellchk) {
+		case CELL_CHKWALL:
+			return !map_cellbit(m, m->cell_walkable, x, y) && !map_cellbit(m, m->cell_shootable, x, y);
+#ifndef CELL_NOSTACK
+		case CELL_CHKPASS:
+#endif
+		case CELL_CHKREACH:
+			return map_cellbit(m, m->cell_walkable, x, y);
+#ifndef CELL_NOSTACK
+		case CELL_CHKNOPASS:
+#endif
+		case CELL_CHKNOREACH:
+			return !map_cellbit(m, m->cell_walkable, x, y);
+		default:
+			return map_getcellp(m, x, y, cellchk);
+	}
+}
 void map_setcell(int16 m, int16 x, int16 y, cell_t cell, bool flag);
 void map_setgatcell(int16 m, int16 x, int16 y, int32 gat);
 
@@ -1137,6 +1223,9 @@ void map_setusers(int32);
 int32 map_getusers(void);
 int32 map_usercount(void);
 
+// blocklist memory
+void* map_block_alloc(enum bl_type type);
+void map_block_free(enum bl_type type, void* entry);
 // blocklist lock
 int32 map_freeblock(block_list *bl);
 int32 map_freeblock_lock(void);
@@ -1145,6 +1234,10 @@ int32 map_freeblock_unlock(void);
 int32 map_addblock(block_list* bl);
 int32 map_delblock(block_list* bl);
 int32 map_moveblock(block_list *, int32, int32, t_tick);
+bool map_presence_inrange(int16 m, int16 x, int16 y, int16 range, e_map_presence type);
+bool map_presence_inrange_type(int16 m, int16 x, int16 y, int16 range, int32 type);
+size_t map_presence_count(int16 m, e_map_presence type);
+void map_presence_refresh(mob_data& md);
 int32 map_foreachinrange(int32 (*func)(block_list*,va_list), block_list* center, int16 range, int32 type, ...);
 int32 map_foreachinallrange(int32 (*func)(block_list*,va_list), block_list* center, int16 range, int32 type, ...);
 int32 map_foreachinshootrange(int32 (*func)(block_list*,va_list), block_list* center, int16 range, int32 type, ...);
@@ -1158,6 +1251,110 @@ int32 map_foreachincell(int32 (*func)(block_list*,va_list), int16 m, int16 x, in
 int32 map_foreachinpath(int32 (*func)(block_list*,va_list), int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int16 range, int32 length, int32 type, ...);
 int32 map_foreachindir(int32 (*func)(block_list*,va_list), int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int16 range, int32 length, int32 offset, int32 type, ...);
 int32 map_foreachinmap(int32 (*func)(block_list*,va_list), int16 m, int32 type, ...);
+// blocklist collection, used by the typed map_foreach* below
+block_list** map_collectinrange(block_list* center, int16 range, int32 type, bool wall_check, int32& count);
+block_list** map_collectinarea(int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type, bool wall_check, int32& count);
+block_list** map_collectinmovearea(block_list* center, int16 range, int16 dx, int16 dy, int32 type, int32& count);
+block_list** map_collectincell(int16 m, int16 x, int16 y, int32 type, int32& count);
+void map_collect_release(block_list** list);
+bool map_skill_wall_check(void);
+
+/// Callable with the signature int32( block_list* ), used by the typed map_foreach* instead of a va_list callback
+template <typename Func>
+using map_foreach_func = std::enable_if_t<std::is_invocable_r_v<int32, Func&, block_list*>, int32>;
+
+/**
+ * Calls func for every collected object that was not removed from the map in the meantime
+ * Objects freed by func are kept valid until the end of the iteration.
+ * @param func: Called with each object, the results are summed up
+ * @param list: Collection from a map_collect* function, released afterwards
+ * @param count: Number of collected objects
+ * @return Sum of the results of func
+ */
+template <typename Func>
+int32 map_foreachcollected(Func& func, block_list** list, int32 count){
+	int32 returnCount = 0;
+	FreeBlockLock freeLock;
+
+	for( int32 i = 0; i < count; i++ ){
+		// func() may delete this list[] slot, checking for prev ensures it wasn't queued for deletion.
+		if( list[i]->prev != nullptr ){
+			returnCount += func( list[i] );
+		}
+	}
+
+	map_collect_release( list );
+	return returnCount;
+}
+
+/*
+ * Typed versions of the map_foreach* functions, func is called directly with each object instead of a va_list.
+ * Arguments are captured by the callable, e.g. a lambda, so the compiler can inline the callback.
+ */
+template <typename Func>
+map_foreach_func<Func> map_foreachinrange(Func&& func, block_list* center, int16 range, int32 type){
+	int32 count;
+	block_list** list = map_collectinrange( center, range, type, map_skill_wall_check(), count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachinallrange(Func&& func, block_list* center, int16 range, int32 type){
+	int32 count;
+	block_list** list = map_collectinrange( center, range, type, false, count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachinshootrange(Func&& func, block_list* center, int16 range, int32 type){
+	int32 count;
+	block_list** list = map_collectinrange( center, range, type, true, count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachinarea(Func&& func, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type){
+	int32 count;
+	block_list** list = map_collectinarea( m, x0, y0, x1, y1, type, map_skill_wall_check(), count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachinallarea(Func&& func, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type){
+	int32 count;
+	block_list** list = map_collectinarea( m, x0, y0, x1, y1, type, false, count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachinshootarea(Func&& func, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 type){
+	int32 count;
+	block_list** list = map_collectinarea( m, x0, y0, x1, y1, type, true, count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachinmovearea(Func&& func, block_list* center, int16 range, int16 dx, int16 dy, int32 type){
+	int32 count;
+	block_list** list = map_collectinmovearea( center, range, dx, dy, type, count );
+
+	return map_foreachcollected( func, list, count );
+}
+
+template <typename Func>
+map_foreach_func<Func> map_foreachincell(Func&& func, int16 m, int16 x, int16 y, int32 type){
+	int32 count;
+	block_list** list = map_collectincell( m, x, y, type, count );
+
+	return map_foreachcollected( func, list, count );
+}
+
 //blocklist nb in one cell
 int32 map_count_oncell(int16 m,int16 x,int16 y,int32 type,int32 flag);
 skill_unit *map_find_skill_unit_oncell(block_list *,int16 x,int16 y,uint16 skill_id,skill_unit *, int32 flag);
@@ -1214,7 +1411,6 @@ void map_deliddb(block_list *bl);
 void map_foreachpc(int32 (*func)(map_session_data* sd, va_list args), ...);
 void map_foreachmob(int32 (*func)(mob_data* md, va_list args), ...);
 void map_foreachnpc(int32 (*func)(npc_data* nd, va_list args), ...);
-void map_foreachregen(int32 (*func)(block_list* bl, va_list args), ...);
 void map_foreachiddb(int32 (*func)(block_list* bl, va_list args), ...);
 map_session_data * map_nick2sd(const char* nick, bool allow_partial);
 mob_data * map_getmob_boss(int16 m);
@@ -1323,6 +1519,19 @@ extern Sql* qsmysql_handle;
 extern Sql* logmysql_handle;
 #endif
 
+extern std::string default_codepage;
+extern std::string log_codepage;
+extern int32 map_server_port;
+extern std::string map_server_ip;
+extern std::string map_server_id;
+extern std::string map_server_pw;
+extern std::string map_server_db;
+extern std::string log_db_ip;
+extern uint16 log_db_port;
+extern std::string log_db_id;
+extern std::string log_db_pw;
+extern std::string log_db_db;
+
 extern char barter_table[32];
 extern char buyingstores_table[32];
 extern char buyingstore_items_table[32];
@@ -190,7 +190,7 @@ void mvptomb_create(mob_data *md, char *killer, time_t time)
 	if ( md->tomb_nid )
 		mvptomb_destroy(md);
 
-	CREATE(nd, npc_data, 1);
+	nd = (npc_data*)map_block_alloc(BL_NPC);
 	new (nd) npc_data();
 
 	nd->id = md->tomb_nid = npc_get_new_npc_id();
@@ -250,7 +250,7 @@ void mvptomb_destroy(mob_data *md) {
 			mapdata->npc[mapdata->npc_num] = nullptr;
 		}
 		map_deliddb(nd);
-		aFree(nd);
+		map_block_free(BL_NPC, nd);
 	}
 
 	md->tomb_nid = 0;
@@ -464,7 +464,7 @@ int32 mob_parse_dataset(struct spawn_data *data)
  *------------------------------------------*/
 mob_data* mob_spawn_dataset(struct spawn_data *data)
 {
-	mob_data *md = (mob_data*)aCalloc(1, sizeof(mob_data));
+	mob_data *md = (mob_data*)map_block_alloc(BL_MOB);
 	new(md) mob_data();
 	md->id= npc_get_new_npc_id();
 	md->type = BL_MOB;
@@ -1169,6 +1169,7 @@ int32 mob_spawn (mob_data *md)
 	}
 
 	memset(&md->state, 0, sizeof(md->state));
+	md->ai_sleep = false;
 	status_calc_mob(md, SCO_FIRST);
 	md->attacked_id = 0;
 	md->norm_attacked_id = 0;
@@ -1311,17 +1312,11 @@ int32 mob_target(mob_data *md,block_list *bl,int32 dist)
 /*==========================================
  * The ?? routine of an active monster
  *------------------------------------------*/
-static int32 mob_ai_sub_hard_activesearch(block_list *bl,va_list ap)
+static int32 mob_ai_sub_hard_activesearch(block_list *bl, mob_data *md, block_list **target, int32 mode)
 {
-	mob_data *md;
-	block_list **target;
-	enum e_mode mode;
 	int32 dist;
 
 	nullpo_ret(bl);
-	md=va_arg(ap,mob_data *);
-	target= va_arg(ap,block_list**);
-	mode= static_cast<enum e_mode>(va_arg(ap, int32));
 
 	//If can't seek yet, not an enemy, or you can't attack it, skip.
 	if ((*target) == bl || !status_check_skilluse(md, bl, 0, 0))
@@ -1838,6 +1833,35 @@ void mob_setstate(mob_data& md, MobSkillState skillstate) {
 /*==========================================
  * AI of MOB whose is near a Player
  *------------------------------------------*/
+/**
+ * Checks if an idle monster keeps sleeping instead of running its AI
+ * Sleeping monsters only look at the block presence counters of their map until something happens:
+ * a possible target or floor item comes in range, they get a target or attacker, start moving,
+ * or their next random walk or skill check is due.
+ * @param md: Monster
+ * @param tick: Current tick
+ * @return true if the monster is sleeping
+ */
+static bool mob_ai_sleeping(mob_data& md, t_tick tick)
+{
+	if (!md.ai_sleep)
+		return false;
+
+	bool has_skills = battle_config.mob_skill_rate && !md.db->skill.empty() && !status_has_mode(&md.status, MD_NOCAST);
+
+	if (md.target_id || md.attacked_id || md.master_id || md.special_state.ai != AI_NONE
+		|| md.ud.walktimer != INVALID_TIMER || md.ud.skilltimer != INVALID_TIMER
+		|| DIFF_TICK(tick, md.next_walktime) >= 0
+		|| (has_skills && DIFF_TICK(tick, md.last_skillcheck) >= MOB_SKILL_INTERVAL)
+		|| map_presence_inrange(md.m, md.x, md.y, md.db->range2, PRESENCE_TARGET)
+		|| (md.lootitems != nullptr && status_has_mode(&md.status, MD_LOOTER) && map_presence_inrange(md.m, md.x, md.y, battle_config.loot_range, PRESENCE_ITEM))) {
+		md.ai_sleep = false;
+		return false;
+	}
+
+	return true;
+}
+
 static bool mob_ai_sub_hard(mob_data *md, t_tick tick)
 {
 	block_list *tbl = nullptr, *abl = nullptr;
@@ -1857,6 +1881,10 @@ static bool mob_ai_sub_hard(mob_data *md, t_tick tick)
 	// This prevents the lazy AI from being executed at the same time
 	md->next_thinktime = tick;
 
+	// Idle monster without anything around, nothing to do
+	if (mob_ai_sleeping(*md, tick))
+		return true;
+
 	if (md->ud.skilltimer != INVALID_TIMER)
 		return false;
 
@@ -2011,7 +2039,8 @@ static bool mob_ai_sub_hard(mob_data *md, t_tick tick)
 	{
 		if (tbl == nullptr) {
 			// Search for items in loot range
-			map_foreachinshootrange(mob_ai_sub_hard_lootsearch, md, battle_config.loot_range, BL_ITEM, md, &tbl);
+			if (map_presence_inrange(md->m, md->x, md->y, battle_config.loot_range, PRESENCE_ITEM))
+				map_foreachinshootrange(mob_ai_sub_hard_lootsearch, md, battle_config.loot_range, BL_ITEM, md, &tbl);
 		}
 		else if (tbl->type == BL_ITEM && battle_config.monster_loot_search_type == 0) {
 			// Looter already has a target item, but we want to check if there is an item that's closer
@@ -2021,10 +2050,14 @@ static bool mob_ai_sub_hard(mob_data *md, t_tick tick)
 		}
 	}
 
+	// Normal monsters only target what is counted in the block presence, skip the scans if there is nothing in range
+	bool search_targets = md->special_state.ai != AI_NONE || map_presence_inrange(md->m, md->x, md->y, view_range, PRESENCE_TARGET);
+
 	if ((mode&MD_AGGRESSIVE && (!tbl || slave_lost_target)) || md->state.skillstate == MSS_FOLLOW)
 	{
 		int32 prev_id = md->target_id;
-		map_foreachinallrange (mob_ai_sub_hard_activesearch, md, view_range, DEFAULT_ENEMY_TYPE(md), md, &tbl, mode);
+		if (search_targets)
+			map_foreachinallrange( [md, &tbl, mode]( block_list* bl ){ return mob_ai_sub_hard_activesearch( bl, md, &tbl, mode ); }, md, view_range, DEFAULT_ENEMY_TYPE(md) );
 		// If a monster finds a new target that is already in attack range it immediately switches to rush mode
 		// This behavior overrides even angry mode and other mode-specific behavior
 		if (tbl != nullptr && prev_id != md->target_id && battle_check_range(md, tbl, md->status.rhw.range)) {
@@ -2037,7 +2070,8 @@ static bool mob_ai_sub_hard(mob_data *md, t_tick tick)
 	{
 		int32 search_size;
 		search_size = view_range<md->status.rhw.range ? view_range:md->status.rhw.range;
-		map_foreachinallrange (mob_ai_sub_hard_changechase, md, search_size, DEFAULT_ENEMY_TYPE(md), md, &tbl);
+		if (search_targets)
+			map_foreachinallrange (mob_ai_sub_hard_changechase, md, search_size, DEFAULT_ENEMY_TYPE(md), md, &tbl);
 	}
 
 	if (!tbl) { //No targets available.
@@ -2066,6 +2100,12 @@ static bool mob_ai_sub_hard(mob_data *md, t_tick tick)
 				md->next_walktime = tick + rnd()%1000;
 		}
 
+		// Sleep until the next random walk or skill check, mob_ai_sleeping wakes it up earlier if needed
+		if (md->special_state.ai == AI_NONE && !md->master_id && !md->bg_id && md->idle_event[0] == '\0'
+			&& md->ud.walktimer == INVALID_TIMER && md->state.skillstate == MSS_IDLE
+			&& !(battle_config.mob_ai&0x8 && battle_config.official_cell_stack_limit > 0))
+			md->ai_sleep = true;
+
 		return true;
 	}
 
@@ -2296,6 +2336,7 @@ void mob_set_attacked_id(int32 src_id, int32 target_id, t_tick tick, bool is_nor
 
 	// As it was attacked, monster leaves aggressive mode
 	md->state.aggressive = 0;
+	md->ai_sleep = false;
 
 	// Need to call mob AI routine immediately, otherwise the attacked ID might get overwritten before it is processed
 	mob_ai_sub_hard(md, tick);
@@ -2329,17 +2370,36 @@ TIMER_FUNC(mob_norm_attacked) {
 	return 0;
 }
 
-static int32 mob_ai_sub_hard_timer(block_list *bl,va_list ap)
+/// Monster of the hard AI work list, sorted by map and block
+struct s_mob_ai_work {
+	uint64 key; ///< Map ID in the upper, block index in the lower 32 bits
+	int32 id;
+};
+
+static std::vector<s_mob_ai_work> mob_ai_worklist;
+static uint32 mob_ai_batch; ///< ID of the current hard AI tick, monsters remember it when queued
+
+/**
+ * Queues a monster near a player for the hard AI of this tick
+ * Every player marks the monster as spotted, but it is only queued once
+ */
+static int32 mob_ai_sub_hard_queue(block_list *bl,va_list ap)
 {
 	mob_data *md = (mob_data*)bl;
 	uint32 char_id = va_arg(ap, uint32);
-	t_tick tick = va_arg(ap, t_tick);
+
 	mob_add_spotted(md, char_id);
-	if (mob_ai_sub_hard(md, tick))
-	{	//Hard AI triggered.
-		md->last_pcneartime = tick;
-	}
-	return 0;
+
+	if (md->ai_batch == mob_ai_batch)
+		return 0;
+
+	md->ai_batch = mob_ai_batch;
+
+	struct map_data *mapdata = map_getmapdata(md->m);
+	uint32 pos = md->x / BLOCK_SIZE + (md->y / BLOCK_SIZE) * mapdata->bxs;
+
+	mob_ai_worklist.push_back({ (static_cast<uint64>(md->m) << 32) | pos, md->id });
+	return 1;
 }
 
 /*==========================================
@@ -2347,12 +2407,40 @@ static int32 mob_ai_sub_hard_timer(block_list *bl,va_list ap)
  *------------------------------------------*/
 static int32 mob_ai_sub_foreachclient(map_session_data *sd,va_list ap)
 {
-	t_tick tick=va_arg(ap,t_tick);
-	map_foreachinallrange(mob_ai_sub_hard_timer,sd, AREA_SIZE+ACTIVE_AI_RANGE, BL_MOB, sd->status.char_id, tick);
+	map_foreachinallrange(mob_ai_sub_hard_queue,sd, AREA_SIZE+ACTIVE_AI_RANGE, BL_MOB, sd->status.char_id);
 
 	return 0;
 }
 
+/**
+ * Runs the hard AI for all monsters near players
+ * The work list is built once per tick, so monsters near several players think only once,
+ * and processed by map and block, so neighbouring monsters and their blocks are handled together.
+ * @param tick: Current tick
+ */
+static void mob_ai_hard_batch(t_tick tick)
+{
+	mob_ai_batch++;
+	mob_ai_worklist.clear();
+
+	map_foreachpc(mob_ai_sub_foreachclient);
+
+	std::sort(mob_ai_worklist.begin(), mob_ai_worklist.end(), [](const s_mob_ai_work& a, const s_mob_ai_work& b){
+		return a.key < b.key;
+	});
+
+	for (const s_mob_ai_work& work : mob_ai_worklist) {
+		// The AI of another monster may have killed or removed this one in the meantime
+		mob_data *md = map_id2md(work.id);
+
+		if (md == nullptr)
+			continue;
+
+		if (mob_ai_sub_hard(md, tick)) // Hard AI triggered.
+			md->last_pcneartime = tick;
+	}
+}
+
 /*==========================================
  * Negligent mode MOB AI (PC is not in near)
  *------------------------------------------*/
@@ -2465,12 +2553,12 @@ static TIMER_FUNC(mob_ai_lazy){
 /*==========================================
  * Serious processing for mob in PC field of view   (interval timer function)
  *------------------------------------------*/
-static TIMER_FUNC(mob_ai_hard){
+TIMER_FUNC(mob_ai_hard){
 
 	if (battle_config.mob_ai&0x20)
 		map_foreachmob(mob_ai_sub_lazy,tick);
 	else
-		map_foreachpc(mob_ai_sub_foreachclient,tick);
+		mob_ai_hard_batch(tick);
 
 	return 0;
 }
@@ -379,6 +379,9 @@ struct mob_data : public block_list {
 	int16 move_fail_count;
 	int16 lootitem_count;
 	unsigned char walktoxy_fail_count; //Pathfinding succeeds but the actual walking failed (e.g. Icewall lock)
+	bool ai_sleep; ///< Idle with nothing to do until its next random walk or skill check, see mob_ai_sleeping
+	bool presence_target; ///< Counted as target in the block presence of its map, see map_addblock
+	uint32 ai_batch; ///< Last hard AI tick the monster was queued in, see mob_ai_hard_batch
 
 	int32 deletetimer;
 	int32 master_id,master_dist;
@@ -522,6 +525,7 @@ int32 mob_randomwalk(mob_data *md,t_tick tick);
 int32 mob_warpchase(mob_data *md, block_list *target);
 void mob_setstate(mob_data& md, MobSkillState skillstate);
 bool mob_ai_sub_hard_attacktimer(mob_data &md, t_tick tick);
+TIMER_FUNC(mob_ai_hard);
 TIMER_FUNC(mob_attacked);
 TIMER_FUNC(mob_norm_attacked);
 int32 mob_target(mob_data *md,block_list *bl,int32 dist);
@@ -10,8 +10,13 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <queue>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include <common/db.hpp>
@@ -46,12 +51,11 @@ struct path_node {
 	int16 g_cost; // Actual cost from start to this node
 	int16 f_cost; // g_cost + heuristic(this, goal)
 	int16 flag; // SET_OPEN / SET_CLOSED
+	uint32 epoch; // Search the node belongs to, see navi_search_context
 };
 
 /// Binary heap of path nodes
 BHEAP_STRUCT_DECL(node_heap, struct path_node*);
-static BHEAP_STRUCT_VAR(node_heap, g_open_set);	// use static heap for all path calculations
-												// it get's initialized in do_init_path, freed in do_final_path.
 
 /// Comparator for binary heap of path nodes (minimum cost at top)
 #define NODE_MINTOPCMP(i,j) ((i)->f_cost - (j)->f_cost)
@@ -101,17 +105,33 @@ static int32 heap_update_node(struct node_heap *heap, struct path_node *node)
 // end 1:1 copy of definitions from path.cpp
 
 
-// So we don't have to allocate every time, use static structures
-static struct path_node tp[MAX_WALKPATH_NAVI * MAX_WALKPATH_NAVI + 1];
-static int32 tpused[MAX_WALKPATH_NAVI * MAX_WALKPATH_NAVI + 1];
+/// State of the A* pathfinding, each thread searching paths needs its own
+struct navi_search_context {
+	std::vector<struct path_node> nodes; // So we don't have to allocate every time
+	uint32 epoch; // nodes of other epochs are unused, so the table does not need to be cleared for each search
+	struct node_heap open_set;
+
+	navi_search_context() : nodes(MAX_WALKPATH_NAVI * MAX_WALKPATH_NAVI + 1), epoch(0) {
+		BHEAP_INIT(open_set);
+		// Reserve room for every node up front, no node is in the heap twice, so the heap never grows
+		// and worker threads never reach the (not thread safe) memory manager
+		BHEAP_ENSURE2(open_set, nodes.size(), 256, struct path_node **);
+	}
+
+	~navi_search_context() {
+		BHEAP_CLEAR(open_set);
+	}
+};
 
 /// Path_node processing in A* pathfinding.
 /// Adds new node to heap and updates/re-adds old ones if necessary.
-static int32 add_path(struct node_heap *heap, int16 x, int16 y, int32 g_cost, struct path_node *parent, int32 h_cost)
+static int32 add_path(struct navi_search_context &ctx, int16 x, int16 y, int32 g_cost, struct path_node *parent, int32 h_cost)
 {
+	struct node_heap *heap = &ctx.open_set;
+	struct path_node *tp = ctx.nodes.data();
 	int32 i = calc_index(x, y);
 
-	if (tpused[i] && tpused[i] == 1 + (x << 16 | y)) { // We processed this node before
+	if (tp[i].epoch == ctx.epoch && tp[i].x == x && tp[i].y == y) { // We processed this node before
 		if (g_cost < tp[i].g_cost) { // New path to this node is better than old one
 									 // Update costs and parent
 			tp[i].g_cost = g_cost;
@@ -128,17 +148,17 @@ static int32 add_path(struct node_heap *heap, int16 x, int16 y, int32 g_cost, st
 		return 0;
 	}
 
-	if (tpused[i]) // Index is already taken; see `tp` array FIXME for details
+	if (tp[i].epoch == ctx.epoch) // Index is already taken; see `tp` array FIXME for details
 		return 1;
 
 	// New node
+	tp[i].epoch = ctx.epoch;
 	tp[i].x = x;
 	tp[i].y = y;
 	tp[i].g_cost = g_cost;
 	tp[i].parent = parent;
 	tp[i].f_cost = g_cost + h_cost;
 	tp[i].flag = SET_OPEN;
-	tpused[i] = 1 + (x << 16 | y);
 	heap_push_node(heap, &tp[i]);
 	return 0;
 }
@@ -149,10 +169,11 @@ static int32 add_path(struct node_heap *heap, int16 x, int16 y, int32 g_cost, st
  * wpd: path info will be written here
  * cell: type of obstruction to check for
  *
- * Note: uses global g_open_set, therefore this method can't be called in parallel or recursivly.
+ * ctx: search state, a context can't be used in parallel or recursivly.
  *------------------------------------------*/
-bool navi_path_search(struct navi_walkpath_data *wpd, const struct navi_pos *from, const struct navi_pos *dest, cell_chk cell) {
+bool navi_path_search(struct navi_search_context &ctx, struct navi_walkpath_data *wpd, const struct navi_pos *from, const struct navi_pos *dest, cell_chk cell) {
 	int32 i, x, y, dx = 0, dy = 0;
+	struct path_node *tp = ctx.nodes.data();
 	struct map_data *mapdata = map_getmapdata(from->m);
 	struct navi_walkpath_data s_wpd;
 
@@ -170,7 +191,7 @@ bool navi_path_search(struct navi_walkpath_data *wpd, const struct navi_pos *fro
 		return false;
 
 	// Check destination cell
-	if (dest->x < 0 || dest->x > mapdata->xs || dest->y < 0 || dest->y > mapdata->ys || map_getcellp(mapdata, dest->x, dest->y, cell))
+	if (dest->x < 0 || dest->x > mapdata->xs || dest->y < 0 || dest->y > mapdata->ys || map_getcellbits(mapdata, dest->x, dest->y, cell))
 		return false;
 
 
@@ -189,21 +210,25 @@ bool navi_path_search(struct navi_walkpath_data *wpd, const struct navi_pos *fro
 	// A* (A-star) pathfinding
 	// We always use A* for finding walkpaths because it is what game client uses.
 	// Easy pathfinding cuts corners of non-walkable cells, but client always walks around it.
-	BHEAP_RESET(g_open_set);
+	BHEAP_RESET(ctx.open_set);
 
-	memset(tpused, 0, sizeof(tpused));
+	// Start a new epoch, all nodes of previous searches become unused
+	if (++ctx.epoch == 0) {
+		std::fill(ctx.nodes.begin(), ctx.nodes.end(), path_node{});
+		ctx.epoch = 1;
+	}
 
 	// Start node
 	i = calc_index(from->x, from->y);
+	tp[i].epoch = ctx.epoch;
 	tp[i].parent = nullptr;
 	tp[i].x = from->x;
 	tp[i].y = from->y;
 	tp[i].g_cost = 0;
 	tp[i].f_cost = heuristic(from->x, from->y, dest->x, dest->y);
 	tp[i].flag = SET_OPEN;
-	tpused[i] = 1 + (from->x << 16 | from->y);
 
-	heap_push_node(&g_open_set, &tp[i]); // Put start node to 'open' set
+	heap_push_node(&ctx.open_set, &tp[i]); // Put start node to 'open' set
 	
 	for (;;) {
 		int32 e = 0; // error flag
@@ -218,12 +243,12 @@ bool navi_path_search(struct navi_walkpath_data *wpd, const struct navi_pos *fro
 
 		int32 g_cost;
 
-		if (BHEAP_LENGTH(g_open_set) == 0) {
+		if (BHEAP_LENGTH(ctx.open_set) == 0) {
 			return false;
 		}
 
-		current = BHEAP_PEEK(g_open_set); // Look for the lowest f_cost node in the 'open' set
-		BHEAP_POP2(g_open_set, NODE_MINTOPCMP); // Remove it from 'open' set
+		current = BHEAP_PEEK(ctx.open_set); // Look for the lowest f_cost node in the 'open' set
+		BHEAP_POP2(ctx.open_set, NODE_MINTOPCMP); // Remove it from 'open' set
 
 		x = current->x;
 		y = current->y;
@@ -235,29 +260,29 @@ bool navi_path_search(struct navi_walkpath_data *wpd, const struct navi_pos *fro
 			break;
 		}
 
-		if (y < ys && !map_getcellp(mapdata, x, y+1, cell)) allowed_dirs |= PATH_DIR_NORTH;
-		if (y >  0 && !map_getcellp(mapdata, x, y-1, cell)) allowed_dirs |= PATH_DIR_SOUTH;
-		if (x < xs && !map_getcellp(mapdata, x+1, y, cell)) allowed_dirs |= PATH_DIR_EAST;
-		if (x >  0 && !map_getcellp(mapdata, x-1, y, cell)) allowed_dirs |= PATH_DIR_WEST;
+		if (y < ys && !map_getcellbits(mapdata, x, y+1, cell)) allowed_dirs |= PATH_DIR_NORTH;
+		if (y >  0 && !map_getcellbits(mapdata, x, y-1, cell)) allowed_dirs |= PATH_DIR_SOUTH;
+		if (x < xs && !map_getcellbits(mapdata, x+1, y, cell)) allowed_dirs |= PATH_DIR_EAST;
+		if (x >  0 && !map_getcellbits(mapdata, x-1, y, cell)) allowed_dirs |= PATH_DIR_WEST;
 
 #define chk_dir(d) ((allowed_dirs & (d)) == (d))
 		// Process neighbors of current node
-		if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_EAST) && !map_getcellp(mapdata, x+1, y-1, cell))
-			e += add_path(&g_open_set, x+1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y-1, dest->x, dest->y)); // (x+1, y-1) 5
+		if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_EAST) && !map_getcellbits(mapdata, x+1, y-1, cell))
+			e += add_path(ctx, x+1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y-1, dest->x, dest->y)); // (x+1, y-1) 5
 		if (chk_dir(PATH_DIR_EAST))
-			e += add_path(&g_open_set, x+1, y, g_cost + MOVE_COST, current, heuristic(x+1, y, dest->x, dest->y)); // (x+1, y) 6
-		if (chk_dir(PATH_DIR_NORTH|PATH_DIR_EAST) && !map_getcellp(mapdata, x+1, y+1, cell))
-			e += add_path(&g_open_set, x+1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y+1, dest->x, dest->y)); // (x+1, y+1) 7
+			e += add_path(ctx, x+1, y, g_cost + MOVE_COST, current, heuristic(x+1, y, dest->x, dest->y)); // (x+1, y) 6
+		if (chk_dir(PATH_DIR_NORTH|PATH_DIR_EAST) && !map_getcellbits(mapdata, x+1, y+1, cell))
+			e += add_path(ctx, x+1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y+1, dest->x, dest->y)); // (x+1, y+1) 7
 		if (chk_dir(PATH_DIR_NORTH))
-			e += add_path(&g_open_set, x, y+1, g_cost + MOVE_COST, current, heuristic(x, y+1, dest->x, dest->y)); // (x, y+1) 0
-		if (chk_dir(PATH_DIR_NORTH|PATH_DIR_WEST) && !map_getcellp(mapdata, x-1, y+1, cell))
-			e += add_path(&g_open_set, x-1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y+1, dest->x, dest->y)); // (x-1, y+1) 1
+			e += add_path(ctx, x, y+1, g_cost + MOVE_COST, current, heuristic(x, y+1, dest->x, dest->y)); // (x, y+1) 0
+		if (chk_dir(PATH_DIR_NORTH|PATH_DIR_WEST) && !map_getcellbits(mapdata, x-1, y+1, cell))
+			e += add_path(ctx, x-1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y+1, dest->x, dest->y)); // (x-1, y+1) 1
 		if (chk_dir(PATH_DIR_WEST))
-			e += add_path(&g_open_set, x-1, y, g_cost + MOVE_COST, current, heuristic(x-1, y, dest->x, dest->y)); // (x-1, y) 2
-		if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_WEST) && !map_getcellp(mapdata, x-1, y-1, cell))
-			e += add_path(&g_open_set, x-1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y-1, dest->x, dest->y)); // (x-1, y-1) 3
+			e += add_path(ctx, x-1, y, g_cost + MOVE_COST, current, heuristic(x-1, y, dest->x, dest->y)); // (x-1, y) 2
+		if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_WEST) && !map_getcellbits(mapdata, x-1, y-1, cell))
+			e += add_path(ctx, x-1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y-1, dest->x, dest->y)); // (x-1, y-1) 3
 		if (chk_dir(PATH_DIR_SOUTH))
-			e += add_path(&g_open_set, x, y-1, g_cost + MOVE_COST, current, heuristic(x, y-1, dest->x, dest->y)); // (x, y-1) 4
+			e += add_path(ctx, x, y-1, g_cost + MOVE_COST, current, heuristic(x, y-1, dest->x, dest->y)); // (x, y-1) 4
 #undef chk_dir
 		if (e) {
 			return false;
@@ -282,6 +307,389 @@ bool navi_path_search(struct navi_walkpath_data *wpd, const struct navi_pos *fro
 	return true;
 }
 
+/// @name Hierarchical pathfinding (HPA*) for long distances
+/// The map is split into clusters. Entrances on the cluster borders form an abstract graph, whose edges
+/// hold the cost of the best path inside a cluster, so long searches only visit a few entrances per cluster.
+/// @{
+
+#define NAVI_THREADS_MAX 16 // Upper limit of worker threads, each one needs its own search context (about 32 MB)
+#define NAVI_CLUSTER_SIZE 16 // Width and height of a cluster in cells
+#define NAVI_ENTRANCE_SPLIT 6 // Border openings longer than this get an entrance at both ends instead of one in the middle
+
+struct navi_edge {
+	int32 to; // Target node
+	int32 cost; // Path cost, in MOVE_COST units
+	int32 steps; // Path length in cells
+};
+
+struct navi_abstract_node {
+	int16 x, y;
+	int32 cluster;
+	std::vector<struct navi_edge> edges;
+};
+
+struct navi_cluster_graph {
+	int32 cw, ch; // Clusters per row and column
+	std::vector<struct navi_abstract_node> nodes;
+	std::vector<std::vector<int32>> cluster_nodes; // Nodes of each cluster
+};
+
+static std::vector<std::unique_ptr<struct navi_search_context>> navi_contexts; // Search context of each worker thread, the first one is also used by the main thread
+static std::vector<std::unique_ptr<struct navi_cluster_graph>> navi_graphs; // Cluster graph of each map, see navi_build_graphs
+
+/// Whether a cell cannot be entered, same as the checks of navi_path_search with CELL_CHKNOREACH
+static inline bool navi_blocked(struct map_data *mapdata, int32 x, int32 y) {
+	return x < 0 || y < 0 || x >= mapdata->xs || y >= mapdata->ys || map_getcellbits(mapdata, x, y, CELL_CHKNOREACH);
+}
+
+/**
+ * Finds the best paths from a cell to all cells of its cluster, without leaving the cluster
+ * Uses the same movement rules as navi_path_search.
+ * @param mapdata: Map
+ * @param cluster: Cluster of the cell
+ * @param graph: Cluster graph of the map
+ * @param x: Start X
+ * @param y: Start Y
+ * @param cost: Filled with the cost to each cell of the cluster (local index), INT32_MAX if unreachable
+ * @param steps: Filled with the path length to each cell of the cluster (local index)
+ */
+static void navi_cluster_search(struct map_data *mapdata, int32 cluster, const struct navi_cluster_graph &graph, int16 x, int16 y, std::vector<int32> &cost, std::vector<int32> &steps) {
+	int32 x0 = (cluster % graph.cw) * NAVI_CLUSTER_SIZE;
+	int32 y0 = (cluster / graph.cw) * NAVI_CLUSTER_SIZE;
+	int32 x1 = std::min<int32>(x0 + NAVI_CLUSTER_SIZE, mapdata->xs) - 1;
+	int32 y1 = std::min<int32>(y0 + NAVI_CLUSTER_SIZE, mapdata->ys) - 1;
+	std::priority_queue<std::pair<int32, int32>, std::vector<std::pair<int32, int32>>, std::greater<std::pair<int32, int32>>> open;
+
+	cost.assign(NAVI_CLUSTER_SIZE * NAVI_CLUSTER_SIZE, INT32_MAX);
+	steps.assign(NAVI_CLUSTER_SIZE * NAVI_CLUSTER_SIZE, 0);
+
+	cost[(x - x0) + (y - y0) * NAVI_CLUSTER_SIZE] = 0;
+	open.push({ 0, (x - x0) + (y - y0) * NAVI_CLUSTER_SIZE });
+
+	while (!open.empty()) {
+		auto [c, i] = open.top();
+		open.pop();
+
+		if (c > cost[i])
+			continue; // Outdated entry
+
+		int32 cx = x0 + i % NAVI_CLUSTER_SIZE;
+		int32 cy = y0 + i / NAVI_CLUSTER_SIZE;
+		int32 allowed_dirs = 0;
+
+		if (cy < y1 && !navi_blocked(mapdata, cx, cy+1)) allowed_dirs |= PATH_DIR_NORTH;
+		if (cy > y0 && !navi_blocked(mapdata, cx, cy-1)) allowed_dirs |= PATH_DIR_SOUTH;
+		if (cx < x1 && !navi_blocked(mapdata, cx+1, cy)) allowed_dirs |= PATH_DIR_EAST;
+		if (cx > x0 && !navi_blocked(mapdata, cx-1, cy)) allowed_dirs |= PATH_DIR_WEST;
+
+		for (int32 dir = 0; dir < 8; dir++) {
+			static const int8 dirx[8] = { 1, 1, 1, 0, -1, -1, -1, 0 };
+			static const int8 diry[8] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+			int32 nx = cx + dirx[dir], ny = cy + diry[dir];
+			int32 needed = (dirx[dir] > 0 ? PATH_DIR_EAST : dirx[dir] < 0 ? PATH_DIR_WEST : 0) | (diry[dir] > 0 ? PATH_DIR_NORTH : diry[dir] < 0 ? PATH_DIR_SOUTH : 0);
+			bool diagonal = dirx[dir] != 0 && diry[dir] != 0;
+
+			if ((allowed_dirs & needed) != needed || (diagonal && navi_blocked(mapdata, nx, ny)))
+				continue;
+
+			int32 ni = (nx - x0) + (ny - y0) * NAVI_CLUSTER_SIZE;
+			int32 nc = c + (diagonal ? MOVE_DIAGONAL_COST : MOVE_COST);
+
+			if (nc < cost[ni]) {
+				cost[ni] = nc;
+				steps[ni] = steps[i] + 1;
+				open.push({ nc, ni });
+			}
+		}
+	}
+}
+
+/**
+ * Builds the cluster graph of a map
+ * @param m: Map ID
+ * @return Cluster graph
+ */
+static std::unique_ptr<struct navi_cluster_graph> navi_graph_build(int32 m) {
+	struct map_data *mapdata = map_getmapdata(m);
+	std::unique_ptr<struct navi_cluster_graph> graph = std::make_unique<struct navi_cluster_graph>();
+
+	graph->cw = (mapdata->xs + NAVI_CLUSTER_SIZE - 1) / NAVI_CLUSTER_SIZE;
+	graph->ch = (mapdata->ys + NAVI_CLUSTER_SIZE - 1) / NAVI_CLUSTER_SIZE;
+	graph->cluster_nodes.resize(graph->cw * graph->ch);
+
+	auto node_at = [&graph](int16 x, int16 y) -> int32 {
+		int32 cluster = (x / NAVI_CLUSTER_SIZE) + (y / NAVI_CLUSTER_SIZE) * graph->cw;
+
+		for (int32 id : graph->cluster_nodes[cluster]) {
+			if (graph->nodes[id].x == x && graph->nodes[id].y == y)
+				return id;
+		}
+
+		graph->nodes.push_back({ x, y, cluster, {} });
+		graph->cluster_nodes[cluster].push_back(static_cast<int32>(graph->nodes.size() - 1));
+		return static_cast<int32>(graph->nodes.size() - 1);
+	};
+
+	auto add_entrance = [&graph, &node_at](int16 xa, int16 ya, int16 xb, int16 yb) {
+		int32 a = node_at(xa, ya), b = node_at(xb, yb);
+
+		graph->nodes[a].edges.push_back({ b, MOVE_COST, 1 });
+		graph->nodes[b].edges.push_back({ a, MOVE_COST, 1 });
+	};
+
+	// Entrances between horizontally (vertical = false) and vertically adjacent clusters,
+	// one per opening of the border or two for long openings
+	for (int32 vertical = 0; vertical < 2; vertical++) {
+		int32 border_count = vertical ? graph->ch - 1 : graph->cw - 1;
+		int32 length = vertical ? mapdata->xs : mapdata->ys;
+
+		for (int32 b = 0; b < border_count; b++) {
+			int32 edge = (b + 1) * NAVI_CLUSTER_SIZE - 1; // Last line of the first cluster
+
+			for (int32 start = 0; start < length; ) {
+				auto open_at = [&](int32 pos) {
+					if (pos >= length || (pos % NAVI_CLUSTER_SIZE == 0 && pos != start))
+						return false; // Openings end at cluster corners
+					return vertical ? !navi_blocked(mapdata, pos, edge) && !navi_blocked(mapdata, pos, edge + 1)
+						: !navi_blocked(mapdata, edge, pos) && !navi_blocked(mapdata, edge + 1, pos);
+				};
+
+				if (!open_at(start)) {
+					start++;
+					continue;
+				}
+
+				int32 end = start;
+
+				while (open_at(end + 1))
+					end++;
+
+				std::vector<int32> positions;
+
+				if (end - start + 1 > NAVI_ENTRANCE_SPLIT)
+					positions = { start, end };
+				else
+					positions = { (start + end) / 2 };
+
+				for (int32 pos : positions) {
+					if (vertical)
+						add_entrance(pos, edge, pos, edge + 1);
+					else
+						add_entrance(edge, pos, edge + 1, pos);
+				}
+
+				start = end + 1;
+			}
+		}
+	}
+
+	// Paths between the entrances of each cluster
+	std::vector<int32> cost, steps;
+
+	for (int32 cluster = 0; cluster < static_cast<int32>(graph->cluster_nodes.size()); cluster++) {
+		const std::vector<int32> &ids = graph->cluster_nodes[cluster];
+		int32 x0 = (cluster % graph->cw) * NAVI_CLUSTER_SIZE;
+		int32 y0 = (cluster / graph->cw) * NAVI_CLUSTER_SIZE;
+
+		for (int32 from : ids) {
+			navi_cluster_search(mapdata, cluster, *graph, graph->nodes[from].x, graph->nodes[from].y, cost, steps);
+
+			for (int32 to : ids) {
+				int32 i = (graph->nodes[to].x - x0) + (graph->nodes[to].y - y0) * NAVI_CLUSTER_SIZE;
+
+				if (to != from && cost[i] != INT32_MAX)
+					graph->nodes[from].edges.push_back({ to, cost[i], steps[i] });
+			}
+		}
+	}
+
+	return graph;
+}
+
+/**
+ * HPA* search (from)->(dest) over the cluster graph, only the path length is computed
+ * The result is close to, but not always the same as the best grid path.
+ * @param from: Start position
+ * @param dest: Destination position, on the same map
+ * @param steps: Filled with the path length in cells
+ * @return true if a path was found
+ */
+static bool navi_hpa_search(const struct navi_pos *from, const struct navi_pos *dest, int32 &steps) {
+	struct map_data *mapdata = map_getmapdata(from->m);
+	const struct navi_cluster_graph &graph = *navi_graphs[from->m];
+	int32 start_cluster = (from->x / NAVI_CLUSTER_SIZE) + (from->y / NAVI_CLUSTER_SIZE) * graph.cw;
+	int32 goal_cluster = (dest->x / NAVI_CLUSTER_SIZE) + (dest->y / NAVI_CLUSTER_SIZE) * graph.cw;
+	int32 count = static_cast<int32>(graph.nodes.size());
+	int32 start = count, goal = count + 1; // Temporary nodes for the positions
+	std::vector<int32> cost, local_steps;
+	std::vector<struct navi_edge> start_edges, goal_edges(count, { goal, INT32_MAX, 0 });
+
+	// Connect the positions to the entrances of their clusters
+	navi_cluster_search(mapdata, start_cluster, graph, from->x, from->y, cost, local_steps);
+	for (int32 id : graph.cluster_nodes[start_cluster]) {
+		int32 i = (graph.nodes[id].x % NAVI_CLUSTER_SIZE) + (graph.nodes[id].y % NAVI_CLUSTER_SIZE) * NAVI_CLUSTER_SIZE;
+
+		if (cost[i] != INT32_MAX)
+			start_edges.push_back({ id, cost[i], local_steps[i] });
+	}
+
+	// Moves are symmetric, so the paths from the destination are the reversed paths to it
+	navi_cluster_search(mapdata, goal_cluster, graph, dest->x, dest->y, cost, local_steps);
+	for (int32 id : graph.cluster_nodes[goal_cluster]) {
+		int32 i = (graph.nodes[id].x % NAVI_CLUSTER_SIZE) + (graph.nodes[id].y % NAVI_CLUSTER_SIZE) * NAVI_CLUSTER_SIZE;
+
+		if (cost[i] != INT32_MAX)
+			goal_edges[id] = { goal, cost[i], local_steps[i] };
+	}
+
+	// Octile distance, never overestimates the cost
+	auto heuristic_to_goal = [dest](int32 x, int32 y) {
+		int32 dx = abs(x - dest->x), dy = abs(y - dest->y);
+
+		return MOVE_COST * std::max(dx, dy) + (MOVE_DIAGONAL_COST - MOVE_COST) * std::min(dx, dy);
+	};
+
+	std::vector<int32> g_cost(count + 2, INT32_MAX), g_steps(count + 2, 0);
+	std::priority_queue<std::pair<int32, int32>, std::vector<std::pair<int32, int32>>, std::greater<std::pair<int32, int32>>> open;
+
+	g_cost[start] = 0;
+	open.push({ heuristic_to_goal(from->x, from->y), start });
+
+	while (!open.empty()) {
+		int32 current = open.top().second;
+		int32 f_cost = open.top().first;
+		open.pop();
+
+		if (current == goal) {
+			steps = g_steps[goal];
+			return true;
+		}
+
+		int32 cx = current == start ? from->x : graph.nodes[current].x;
+		int32 cy = current == start ? from->y : graph.nodes[current].y;
+
+		if (f_cost > g_cost[current] + heuristic_to_goal(cx, cy))
+			continue; // Outdated entry
+
+		auto relax = [&](const struct navi_edge &edge) {
+			int32 nc = g_cost[current] + edge.cost;
+
+			if (nc >= g_cost[edge.to])
+				return;
+
+			g_cost[edge.to] = nc;
+			g_steps[edge.to] = g_steps[current] + edge.steps;
+
+			if (edge.to == goal)
+				open.push({ nc, goal });
+			else
+				open.push({ nc + heuristic_to_goal(graph.nodes[edge.to].x, graph.nodes[edge.to].y), edge.to });
+		};
+
+		if (current == start) {
+			for (const struct navi_edge &edge : start_edges)
+				relax(edge);
+			continue;
+		}
+
+		for (const struct navi_edge &edge : graph.nodes[current].edges)
+			relax(edge);
+
+		if (goal_edges[current].cost != INT32_MAX)
+			relax(goal_edges[current]);
+	}
+
+	return false;
+}
+/// @}
+
+/**
+ * Computes the walking distance (from)->(dest)
+ * Long distances are searched on the cluster graph, short ones with navi_path_search.
+ * @param ctx: Search state for the grid search
+ * @param from: Start position
+ * @param dest: Destination position
+ * @param cell: Type of obstruction to check for
+ * @param steps: Filled with the path length in cells
+ * @return true if a path of at most MAX_WALKPATH_NAVI cells was found
+ */
+static bool navi_path_distance(struct navi_search_context &ctx, const struct navi_pos *from, const struct navi_pos *dest, cell_chk cell, int32 &steps) {
+	if (cell == CELL_CHKNOREACH && from->m == dest->m
+		&& std::max(abs(from->x - dest->x), abs(from->y - dest->y)) > 2 * NAVI_CLUSTER_SIZE) {
+		struct map_data *mapdata = map_getmapdata(from->m);
+
+		if (mapdata->cell == nullptr || navi_blocked(mapdata, dest->x, dest->y)
+			|| from->x < 0 || from->x >= mapdata->xs || from->y < 0 || from->y >= mapdata->ys)
+			return false;
+
+		// Falls back to the grid search if the graph misses a path, for example one that crosses clusters diagonally at a corner
+		if (navi_graphs[from->m] != nullptr && navi_hpa_search(from, dest, steps))
+			return steps <= MAX_WALKPATH_NAVI;
+	}
+
+	struct navi_walkpath_data wpd = {0};
+
+	if (!navi_path_search(ctx, &wpd, from, dest, cell))
+		return false;
+
+	steps = wpd.path_len;
+	return true;
+}
+
+/**
+ * Creates the search contexts of the worker threads, shared by all passes
+ * They allocate through the memory manager, so they are created and freed on the main thread.
+ */
+static void navi_contexts_create() {
+	size_t count = std::min<size_t>({ std::max<size_t>(std::thread::hardware_concurrency(), 1), NAVI_THREADS_MAX, static_cast<size_t>(std::max(map_num, 1)) });
+
+	navi_contexts.clear();
+
+	for (size_t i = 0; i < count; i++)
+		navi_contexts.push_back(std::make_unique<struct navi_search_context>());
+}
+
+/**
+ * Runs a task for every map on a pool of worker threads
+ * Tasks may only read the map data, every worker has its own search context.
+ * @param task: Called with the search context of the worker and the map id
+ */
+static void navi_parallel_maps(const std::function<void(struct navi_search_context &, int32)> &task) {
+	size_t count = std::min<size_t>(navi_contexts.size(), map_num);
+	std::vector<std::thread> workers;
+	std::atomic<int32> next(0);
+
+	// Not worth a thread
+	if (count <= 1) {
+		for (int32 m = 0; m < map_num; m++)
+			task(*navi_contexts[0], m);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		workers.emplace_back([&task, &next, &ctx = *navi_contexts[i]]() {
+			for (int32 m = next++; m < map_num; m = next++)
+				task(ctx, m);
+		});
+	}
+
+	for (std::thread &worker : workers)
+		worker.join();
+}
+
+/**
+ * Builds the cluster graphs of all maps
+ */
+static void navi_build_graphs() {
+	navi_graphs.clear();
+	navi_graphs.resize(map_num);
+
+	navi_parallel_maps([](struct navi_search_context &, int32 m) {
+		if (map_getmapdata(m)->cell != nullptr)
+			navi_graphs[m] = navi_graph_build(m);
+	});
+}
+
 bool fileExists(const std::string& path) {
 	std::ifstream in;
 	in.open(path);
@@ -322,7 +730,7 @@ int32 map_type(const struct map_data * m) {
 	if (std::find_if(m->navi.warps_outof.begin(), m->navi.warps_outof.end(), [&m](const navi_link* link) {
 		return std::find_if(m->navi.warps_outof.begin(), m->navi.warps_outof.end(), [&link](const navi_link* link2) {
 			// find if any two warps in a map cannot be reached
-			return !navi_path_search(nullptr, &link->pos, &link2->pos, CELL_CHKNOREACH);
+			return !navi_path_search(*navi_contexts[0], nullptr, &link->pos, &link2->pos, CELL_CHKNOREACH);
 		}) != m->navi.warps_into.end();
 	}) != m->navi.warps_into.end())
 		segmented = true;
@@ -524,19 +932,19 @@ void write_map_header(std::ostream &os, const struct map_data * m) {
 		For every warp into the map (warp)
 			Find a path from nd to warp
 */
-void write_npc_distance(std::ostream &os, const npc_data * nd, const struct map_data * msrc) {
+void write_npc_distance(struct navi_search_context &ctx, std::ostream &os, const npc_data * nd, const struct map_data * msrc) {
 	os << "\t\t{ " << nd->navi.id << ", -- (" << nd->name << " " << msrc->name << ", " << nd->navi.pos.x << ", " << nd->navi.pos.y << ")\n";
 	for (const auto warp : msrc->navi.warps_into) {
-		struct navi_walkpath_data wpd = {0};
+		int32 steps;
 		auto mdest = map_getmapdata(warp->pos.m);
 
 		// Find a path from the npc to the warp destination
 		// The warp is into the map, so this makes sense
-		if (!navi_path_search(&wpd, &nd->navi.pos, &warp->warp_dest, CELL_CHKNOREACH)) {
+		if (!navi_path_distance(ctx, &nd->navi.pos, &warp->warp_dest, CELL_CHKNOREACH, steps)) {
 			continue;
 		}
 
-		os << "\t\t\t{ \"" << mdest->name << "\", " << warp->id << ", " << std::to_string(wpd.path_len) << "}, -- (" << msrc->name << ", " << warp->pos.x << ", " << warp->pos.y << ")\n";
+		os << "\t\t\t{ \"" << mdest->name << "\", " << warp->id << ", " << std::to_string(steps) << "}, -- (" << msrc->name << ", " << warp->pos.x << ", " << warp->pos.y << ")\n";
 	}
 	os << "\t\t\t{\"\", 0, 0}\n";
 	os << "\t\t},\n";
@@ -544,28 +952,35 @@ void write_npc_distance(std::ostream &os, const npc_data * nd, const struct map_
 
 void write_npc_distances() {
 	auto dist_npc_file = std::ofstream(filePrefix + "./navi_npcdistance_krpri.lub");
+	std::vector<std::string> tables(map_num);
 
 	write_header(dist_npc_file, "Navi_NpcDistance");
 
-	for (int32 mapid = 0; mapid < map_num; mapid++) {
+	// Every map is searched on its own, the tables are written in map order afterwards
+	navi_parallel_maps([&tables](struct navi_search_context &ctx, int32 mapid) {
 		auto m = map_getmapdata(mapid);
-#ifdef DETAILED_LOADING_OUTPUT
-		ShowStatus("Loading [%i/%i]" CL_CLL "\r", mapid, map_num);
-#endif
+
 		if (m->navi.npcs.size() == 0) {
 			// ShowStatus("Skipped %s NPC distance table, no NPCs in map (%d/%d)\n", map[m].name, m, map_num);
-			continue;
+			return;
 		}
 		if (m->navi.warps_into.size() == 0) {
 			// ShowStatus("Skipped %s NPC distance table, no warps into map (%d/%d)\n", map[m].name, m, map_num);
-			continue;
+			return;
 		}
 
-		write_map_header(dist_npc_file, m);
+		std::ostringstream os;
+
+		write_map_header(os, m);
 		for (auto nd : m->navi.npcs) {
-			write_npc_distance(dist_npc_file, nd, m);
+			write_npc_distance(ctx, os, nd, m);
 		}
-		dist_npc_file << "\t},\n";
+		os << "\t},\n";
+		tables[mapid] = os.str();
+	});
+
+	for (const std::string &table : tables) {
+		dist_npc_file << table;
 	}
 
 	ShowStatus("Generated NPC Distances for %d maps\n", map_num);
@@ -589,7 +1004,7 @@ void write_mapdist_header(std::ostream &os, const struct map_data * m) {
 			find a path from warp1->dest to warp3->src
 			Add this as an "E" Warp
  */
-void write_map_distance(std::ostream &os, const struct navi_link * warp1, const struct map_data * m) {
+void write_map_distance(struct navi_search_context &ctx, std::ostream &os, const struct navi_link * warp1, const struct map_data * m) {
 	os << "\t\t{ " << warp1->id << ", -- (" << " " << m->name << ", " << warp1->pos.x << ", " << warp1->pos.y << ")\n";
 	// for (const auto warp2 : m->navi.warps_outof) {
 	// 	struct navi_walkpath_data wpd = {0};
@@ -601,12 +1016,12 @@ void write_map_distance(std::ostream &os, const struct navi_link * warp1, const
 	// }
 
 	for (const auto warp3 : map_getmapdata(warp1->warp_dest.m)->navi.warps_outof) {
-		struct navi_walkpath_data wpd = {0};
+		int32 steps;
 
-		if (!navi_path_search(&wpd, &warp1->warp_dest, &warp3->pos, CELL_CHKNOREACH))
+		if (!navi_path_distance(ctx, &warp1->warp_dest, &warp3->pos, CELL_CHKNOREACH, steps))
 			continue;
 		
-		os << "\t\t\t{ \"E\", " << warp3->id << ", " << std::to_string(wpd.path_len) << "}, -- ReachableFromDst warp (" << map_getmapdata(warp3->pos.m)->name << ", " << warp3->pos.x << ", " << warp3->pos.y << ")\n";
+		os << "\t\t\t{ \"E\", " << warp3->id << ", " << std::to_string(steps) << "}, -- ReachableFromDst warp (" << map_getmapdata(warp3->pos.m)->name << ", " << warp3->pos.x << ", " << warp3->pos.y << ")\n";
 	}
 
 	os << "\t\t\t{\"NULL\", 0, 0}\n";
@@ -615,23 +1030,121 @@ void write_map_distance(std::ostream &os, const struct navi_link * warp1, const
 
 void write_map_distances() {
 	auto dist_map_file = std::ofstream(filePrefix + "./navi_linkdistance_krpri.lub");
+	std::vector<std::string> tables(map_num);
+
 	write_header(dist_map_file, "Navi_Distance");
 
-	for (int32 mapid = 0; mapid < map_num; mapid++) {
+	navi_parallel_maps([&tables](struct navi_search_context &ctx, int32 mapid) {
 		const struct map_data * m = map_getmapdata(mapid);
-		write_mapdist_header(dist_map_file, m);
+		std::ostringstream os;
+
+		write_mapdist_header(os, m);
 		for (auto nd : m->navi.warps_outof) {
-			write_map_distance(dist_map_file, nd, m);
+			write_map_distance(ctx, os, nd, m);
 		}
-		dist_map_file << "\t},\n";
+		os << "\t},\n";
+		tables[mapid] = os.str();
+	});
+
+	for (const std::string &table : tables) {
+		dist_map_file << table;
 	}
+
 	ShowStatus("Generated Map Distances for %d maps\n", map_num);
 	write_footer(dist_map_file);
 }
+/**
+ * Compares the distances searched on the cluster graphs with the distances of the grid search
+ * Uses the pairs of the NPC and link distance tables that navi_path_distance searches on the graph.
+ */
+static void navi_compare_distances() {
+	std::vector<std::pair<const struct navi_pos *, const struct navi_pos *>> pairs;
+
+	for (int32 mapid = 0; mapid < map_num; mapid++) {
+		const struct map_data *m = map_getmapdata(mapid);
 
+		for (auto nd : m->navi.npcs) {
+			for (const auto warp : m->navi.warps_into)
+				pairs.push_back({ &nd->navi.pos, &warp->warp_dest });
+		}
+
+		for (const auto warp1 : m->navi.warps_outof) {
+			for (const auto warp3 : map_getmapdata(warp1->warp_dest.m)->navi.warps_outof)
+				pairs.push_back({ &warp1->warp_dest, &warp3->pos });
+		}
+	}
 
-void navi_create_lists() {
-	BHEAP_INIT(g_open_set);
+	// Same conditions as navi_path_distance
+	pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [](const std::pair<const struct navi_pos *, const struct navi_pos *> &pair) {
+		const struct navi_pos *from = pair.first, *dest = pair.second;
+		struct map_data *mapdata = map_getmapdata(from->m);
+
+		return from->m != dest->m || std::max(abs(from->x - dest->x), abs(from->y - dest->y)) <= 2 * NAVI_CLUSTER_SIZE
+			|| navi_graphs[from->m] == nullptr || navi_blocked(mapdata, dest->x, dest->y)
+			|| from->x < 0 || from->x >= mapdata->xs || from->y < 0 || from->y >= mapdata->ys;
+	}), pairs.end());
+
+	std::vector<int32> hpa_steps(pairs.size(), -1), grid_steps(pairs.size(), -1);
+	struct navi_search_context &ctx = *navi_contexts[0];
+
+	auto starttime = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < pairs.size(); i++) {
+		int32 steps;
+
+		if (navi_hpa_search(pairs[i].first, pairs[i].second, steps))
+			hpa_steps[i] = steps;
+	}
+	auto hpa_time = std::chrono::steady_clock::now() - starttime;
+
+	starttime = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < pairs.size(); i++) {
+		struct navi_walkpath_data wpd = {0};
+
+		if (navi_path_search(ctx, &wpd, pairs[i].first, pairs[i].second, CELL_CHKNOREACH))
+			grid_steps[i] = wpd.path_len;
+	}
+	auto grid_time = std::chrono::steady_clock::now() - starttime;
+
+	size_t both = 0, same = 0, longer = 0, shorter = 0, hpa_only = 0, grid_only = 0;
+	int64 excess = 0, grid_total = 0;
+	int32 excess_max = 0;
+
+	for (size_t i = 0; i < pairs.size(); i++) {
+		if (hpa_steps[i] < 0 || grid_steps[i] < 0) {
+			if (hpa_steps[i] >= 0)
+				hpa_only++;
+			else if (grid_steps[i] >= 0)
+				grid_only++;
+			continue;
+		}
+
+		both++;
+		grid_total += grid_steps[i];
+
+		if (hpa_steps[i] == grid_steps[i])
+			same++;
+		else if (hpa_steps[i] > grid_steps[i]) {
+			longer++;
+			excess += hpa_steps[i] - grid_steps[i];
+			excess_max = std::max(excess_max, hpa_steps[i] - grid_steps[i]);
+		} else
+			shorter++;
+	}
+
+	ShowInfo("Compared %" PRIuPTR " long distances: HPA* took %" PRId64 "ms, the grid search %" PRId64 "ms\n", pairs.size(),
+		static_cast<int64>(std::chrono::duration_cast<std::chrono::milliseconds>(hpa_time).count()),
+		static_cast<int64>(std::chrono::duration_cast<std::chrono::milliseconds>(grid_time).count()));
+	ShowInfo("Found by both: %" PRIuPTR ", HPA* only: %" PRIuPTR " (longer than the grid search limit), grid search only: %" PRIuPTR " (HPA* falls back to the grid search)\n", both, hpa_only, grid_only);
+	ShowInfo("HPA* length: %" PRIuPTR " same, %" PRIuPTR " longer by %.2f cells on average (at most %d), %" PRIuPTR " shorter, %.3f%% longer in total\n",
+		same, longer, longer > 0 ? static_cast<double>(excess) / longer : 0., excess_max, shorter, grid_total > 0 ? 100. * excess / grid_total : 0.);
+}
+
+/**
+ * Generates the navigation files
+ * @param compare: Also compares the distances searched on the cluster graphs with the grid search, see navi_compare_distances
+ */
+void navi_create_lists(bool compare) {
+	navi_contexts_create();
 
 	auto starttime = std::chrono::system_clock::now();
 
@@ -641,6 +1154,10 @@ void navi_create_lists() {
 	auto currenttime = std::chrono::system_clock::now();
 	ShowInfo("Object lists took %ums\n", std::chrono::duration_cast<std::chrono::milliseconds>(currenttime - starttime));
 	starttime = std::chrono::system_clock::now();
+	navi_build_graphs();
+	currenttime = std::chrono::system_clock::now();
+	ShowInfo("Cluster graphs took %ums\n", std::chrono::duration_cast<std::chrono::milliseconds>(currenttime - starttime));
+	starttime = std::chrono::system_clock::now();
 	write_npc_distances();
 	currenttime = std::chrono::system_clock::now();
 	ShowInfo("NPC Distances took %ums\n", std::chrono::duration_cast<std::chrono::milliseconds>(currenttime - starttime));
@@ -649,7 +1166,11 @@ void navi_create_lists() {
 	currenttime = std::chrono::system_clock::now();
 	ShowInfo("Link Distances took %ums\n", std::chrono::duration_cast<std::chrono::milliseconds>(currenttime - starttime));
 
-	BHEAP_CLEAR(g_open_set);
+	if (compare)
+		navi_compare_distances();
+
+	navi_graphs.clear();
+	navi_contexts.clear();
 }
 
 #endif
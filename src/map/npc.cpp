@@ -6,6 +6,7 @@
 #include <cerrno>
 #include <cstdlib>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include <common/cbasetypes.hpp>
@@ -93,8 +94,15 @@ static DBMap* npcname_db; // const char* npc_name -> npc_data*
 struct event_data {
 	npc_data *nd;
 	int32 pos;
+	int32 label_id; // Interned label id, see npc_event_label_intern
+	char name[EVENT_NAME_LENGTH]; // Full "<npc>::<label>" event name
 };
 
+// Event labels interned to integer ids at load time, so that running a label in all NPCs does not need to scan ev_db
+static std::unordered_map<std::string, int32> npc_event_label_ids; // lowercase label name -> label id
+static std::vector<std::vector<struct event_data*>> npc_event_labels; // label id -> events exporting that label, in load order
+static uint32 npc_event_labels_removed; // Increased whenever events are removed from the label index
+
 static struct eri *timer_event_ers; //For the npc timer data. [Skotlex]
 
 /* hello */
@@ -1204,6 +1212,72 @@ int32 npc_event_dequeue(map_session_data* sd,bool free_script_stack)
 	return 1;
 }
 
+/**
+ * Returns the interned id of an event label, creating it if needed.
+ * @param label: Label name without the NPC prefix (case insensitive)
+ * @return Label id
+ */
+static int32 npc_event_label_intern(const char* label){
+	std::string key(label);
+
+	util::tolower(key);
+
+	auto it = npc_event_label_ids.find(key);
+
+	if (it != npc_event_label_ids.end())
+		return it->second;
+
+	int32 id = static_cast<int32>(npc_event_labels.size());
+
+	npc_event_label_ids[key] = id;
+	npc_event_labels.emplace_back();
+
+	return id;
+}
+
+/**
+ * Looks up the interned id of an event label.
+ * @param label: Label name without the NPC prefix (case insensitive)
+ * @return Label id or -1 if no NPC exports the label
+ */
+static int32 npc_event_label_search(const char* label){
+	std::string key(label);
+
+	util::tolower(key);
+
+	return util::umap_get(npc_event_label_ids, key, -1);
+}
+
+/**
+ * Removes an event from the label index, before it is released from ev_db.
+ * @param ev: Event to remove
+ */
+static void npc_event_label_remove(struct event_data* ev){
+	std::vector<struct event_data*>& list = npc_event_labels[ev->label_id];
+
+	util::vector_erase_if_exists(list, ev);
+	npc_event_labels_removed++;
+}
+
+/**
+ * Checks if an event is still exported, after scripts ran that might have unloaded NPCs.
+ * @param label_id: Label id the event was found under
+ * @param ev: Event to check
+ * @return true if the event is still in the label index
+ */
+static bool npc_event_label_exists(int32 label_id, struct event_data* ev){
+	return static_cast<size_t>( label_id ) < npc_event_labels.size() && util::vector_exists( npc_event_labels[label_id], ev );
+}
+
+/**
+ * Clears the label index, called whenever ev_db is cleared.
+ */
+static void npc_event_label_clear(void){
+	npc_event_label_ids.clear();
+	npc_event_labels.clear();
+	npc_event_labels_removed++;
+}
+
 /*==========================================
  * exports a npc event label
  * called from npc_parse_script
@@ -1239,6 +1313,15 @@ static int32 npc_event_export(npc_data *nd, int32 i)
 		CREATE(ev, struct event_data, 1);
 		ev->nd = nd;
 		ev->pos = pos;
+		safestrncpy(ev->name, buf, sizeof(ev->name));
+		ev->label_id = npc_event_label_intern(strstr(buf, "::") + 2);
+
+		struct event_data* old = (struct event_data*)strdb_get(ev_db, buf);
+
+		if (old != nullptr)
+			npc_event_label_remove(old);
+		npc_event_labels[ev->label_id].push_back(ev);
+
 		if (strdb_put(ev_db, buf, ev)) // There was already another event of the same name?
 			return 1;
 	}
@@ -1248,67 +1331,60 @@ static int32 npc_event_export(npc_data *nd, int32 i)
 int32 npc_event_sub(map_session_data* sd, struct event_data* ev, const char* eventname); //[Lance]
 
 /**
- * Exec name (NPC events) on player or global
- * Do on all NPC when called with foreach
- * @see DBApply
+ * Exec a label (NPC events) on player or global in all NPCs exporting it, in load order
+ * @param label_id: Interned label id
+ * @param rid: Player to attach or 0
+ * @return Number of events executed
  */
-int32 npc_event_doall_sub(DBKey key, DBData *data, va_list ap)
+static int32 npc_event_doall_label(int32 label_id, int32 rid)
 {
-	const char* p = key.str;
-	struct event_data* ev;
-	int32* c;
-	const char* name;
-	int32 rid;
+	int32 c = 0;
+	// Work on a copy, the executed scripts might load or unload NPCs
+	std::vector<struct event_data*> events = npc_event_labels[label_id];
+	uint32 removed = npc_event_labels_removed;
 
-	nullpo_ret(ev = (struct event_data*)db_data2ptr(data));
-	nullpo_ret(c = va_arg(ap, int32 *));
-	nullpo_ret(name = va_arg(ap, const char *));
-	rid = va_arg(ap, int32);
+	for( struct event_data* ev : events ){
+		// Skip events that were unloaded by a previous script
+		if( removed != npc_event_labels_removed && !npc_event_label_exists(label_id, ev) )
+			continue;
 
-	p = strchr(p, ':'); // match only the event name
-	if( p && strcmpi(name, p) == 0 /* && !ev->nd->src_id */ ) // Do not run on duplicates. [Paradox924X]
-	{
 		if(rid) // a player may only have 1 script running at the same time
-			npc_event_sub(map_id2sd(rid),ev,key.str);
+			npc_event_sub(map_id2sd(rid),ev,ev->name);
 		else
 			run_script(ev->nd->u.scr.script,ev->pos,rid,ev->nd->id);
-		(*c)++;
+		c++;
 	}
 
-	return 0;
+	return c;
 }
 
-/**
- * @see DBApply
- */
-static int32 npc_event_do_sub(DBKey key, DBData *data, va_list ap)
-{
-	const char* p = key.str;
-	struct event_data* ev;
-	int32* c, rid;
-	const char* name;
+int32 npc_event_do_id(const char* name, int32 rid) {
+	const char* label = strstr(name, "::");
 
-	nullpo_ret(ev = (struct event_data*)db_data2ptr(data));
-	nullpo_ret(c = va_arg(ap, int32 *));
-	nullpo_ret(name = va_arg(ap, const char *));
-	rid = va_arg(ap, int32);
+	if( label == nullptr )
+		return 0;
 
-	if( p && strcmpi(name, p) == 0 )
-	{
-		run_script(ev->nd->u.scr.script,ev->pos,rid,ev->nd->id);
-		(*c)++;
-	}
+	int32 label_id = npc_event_label_search(label + 2);
 
-	return 0;
-}
+	if( label_id < 0 )
+		return 0;
+
+	if( label == name )
+		return npc_event_doall_label(label_id, 0);
 
-int32 npc_event_do_id(const char* name, int32 rid) {
 	int32 c = 0;
+	std::vector<struct event_data*> events = npc_event_labels[label_id];
+	uint32 removed = npc_event_labels_removed;
 
-	if( name[0] == ':' && name[1] == ':' )
-		ev_db->foreach(ev_db,npc_event_doall_sub,&c,name,0,rid);
-	else
-		ev_db->foreach(ev_db,npc_event_do_sub,&c,name,rid);
+	for( struct event_data* ev : events ){
+		if( removed != npc_event_labels_removed && !npc_event_label_exists(label_id, ev) )
+			continue;
+
+		if( strcmpi(name, ev->name) == 0 ){
+			run_script(ev->nd->u.scr.script,ev->pos,rid,ev->nd->id);
+			c++;
+		}
+	}
 
 	return c;
 }
@@ -1332,11 +1408,15 @@ void npc_event_runall( const char* eventname ){
 // runs the specified event, with a RID attached (global only)
 int32 npc_event_doall_id(const char* name, int32 rid)
 {
-	int32 c = 0;
 	char buf[EVENT_NAME_LENGTH];
 	safesnprintf(buf, sizeof(buf), "::%s", name);
-	ev_db->foreach(ev_db,npc_event_doall_sub,&c,buf,rid);
-	return c;
+
+	int32 label_id = npc_event_label_search(buf + 2);
+
+	if( label_id < 0 )
+		return 0;
+
+	return npc_event_doall_label(label_id, rid);
 }
 
 // runs the specified event on all NPCs with the given path
@@ -3448,6 +3528,7 @@ static int32 npc_unload_ev(DBKey key, DBData *data, va_list ap)
 	char* npcname = va_arg(ap, char *);
 
 	if(strcmp(ev->nd->exname,npcname)==0){
+		npc_event_label_remove(ev);
 		db_remove(ev_db, key);
 		return 1;
 	}
@@ -3587,7 +3668,7 @@ int32 npc_unload(npc_data* nd, bool single) {
 	}
 
 	nd->~npc_data();
-	aFree(nd);
+	map_block_free(BL_NPC, nd);
 
 	return 0;
 }
@@ -3795,7 +3876,7 @@ int32 npc_parseview(const char* w4, const char* start, const char* buffer, const
 npc_data *npc_create_npc(int16 m, int16 x, int16 y){
 	npc_data *nd = nullptr;
 
-	CREATE(nd, npc_data, 1);
+	nd = (npc_data*)map_block_alloc(BL_NPC);
 	new (nd) npc_data();
 
 	nd->id = npc_get_new_npc_id();
@@ -4193,7 +4274,7 @@ static const char* npc_parse_shop(char* w1, char* w2, char* w3, char* w4, const
 	if( nd->u.shop.count == 0 ) {
 		ShowWarning("npc_parse_shop: Ignoring empty shop in file '%s', line '%d'.\n", filepath, strline(buffer,start-buffer));
 		nd->~npc_data();
-		aFree(nd);
+		map_block_free(BL_NPC, nd);
 		return strchr(start,'\n');// continue
 	}
 
@@ -5053,9 +5134,9 @@ bool npc_movenpc(npc_data* nd, int16 x, int16 y)
 	x = cap_value(x, 0, mapdata->xs-1);
 	y = cap_value(y, 0, mapdata->ys-1);
 
-	map_foreachinallrange(clif_outsight, nd, AREA_SIZE, BL_PC, nd);
+	map_foreachinallrange([nd]( block_list* target ){ return clif_outsight( target, nd ); }, nd, AREA_SIZE, BL_PC);
 	map_moveblock(nd, x, y, gettick());
-	map_foreachinallrange(clif_insight, nd, AREA_SIZE, BL_PC, nd);
+	map_foreachinallrange([nd]( block_list* target ){ return clif_insight( target, nd ); }, nd, AREA_SIZE, BL_PC);
 	return true;
 }
 
@@ -6009,29 +6090,20 @@ void npc_read_event_script(void)
 
 	for (i = 0; i < NPCE_MAX; i++)
 	{
-		DBIterator* iter;
-		DBKey key;
-		DBData *data;
-		char name[EVENT_NAME_LENGTH];
+		std::vector<struct script_event_s>& vector = script_event[static_cast<enum npce_event>(i)];
+		int32 label_id = npc_event_label_search(npc_get_script_event_name(i));
 
-		safesnprintf(name,EVENT_NAME_LENGTH,"::%s", npc_get_script_event_name(i));
-
-		iter = db_iterator(ev_db);
-		for( data = iter->first(iter,&key); iter->exists(iter); data = iter->next(iter,&key) )
-		{
-			const char* p = key.str;
-			struct event_data* ed = (struct event_data*)db_data2ptr(data);
+		if (label_id < 0)
+			continue;
 
-			if( (p=strchr(p,':')) && strcmpi(name,p)==0 ){
-				struct script_event_s evt;
+		for (struct event_data* ed : npc_event_labels[label_id]) {
+			struct script_event_s evt;
 
-				evt.event = ed;
-				evt.event_name = key.str;
+			evt.event = ed;
+			evt.event_name = ed->name;
 
-				script_event[static_cast<enum npce_event>(i)].push_back(evt);
-			}
+			vector.push_back(evt);
 		}
-		dbi_destroy(iter);
 	}
 
 	if (battle_config.etc_log) {
@@ -6069,6 +6141,7 @@ int32 npc_reload(void) {
 
 	db_clear(npcname_db);
 	db_clear(ev_db);
+	npc_event_label_clear();
 
 	//Remove all npcs/mobs. [Skotlex]
 
@@ -6258,6 +6331,7 @@ bool npc_remove_mob_spawns(const char* path) {
 void do_clear_npc(void) {
 	db_clear(npcname_db);
 	db_clear(ev_db);
+	npc_event_label_clear();
 }
 
 /*==========================================
@@ -6267,6 +6341,7 @@ void do_final_npc(void) {
 	npc_clear_pathlist();
 	script_event.clear();
 	ev_db->destroy(ev_db, nullptr);
+	npc_event_label_clear();
 	npcname_db->destroy(npcname_db, nullptr);
 	npc_path_db->destroy(npc_path_db, nullptr);
 #if PACKETVER >= 20131223
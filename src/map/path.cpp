@@ -3,6 +3,7 @@
 
 #include "path.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -37,6 +38,7 @@ struct path_node {
 	int16 g_cost; ///< Actual cost from start to this node
 	int16 f_cost; ///< g_cost + heuristic(this, goal)
 	int16 flag; ///< SET_OPEN / SET_CLOSED
+	uint32 epoch; ///< Search the node belongs to, see path_epoch
 };
 
 /// Binary heap of path nodes
@@ -50,11 +52,41 @@ static BHEAP_STRUCT_VAR(node_heap, g_open_set);	// use static heap for all path
 
 #define calc_index(x,y) (((x)+(y)*MAX_WALKPATH) & (MAX_WALKPATH*MAX_WALKPATH-1))
 
+// FIXME: This array is too small to ensure all paths shorter than MAX_WALKPATH
+// can be found without node collision: calc_index(node1) = calc_index(node2).
+// Figure out more proper size or another way to keep track of known nodes.
+static struct path_node g_nodes[MAX_WALKPATH * MAX_WALKPATH]; // use static node table for all path calculations
+static uint32 path_epoch; // nodes of other epochs are unused, so the table does not need to be cleared for each search
+
 /// Estimates the cost from (x0,y0) to (x1,y1).
 /// This is inadmissible (overestimating) heuristic used by game client.
 #define heuristic(x0, y0, x1, y1)	(MOVE_COST * (abs((x1) - (x0)) + abs((y1) - (y0)))) // Manhattan distance
 /// @}
 
+/// @name Path search result cache
+/// @{
+
+#define PATH_CACHE_SIZE 1024 // Number of cached results, must be a power of 2
+
+/// Result of an A* search
+struct s_path_cache_entry {
+	uint32 generation; ///< Cell generation of the map the result is valid for, 0 if unused
+	int16 m, x0, y0, x1, y1;
+	cell_chk cell;
+	bool found;
+	struct walkpath_data wpd;
+};
+
+static struct s_path_cache_entry path_cache[PATH_CACHE_SIZE];
+
+static struct s_path_cache_stats {
+	uint64 hits;
+	uint64 misses;
+	uint64 stale; ///< Misses on results of the same search before the map's cells changed
+	uint64 uncached; ///< Searches with a cell check that depends on more than the cells
+} path_cache_stats;
+/// @}
+
 // Translates dx,dy into walking direction
 static enum directions walk_choices [3][3] =
 {
@@ -72,6 +104,51 @@ void do_final_path(){
 	BHEAP_CLEAR(g_open_set);
 }//
 
+/**
+ * Displays statistics of the path search result cache
+ */
+void path_cache_report(void){
+	uint64 lookups = path_cache_stats.hits + path_cache_stats.misses;
+
+	ShowInfo( "Path cache: " CL_WHITE "%" PRIu64 CL_RESET " hits, " CL_WHITE "%" PRIu64 CL_RESET " misses (" CL_WHITE "%" PRIu64 CL_RESET " stale), hit rate " CL_WHITE "%.1f%%" CL_RESET ", " CL_WHITE "%" PRIu64 CL_RESET " uncached searches.\n",
+		path_cache_stats.hits, path_cache_stats.misses, path_cache_stats.stale, lookups > 0 ? 100. * path_cache_stats.hits / lookups : 0., path_cache_stats.uncached );
+}
+
+/**
+ * Checks if the result of a search only depends on the walkable and shootable flags of the cells
+ * @param cell: Cell check of the search
+ * @return true if the result can be cached
+ */
+static bool path_cache_allowed( cell_chk cell ){
+	switch( cell ){
+		case CELL_CHKWALL:
+		case CELL_CHKREACH:
+		case CELL_CHKNOREACH:
+#ifndef CELL_NOSTACK
+		// Without cell stacking, these are the same as the reach checks
+		case CELL_CHKPASS:
+		case CELL_CHKNOPASS:
+#endif
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Returns the cache slot of a search
+ */
+static struct s_path_cache_entry& path_cache_slot( int16 m, int16 x0, int16 y0, int16 x1, int16 y1, cell_chk cell ){
+	uint32 hash = static_cast<uint32>( m ) * 2654435761u;
+
+	hash ^= ( static_cast<uint32>( x0 ) << 16 | static_cast<uint16>( y0 ) ) * 2246822519u;
+	hash ^= ( static_cast<uint32>( x1 ) << 16 | static_cast<uint16>( y1 ) ) * 3266489917u;
+	hash ^= cell;
+	hash ^= hash >> 15;
+
+	return path_cache[hash & ( PATH_CACHE_SIZE - 1 )];
+}
+
 
 /*==========================================
  * Find the closest reachable cell, 'count' cells away from (x0,y0) in direction (dx,dy).
@@ -96,14 +173,14 @@ int32 path_blownpos(int16 m,int16 x0,int16 y0,int16 dx,int16 dy,int32 count)
 
 	while( count > 0 && (dx != 0 || dy != 0) )
 	{
-		if( !map_getcellp(mapdata,x0+dx,y0+dy,CELL_CHKPASS) )
+		if( !map_getcellbits(mapdata,x0+dx,y0+dy,CELL_CHKPASS) )
 		{
 			if (battle_config.path_blown_halt)
 				break;
 			else
 			{// attempt partial movement
-				int32 fx = ( dx != 0 && map_getcellp(mapdata,x0+dx,y0,CELL_CHKPASS) );
-				int32 fy = ( dy != 0 && map_getcellp(mapdata,x0,y0+dy,CELL_CHKPASS) );
+				int32 fx = ( dx != 0 && map_getcellbits(mapdata,x0+dx,y0,CELL_CHKPASS) );
+				int32 fy = ( dy != 0 && map_getcellbits(mapdata,x0,y0+dy,CELL_CHKPASS) );
 				if( fx && fy )
 				{
 					if(rnd_chance(50, 100))
@@ -126,6 +203,41 @@ int32 path_blownpos(int16 m,int16 x0,int16 y0,int16 dx,int16 dy,int32 count)
 	return (x0<<16)|y0; //TODO: use 'struct point' here instead?
 }
 
+/**
+ * Checks if a row segment contains a wall cell, a bitmap word at a time
+ * Cells in the last row and column never count as walls, see map_getcellp
+ * @param mapdata: Map with cell bitmaps
+ * @param y: Row
+ * @param x0: First column of the segment
+ * @param x1: Last column of the segment, not less than x0
+ * @return true if there is a wall
+ */
+static bool path_row_haswall(struct map_data *mapdata, int16 y, int32 x0, int32 x1)
+{
+	if (y < 0 || y >= mapdata->ys - 1)
+		return false;
+
+	x0 = std::max(x0, 0);
+	x1 = std::min(x1, mapdata->xs - 2);
+
+	const uint64 *walkable = &mapdata->cell_walkable[y * mapdata->cell_words];
+	const uint64 *shootable = &mapdata->cell_shootable[y * mapdata->cell_words];
+
+	for (int32 i = x0 >> 6; x0 <= x1 && i <= x1 >> 6; i++) {
+		uint64 mask = ~0ULL;
+
+		if (i == x0 >> 6)
+			mask &= ~0ULL << (x0 & 63);
+		if (i == x1 >> 6)
+			mask &= ~0ULL >> (63 - (x1 & 63));
+
+		if (~(walkable[i] | shootable[i]) & mask)
+			return true;
+	}
+
+	return false;
+}
+
 /*==========================================
  * is ranged attack from (x0,y0) to (x1,y1) possible?
  *------------------------------------------*/
@@ -156,6 +268,18 @@ bool path_search_long(struct shootpath_data *spd,int16 m,int16 x0,int16 y0,int16
 	spd->x[0] = x0;
 	spd->y[0] = y0;
 
+	// Horizontal line of sight, check the whole row segment at once
+	if (dy == 0 && dx > 0 && cell == CELL_CHKWALL && map_cellbits_ready(mapdata)) {
+		spd->ry = 1;
+		for (int32 x = x0 + 1; x <= x1 && spd->len < MAX_WALKPATH; x++) {
+			spd->x[spd->len] = x;
+			spd->y[spd->len] = y0;
+			spd->len++;
+		}
+
+		return !path_row_haswall(mapdata, y0, x0 + 1, x1 - 1);
+	}
+
 	if (dx > abs(dy)) {
 		weight = dx;
 		spd->ry = 1;
@@ -185,7 +309,7 @@ bool path_search_long(struct shootpath_data *spd,int16 m,int16 x0,int16 y0,int16
 			spd->y[spd->len] = y0;
 			spd->len++;
 		}
-		if ((x0 != x1 || y0 != y1) && map_getcellp(mapdata,x0,y0,cell))
+		if ((x0 != x1 || y0 != y1) && map_getcellbits(mapdata,x0,y0,cell))
 			return false;
 	}
 
@@ -225,7 +349,7 @@ static int32 add_path(struct node_heap *heap, struct path_node *tp, int16 x, int
 {
 	int32 i = calc_index(x, y);
 
-	if (tp[i].x == x && tp[i].y == y) { // We processed this node before
+	if (tp[i].epoch == path_epoch && tp[i].x == x && tp[i].y == y) { // We processed this node before
 		if (g_cost < tp[i].g_cost) { // New path to this node is better than old one
 			// Update costs and parent
 			tp[i].g_cost = g_cost;
@@ -242,10 +366,11 @@ static int32 add_path(struct node_heap *heap, struct path_node *tp, int16 x, int
 		return 0;
 	}
 
-	if (tp[i].x || tp[i].y) // Index is already taken; see `tp` array FIXME for details
+	if (tp[i].epoch == path_epoch) // Index is already taken; see `g_nodes` array FIXME for details
 		return 1;
 
 	// New node
+	tp[i].epoch = path_epoch;
 	tp[i].x = x;
 	tp[i].y = y;
 	tp[i].g_cost = g_cost;
@@ -257,6 +382,119 @@ static int32 add_path(struct node_heap *heap, struct path_node *tp, int16 x, int
 }
 ///@}
 
+/**
+ * A* search (x0,y0)->(x1,y1), the cells have been checked already
+ * @see path_search
+ */
+static bool path_search_astar(struct walkpath_data *wpd, struct map_data *mapdata, int16 x0, int16 y0, int16 x1, int16 y1, cell_chk cell)
+{
+	int32 i, x, y, dx, dy;
+	struct path_node *tp = g_nodes;
+	struct path_node *current, *it;
+	int32 xs = mapdata->xs - 1;
+	int32 ys = mapdata->ys - 1;
+	int32 len = 0;
+	int32 j;
+
+	// A* (A-star) pathfinding
+	// We always use A* for finding walkpaths because it is what game client uses.
+	// Easy pathfinding cuts corners of non-walkable cells, but client always walks around it.
+	BHEAP_RESET(g_open_set);
+
+	// Start a new epoch, all nodes of previous searches become unused
+	if (++path_epoch == 0) {
+		memset(g_nodes, 0, sizeof(g_nodes));
+		path_epoch = 1;
+	}
+
+	// Start node
+	i = calc_index(x0, y0);
+	tp[i].epoch  = path_epoch;
+	tp[i].parent = nullptr;
+	tp[i].x      = x0;
+	tp[i].y      = y0;
+	tp[i].g_cost = 0;
+	tp[i].f_cost = heuristic(x0, y0, x1, y1);
+	tp[i].flag   = SET_OPEN;
+
+	heap_push_node(&g_open_set, &tp[i]); // Put start node to 'open' set
+
+	for(;;) {
+		int32 e = 0; // error flag
+
+		// Saves allowed directions for the current cell. Diagonal directions
+		// are only allowed if both directions around it are allowed. This is
+		// to prevent cutting corner of nearby wall.
+		// For example, you can only go NW from the current cell, if you can
+		// go N *and* you can go W. Otherwise you need to walk around the
+		// (corner of the) non-walkable cell.
+		int32 allowed_dirs = 0;
+
+		int32 g_cost;
+
+		if (BHEAP_LENGTH(g_open_set) == 0) {
+			return false;
+		}
+
+		current = BHEAP_PEEK(g_open_set); // Look for the lowest f_cost node in the 'open' set
+		BHEAP_POP2(g_open_set, NODE_MINTOPCMP); // Remove it from 'open' set
+
+		x      = current->x;
+		y      = current->y;
+		g_cost = current->g_cost;
+
+		current->flag = SET_CLOSED; // Add current node to 'closed' set
+
+		if (x == x1 && y == y1) {
+			break;
+		}
+
+		if (y < ys && !map_getcellbits(mapdata, x, y+1, cell)) allowed_dirs |= PATH_DIR_NORTH;
+		if (y >  0 && !map_getcellbits(mapdata, x, y-1, cell)) allowed_dirs |= PATH_DIR_SOUTH;
+		if (x < xs && !map_getcellbits(mapdata, x+1, y, cell)) allowed_dirs |= PATH_DIR_EAST;
+		if (x >  0 && !map_getcellbits(mapdata, x-1, y, cell)) allowed_dirs |= PATH_DIR_WEST;
+
+#define chk_dir(d) ((allowed_dirs & (d)) == (d))
+		// Process neighbors of current node
+		if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_EAST) && !map_getcellbits(mapdata, x+1, y-1, cell))
+			e += add_path(&g_open_set, tp, x+1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y-1, x1, y1)); // (x+1, y-1) 5
+		if (chk_dir(PATH_DIR_EAST))
+			e += add_path(&g_open_set, tp, x+1, y, g_cost + MOVE_COST, current, heuristic(x+1, y, x1, y1)); // (x+1, y) 6
+		if (chk_dir(PATH_DIR_NORTH|PATH_DIR_EAST) && !map_getcellbits(mapdata, x+1, y+1, cell))
+			e += add_path(&g_open_set, tp, x+1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y+1, x1, y1)); // (x+1, y+1) 7
+		if (chk_dir(PATH_DIR_NORTH))
+			e += add_path(&g_open_set, tp, x, y+1, g_cost + MOVE_COST, current, heuristic(x, y+1, x1, y1)); // (x, y+1) 0
+		if (chk_dir(PATH_DIR_NORTH|PATH_DIR_WEST) && !map_getcellbits(mapdata, x-1, y+1, cell))
+			e += add_path(&g_open_set, tp, x-1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y+1, x1, y1)); // (x-1, y+1) 1
+		if (chk_dir(PATH_DIR_WEST))
+			e += add_path(&g_open_set, tp, x-1, y, g_cost + MOVE_COST, current, heuristic(x-1, y, x1, y1)); // (x-1, y) 2
+		if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_WEST) && !map_getcellbits(mapdata, x-1, y-1, cell))
+			e += add_path(&g_open_set, tp, x-1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y-1, x1, y1)); // (x-1, y-1) 3
+		if (chk_dir(PATH_DIR_SOUTH))
+			e += add_path(&g_open_set, tp, x, y-1, g_cost + MOVE_COST, current, heuristic(x, y-1, x1, y1)); // (x, y-1) 4
+#undef chk_dir
+		if (e) {
+			return false;
+		}
+	}
+
+	for (it = current; it->parent != nullptr; it = it->parent, len++);
+	if (len > sizeof(wpd->path))
+		return false;
+
+	// Recreate path
+	wpd->path_len = len;
+	wpd->path_pos = 0;
+
+	for (it = current, j = len-1; j >= 0; it = it->parent, j--) {
+		dx = it->x - it->parent->x;
+		dy = it->y - it->parent->y;
+		wpd->path[j] = walk_choices[-dy + 1][dx + 1];
+	}
+
+	return true;
+}
+
 /*==========================================
  * path search (x0,y0)->(x1,y1)
  * wpd: path info will be written here
@@ -264,7 +502,8 @@ static int32 add_path(struct node_heap *heap, struct path_node *tp, int16 x, int
  * flag: &2 = call path_search_long instead
  * cell: type of obstruction to check for
  *
- * Note: uses global g_open_set, therefore this method can't be called in parallel or recursivly.
+ * Note: uses global g_open_set and g_nodes, therefore this method can't be called in parallel or recursivly.
+ * A* results are cached until the walkable or shootable cells of the map change.
  *------------------------------------------*/
 bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int32 flag, cell_chk cell)
 {
@@ -282,11 +521,11 @@ bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x
 		return false;
 
 	//Do not check starting cell as that would get you stuck.
-	if (x0 < 0 || x0 >= mapdata->xs || y0 < 0 || y0 >= mapdata->ys /*|| map_getcellp(mapdata,x0,y0,cell)*/)
+	if (x0 < 0 || x0 >= mapdata->xs || y0 < 0 || y0 >= mapdata->ys /*|| map_getcellbits(mapdata,x0,y0,cell)*/)
 		return false;
 
 	// Check destination cell
-	if (x1 < 0 || x1 >= mapdata->xs || y1 < 0 || y1 >= mapdata->ys || map_getcellp(mapdata,x1,y1,cell))
+	if (x1 < 0 || x1 >= mapdata->xs || y1 < 0 || y1 >= mapdata->ys || map_getcellbits(mapdata,x1,y1,cell))
 		return false;
 
 	if (flag&1) {
@@ -312,7 +551,7 @@ bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x
 
 			if( dx == 0 && dy == 0 )
 				break; // success
-			if( map_getcellp(mapdata,x,y,cell) )
+			if( map_getcellbits(mapdata,x,y,cell) )
 				break; // obstacle = failure
 		}
 
@@ -323,112 +562,39 @@ bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x
 		}
 
 		return false; // easy path unsuccessful
-	} else { // !(flag&1)
-		// FIXME: This array is too small to ensure all paths shorter than MAX_WALKPATH
-		// can be found without node collision: calc_index(node1) = calc_index(node2).
-		// Figure out more proper size or another way to keep track of known nodes.
-		struct path_node tp[MAX_WALKPATH * MAX_WALKPATH];
-		struct path_node *current, *it;
-		int32 xs = mapdata->xs - 1;
-		int32 ys = mapdata->ys - 1;
-		int32 len = 0;
-		int32 j;
-
-		// A* (A-star) pathfinding
-		// We always use A* for finding walkpaths because it is what game client uses.
-		// Easy pathfinding cuts corners of non-walkable cells, but client always walks around it.
-		BHEAP_RESET(g_open_set);
-
-		memset(tp, 0, sizeof(tp));
-
-		// Start node
-		i = calc_index(x0, y0);
-		tp[i].parent = nullptr;
-		tp[i].x      = x0;
-		tp[i].y      = y0;
-		tp[i].g_cost = 0;
-		tp[i].f_cost = heuristic(x0, y0, x1, y1);
-		tp[i].flag   = SET_OPEN;
-
-		heap_push_node(&g_open_set, &tp[i]); // Put start node to 'open' set
-
-		for(;;) {
-			int32 e = 0; // error flag
-
-			// Saves allowed directions for the current cell. Diagonal directions
-			// are only allowed if both directions around it are allowed. This is
-			// to prevent cutting corner of nearby wall.
-			// For example, you can only go NW from the current cell, if you can
-			// go N *and* you can go W. Otherwise you need to walk around the
-			// (corner of the) non-walkable cell.
-			int32 allowed_dirs = 0;
-
-			int32 g_cost;
-
-			if (BHEAP_LENGTH(g_open_set) == 0) {
-				return false;
-			}
-
-			current = BHEAP_PEEK(g_open_set); // Look for the lowest f_cost node in the 'open' set
-			BHEAP_POP2(g_open_set, NODE_MINTOPCMP); // Remove it from 'open' set
-
-			x      = current->x;
-			y      = current->y;
-			g_cost = current->g_cost;
-
-			current->flag = SET_CLOSED; // Add current node to 'closed' set
+	}
 
-			if (x == x1 && y == y1) {
-				break;
-			}
+	if (!path_cache_allowed(cell)) {
+		path_cache_stats.uncached++;
+		return path_search_astar(wpd, mapdata, x0, y0, x1, y1, cell);
+	}
 
-			if (y < ys && !map_getcellp(mapdata, x, y+1, cell)) allowed_dirs |= PATH_DIR_NORTH;
-			if (y >  0 && !map_getcellp(mapdata, x, y-1, cell)) allowed_dirs |= PATH_DIR_SOUTH;
-			if (x < xs && !map_getcellp(mapdata, x+1, y, cell)) allowed_dirs |= PATH_DIR_EAST;
-			if (x >  0 && !map_getcellp(mapdata, x-1, y, cell)) allowed_dirs |= PATH_DIR_WEST;
+	struct s_path_cache_entry& entry = path_cache_slot(m, x0, y0, x1, y1, cell);
 
-#define chk_dir(d) ((allowed_dirs & (d)) == (d))
-			// Process neighbors of current node
-			if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_EAST) && !map_getcellp(mapdata, x+1, y-1, cell))
-				e += add_path(&g_open_set, tp, x+1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y-1, x1, y1)); // (x+1, y-1) 5
-			if (chk_dir(PATH_DIR_EAST))
-				e += add_path(&g_open_set, tp, x+1, y, g_cost + MOVE_COST, current, heuristic(x+1, y, x1, y1)); // (x+1, y) 6
-			if (chk_dir(PATH_DIR_NORTH|PATH_DIR_EAST) && !map_getcellp(mapdata, x+1, y+1, cell))
-				e += add_path(&g_open_set, tp, x+1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y+1, x1, y1)); // (x+1, y+1) 7
-			if (chk_dir(PATH_DIR_NORTH))
-				e += add_path(&g_open_set, tp, x, y+1, g_cost + MOVE_COST, current, heuristic(x, y+1, x1, y1)); // (x, y+1) 0
-			if (chk_dir(PATH_DIR_NORTH|PATH_DIR_WEST) && !map_getcellp(mapdata, x-1, y+1, cell))
-				e += add_path(&g_open_set, tp, x-1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y+1, x1, y1)); // (x-1, y+1) 1
-			if (chk_dir(PATH_DIR_WEST))
-				e += add_path(&g_open_set, tp, x-1, y, g_cost + MOVE_COST, current, heuristic(x-1, y, x1, y1)); // (x-1, y) 2
-			if (chk_dir(PATH_DIR_SOUTH|PATH_DIR_WEST) && !map_getcellp(mapdata, x-1, y-1, cell))
-				e += add_path(&g_open_set, tp, x-1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y-1, x1, y1)); // (x-1, y-1) 3
-			if (chk_dir(PATH_DIR_SOUTH))
-				e += add_path(&g_open_set, tp, x, y-1, g_cost + MOVE_COST, current, heuristic(x, y-1, x1, y1)); // (x, y-1) 4
-#undef chk_dir
-			if (e) {
-				return false;
-			}
+	if (entry.m == m && entry.x0 == x0 && entry.y0 == y0 && entry.x1 == x1 && entry.y1 == y1 && entry.cell == cell) {
+		if (entry.generation == mapdata->cell_generation) {
+			path_cache_stats.hits++;
+			if (entry.found)
+				*wpd = entry.wpd;
+			return entry.found;
 		}
+		path_cache_stats.stale++;
+	}
 
-		for (it = current; it->parent != nullptr; it = it->parent, len++);
-		if (len > sizeof(wpd->path))
-			return false;
-
-		// Recreate path
-		wpd->path_len = len;
-		wpd->path_pos = 0;
-
-		for (it = current, j = len-1; j >= 0; it = it->parent, j--) {
-			dx = it->x - it->parent->x;
-			dy = it->y - it->parent->y;
-			wpd->path[j] = walk_choices[-dy + 1][dx + 1];
-		}
+	path_cache_stats.misses++;
 
-		return true;
-	} // A* end
+	entry.found = path_search_astar(wpd, mapdata, x0, y0, x1, y1, cell);
+	entry.generation = mapdata->cell_generation;
+	entry.m = m;
+	entry.x0 = x0;
+	entry.y0 = y0;
+	entry.x1 = x1;
+	entry.y1 = y1;
+	entry.cell = cell;
+	if (entry.found)
+		entry.wpd = *wpd;
 
-	return false;
+	return entry.found;
 }
 
 
@@ -73,6 +73,8 @@ bool check_distance_client(int32 dx, int32 dy, int32 distance);
 double distance_math(int32 dx, int32 dy);
 int32 distance_client(int32 dx, int32 dy);
 
+void path_cache_report(void);
+
 bool direction_diagonal( enum directions direction );
 bool direction_opposite( enum directions direction );
 
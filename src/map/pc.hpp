@@ -253,6 +253,14 @@ struct s_addrace2 {
 	unsigned char race;
 };
 
+/// Attacker tables of s_cardfix
+enum e_cardfix_hand : uint8 {
+	CARDFIX_RIGHT = 0, ///< Right hand weapon
+	CARDFIX_LEFT, ///< Left hand weapon
+	CARDFIX_ARROW, ///< Right hand weapon and ammunition, for ranged attacks
+	CARDFIX_HAND_MAX
+};
+
 struct weapon_data {
 	int32 atkmods[SZ_ALL];
 	// all the variables except atkmods get zero'ed in each call of status_calc_pc
@@ -1898,6 +1906,30 @@ public:
 	} indexed_bonus;
 	// zeroed arrays end here.
 
+	/// Card fix modifiers folded at the end of status_calc_pc, the entry of each index already includes the ALL bonus
+	struct s_cardfix {
+		// Attacker, physical: see e_cardfix_hand
+		int32 addele[CARDFIX_HAND_MAX][ELE_MAX];
+		int32 addrace[CARDFIX_HAND_MAX][RC_MAX];
+		int32 addclass[CARDFIX_HAND_MAX][CLASS_MAX];
+		int32 addsize[CARDFIX_HAND_MAX][SZ_MAX];
+		// Attacker, magic
+		int32 magic_addele[ELE_MAX]; ///< Including magic_addele_script
+		int32 magic_atk_ele[ELE_MAX];
+		int32 magic_addrace[RC_MAX];
+		int32 magic_addclass[CLASS_MAX];
+		int32 magic_addsize[SZ_MAX];
+		// Target
+		int32 subele[ELE_MAX]; ///< Including subele_script
+		int32 subdefele[ELE_MAX];
+		int32 magic_subdefele[ELE_MAX];
+		int32 subrace[RC_MAX];
+		int32 subclass[CLASS_MAX];
+		int32 subsize[SZ_MAX];
+		int32 weapon_subsize[SZ_MAX];
+		int32 magic_subsize[SZ_MAX];
+	} cardfix;
+
 	std::vector<s_autospell> autospell, autospell2, autospell3;
 	std::vector<s_addeffect> addeff, addeff_atked;
 	std::vector<s_addeffectonskill> addeff_onskill;
@@ -1982,6 +2014,8 @@ public:
 	int32 critical_rate,hit_rate,flee_rate,flee2_rate,def_rate,def2_rate,mdef_rate,mdef2_rate;
 	int32 patk_rate,smatk_rate,res_rate,mres_rate,hplus_rate,crate_rate;
 
+	std::shared_ptr<struct s_status_pc_layer> status_layer; ///< Equipment bonuses of the last full status calculation, see status_calc_pc_sub
+
 	t_itemid itemid;
 	int16 itemindex;	//Used item's index in sd->inventory [Skotlex]
 
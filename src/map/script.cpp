@@ -13,6 +13,8 @@
 #include <cmath>
 #include <csetjmp>
 #include <cstdlib> // atoi, strtol, strtoll, exit
+#include <map>
+#include <vector>
 
 #ifdef PCRE_SUPPORT
 #include <pcre.h> // preg_match
@@ -61,6 +63,7 @@
 #include "pc_groups.hpp"
 #include "pet.hpp"
 #include "quest.hpp"
+#include "script_sql.hpp"
 #include "storage.hpp"
 
 using namespace rathena;
@@ -258,6 +261,7 @@ struct Script_Config script_config = {
 	1, // warn_func_mismatch_argtypes
 	1, 65535, 2048, //warn_func_mismatch_paramnum/check_cmdcount/check_gotocount
 	0, INT_MAX, // input_min_value/input_max_value
+	2, 30000, // sql_async_workers/sql_async_timeout
 	// NOTE: None of these event labels should be longer than <EVENT_NAME_LENGTH> characters
 	// PC related
 	"OnPCDieEvent", //die_event_name
@@ -381,7 +385,20 @@ typedef struct script_function {
 
 extern script_function buildin_func[];
 
-static struct linkdb_node *sleep_db; // int32 oid -> struct script_state *
+/// Sleeping script states grouped by wake tick.
+/// A single timer armed for the earliest tick resumes a whole group at once, entries are
+/// validated against st_db on wakeup so freeing or awaking a state does not touch the queue.
+static std::map<t_tick, std::vector<uint32>> sleep_queue; // wake tick -> script state ids
+static int32 sleep_timer = INVALID_TIMER;
+static t_tick sleep_timer_tick;
+
+/// Statistics of the sleep queue, see script_sleep_report
+static struct s_script_sleep_stats {
+	uint32 suspended; ///< Currently suspended states
+	uint32 peak; ///< Highest number of simultaneously suspended states
+	uint64 resumed; ///< States resumed in total
+	uint64 batches; ///< Wakeups of the sleep timer
+} sleep_stats;
 
 /*==========================================
  * (Only those needed) local declaration prototype
@@ -389,6 +406,7 @@ static struct linkdb_node *sleep_db; // int32 oid -> struct script_state *
 const char* parse_subexpr(const char* p,int32 limit);
 int32 run_func(struct script_state *st);
 int32 script_instancegetid(struct script_state *st, e_instance_mode mode = IM_NONE);
+static void script_sleep_cancel(struct script_state* st);
 
 const char* script_op2name(int32 op)
 {
@@ -3639,7 +3657,7 @@ struct script_state* script_alloc_state(struct script_code* rootscript, int32 po
 	st->pos = pos;
 	st->rid = rid;
 	st->oid = oid;
-	st->sleep.timer = INVALID_TIMER;
+	st->sleep.suspended = false;
 	st->npc_item_flag = battle_config.item_enabled_npc;
 	
 	if( st->script->instances != USHRT_MAX )
@@ -3681,8 +3699,9 @@ void script_free_state(struct script_state* st)
 			sd->npc_id = 0;
 		}
 
-		if (st->sleep.timer != INVALID_TIMER)
-			delete_timer(st->sleep.timer, run_script_timer);
+		if (st->sleep.suspended)
+			script_sleep_cancel(st);
+		script_sql_async_cancel(st->id);
 		if (st->stack) {
 			script_free_vars(st->stack->scope.vars);
 			if (st->stack->scope.arrays)
@@ -4218,15 +4237,47 @@ void script_stop_scriptinstances(struct script_code *code) {
 	dbi_destroy(iter);
 }
 
-/*==========================================
- * Timer function for sleep
- *------------------------------------------*/
-TIMER_FUNC(run_script_timer){
-	struct script_state *st = (struct script_state *)data;
-	struct linkdb_node *node = (struct linkdb_node *)sleep_db;
+/**
+ * Parks a script state in the sleep queue until st->sleep.tick milliseconds have passed
+ * @param st: Script state
+ */
+static void script_sleep_suspend(struct script_state* st) {
+	st->sleep.wakeup = gettick() + st->sleep.tick;
+	st->sleep.suspended = true;
+
+	sleep_queue[st->sleep.wakeup].push_back(st->id);
+
+	sleep_stats.suspended++;
+	sleep_stats.peak = std::max(sleep_stats.peak, sleep_stats.suspended);
+
+	// Only re-arm the timer if this state wakes up before everything else
+	if (sleep_timer != INVALID_TIMER && DIFF_TICK(st->sleep.wakeup, sleep_timer_tick) >= 0)
+		return;
 
+	if (sleep_timer != INVALID_TIMER)
+		delete_timer(sleep_timer, script_sleep_timer);
+
+	sleep_timer_tick = st->sleep.wakeup;
+	sleep_timer = add_timer(sleep_timer_tick, script_sleep_timer, 0, 0);
+}
+
+/**
+ * Takes a script state out of the sleep queue
+ * The queue entry is left behind and skipped when its group wakes up
+ * @param st: Script state
+ */
+static void script_sleep_cancel(struct script_state* st) {
+	st->sleep.suspended = false;
+	sleep_stats.suspended--;
+}
+
+/**
+ * Resumes a sleeping script state
+ * @param st: Script state
+ */
+static void script_sleep_resume(struct script_state* st) {
 	// If it was a player before going to sleep and there is still a unit attached to the script
-	if( id != 0 && st->rid ){
+	if( st->sleep.charid != 0 && st->rid ){
 		map_session_data *sd = map_id2sd(st->rid);
 
 		// Attached player is offline(logout) or another unit type(should not happen)
@@ -4234,66 +4285,104 @@ TIMER_FUNC(run_script_timer){
 			st->rid = 0;
 			st->state = END;
 		// Character mismatch. Cancel execution.
-		}else if( sd->status.char_id != id ){
-			ShowWarning( "Script sleep timer detected a character mismatch CID %d != %d\n", sd->status.char_id, id );
+		}else if( sd->status.char_id != st->sleep.charid ){
+			ShowWarning( "Script sleep timer detected a character mismatch CID %d != %d\n", sd->status.char_id, st->sleep.charid );
 			script_reportsrc(st);
 			st->rid = 0;
 			st->state = END;
 		}
 	}
 
-	while (node && st->sleep.timer != INVALID_TIMER) {
-		if ((int32)__64BPRTSIZE(node->key) == st->oid && ((struct script_state *)node->data)->sleep.timer == st->sleep.timer) {
-			script_erase_sleepdb(node);
-			st->sleep.timer = INVALID_TIMER;
-			break;
-		}
-		node = node->next;
-	}
+	script_sleep_cancel(st);
+	sleep_stats.resumed++;
+
 	if(st->state != RERUNLINE)
 		st->sleep.tick = 0;
 	run_script_main(st);
-	return 0;
 }
 
 /**
- * Remove sleep timers from the NPC
- * @param id: NPC ID
+ * Resumes a sleeping script state before its wake tick
+ * @param id: Script state id
  */
-void script_stop_sleeptimers(int32 id) {
-	for (;;) {
-		struct script_state *st = (struct script_state *)linkdb_erase(&sleep_db, (void *)__64BPRTSIZE(id));
+void script_sleep_wakeup(uint32 id) {
+	struct script_state* st = (struct script_state*)idb_get(st_db, id);
 
-		if (!st)
-			break; // No more sleep timers
+	if (st == nullptr || !st->sleep.suspended)
+		return;
 
-		if (st->oid == id)
-			script_free_state(st);
+	script_sleep_resume(st);
+}
+
+/*==========================================
+ * Timer function for sleep
+ * Resumes every group of script states that is due
+ *------------------------------------------*/
+TIMER_FUNC(script_sleep_timer){
+	if( tid != sleep_timer ){
+		ShowError( "script_sleep_timer: Timer mismatch %d != %d\n", tid, sleep_timer );
+		return 0;
 	}
+
+	sleep_timer = INVALID_TIMER;
+	sleep_stats.batches++;
+
+	while( !sleep_queue.empty() ){
+		auto it = sleep_queue.begin();
+		t_tick wakeup = it->first;
+
+		if( DIFF_TICK(wakeup, tick) > 0 )
+			break;
+
+		// Resumed scripts might put other states to sleep, take the group out first
+		std::vector<uint32> group = std::move( it->second );
+
+		sleep_queue.erase( it );
+
+		for( uint32 st_id : group ){
+			struct script_state* st = (struct script_state*)idb_get( st_db, st_id );
+
+			// Already freed, awoken or sleeping again
+			if( st == nullptr || !st->sleep.suspended || st->sleep.wakeup != wakeup )
+				continue;
+
+			script_sleep_resume( st );
+		}
+	}
+
+	if( sleep_timer == INVALID_TIMER && !sleep_queue.empty() ){
+		sleep_timer_tick = sleep_queue.begin()->first;
+		sleep_timer = add_timer( sleep_timer_tick, script_sleep_timer, 0, 0 );
+	}
+
+	return 0;
 }
 
 /**
- * Delete the specified node from sleep_db
- * @param n: Linked list of sleep timers
+ * Remove sleeping script states from the NPC
+ * @param id: NPC ID
  */
-struct linkdb_node *script_erase_sleepdb(struct linkdb_node *n) {
-	struct linkdb_node *retnode;
-
-	if (!n)
-		return nullptr;
-
-	if (!n->prev)
-		sleep_db = n->next;
-	else
-		n->prev->next = n->next;
+void script_stop_sleeptimers(int32 id) {
+	std::vector<struct script_state*> list;
+	DBIterator* iter = db_iterator(st_db);
 
-	if (n->next)
-		n->next->prev = n->prev;
+	for( struct script_state* st = static_cast<script_state *>(dbi_first(iter)); dbi_exists(iter); st = static_cast<script_state *>(dbi_next(iter)) ){
+		if( st->oid == id && st->sleep.suspended )
+			list.push_back(st);
+	}
+	dbi_destroy(iter);
 
-	retnode = n->next;
-	aFree(n);
+	for( struct script_state* st : list )
+		script_free_state(st);
+}
 
-	return retnode;
+/**
+ * Displays statistics of the sleep queue
+ */
+void script_sleep_report(void) {
+	ShowInfo( "Script sleep queue: " CL_WHITE "%u" CL_RESET " suspended (peak " CL_WHITE "%u" CL_RESET "), " CL_WHITE "%" PRIuPTR CL_RESET " wake ticks pending.\n", sleep_stats.suspended, sleep_stats.peak, sleep_queue.size() );
+	ShowInfo( "Script sleep queue: " CL_WHITE "%" PRIu64 CL_RESET " states resumed in " CL_WHITE "%" PRIu64 CL_RESET " batches.\n", sleep_stats.resumed, sleep_stats.batches );
+	script_sql_async_report();
 }
 
 /// Detaches script state from possibly attached character and restores it's previous script if any.
@@ -4482,8 +4571,7 @@ void run_script_main(struct script_state *st)
 		//Delay execution
 		sd = map_id2sd(st->rid); // Get sd since script might have attached someone while running. [Inkfish]
 		st->sleep.charid = sd?sd->status.char_id:0;
-		st->sleep.timer = add_timer(gettick() + st->sleep.tick, run_script_timer, st->sleep.charid, (intptr_t)st);
-		linkdb_insert(&sleep_db, (void *)__64BPRTSIZE(st->oid), st);
+		script_sleep_suspend(st);
 	} else if(st->state != END && st->rid) {
 		//Resume later (st is already attached to player).
 		if(st->bk_st) {
@@ -4561,6 +4649,12 @@ int32 script_config_read(const char *cfgName)
 		else if(strcmpi(w1,"warn_func_mismatch_argtypes")==0) {
 			script_config.warn_func_mismatch_argtypes = config_switch(w2);
 		}
+		else if(strcmpi(w1,"sql_async_workers")==0) {
+			script_config.sql_async_workers = cap_value(atoi(w2), 1, 32);
+		}
+		else if(strcmpi(w1,"sql_async_timeout")==0) {
+			script_config.sql_async_timeout = max(atoi(w2), 1);
+		}
 		else if(strcmpi(w1,"import")==0){
 			script_config_read(w2);
 		}
@@ -4750,6 +4844,8 @@ void do_final_script() {
 	DBIterator *iter;
 	struct script_state *st;
 
+	do_final_script_sql();
+
 #ifdef DEBUG_HASH
 	if (battle_config.etc_log)
 	{
@@ -4832,6 +4928,12 @@ void do_final_script() {
 	if( atcmd_binding_count != 0 )
 		aFree(atcmd_binding);
 
+	if( sleep_timer != INVALID_TIMER ){
+		delete_timer( sleep_timer, script_sleep_timer );
+		sleep_timer = INVALID_TIMER;
+	}
+	sleep_queue.clear();
+
 	ers_destroy(st_ers);
 	ers_destroy(stack_ers);
 	db_destroy(st_db);
@@ -4855,7 +4957,7 @@ void do_init_script(void) {
 	stack_ers = ers_new(sizeof(struct script_stack), "script.cpp::script_stack", ERS_OPT_FLEX_CHUNK);
 	array_ers = ers_new(sizeof(struct script_array), "script.cpp:array_ers", ERS_CLEAN_OPTIONS);
 
-	add_timer_func_list( run_script_timer, "run_script_timer" );
+	add_timer_func_list( script_sleep_timer, "script_sleep_timer" );
 
 	ers_chunk_size(st_ers, 10);
 	ers_chunk_size(stack_ers, 10);
@@ -4872,6 +4974,8 @@ void do_init_script(void) {
 	new( dummy_sd ) map_session_data();
 	dummy_sd->group_id = 99;
 	dummy_sd->fd = 0;
+
+	do_init_script_sql();
 }
 
 void script_reload(void) {
@@ -10019,6 +10123,37 @@ BUILDIN_FUNC(traitstatusup2)
 	return SCRIPT_CMD_SUCCESS;
 }
 
+/**
+ * Checks whether the first value of a bonus is a skill, those bonuses accept skill names
+ * @param type: Bonus type
+ * @return true if the first value is a skill
+ */
+static bool script_bonus_skill_type( int32 type ){
+	switch( type ){
+		case SP_AUTOSPELL:
+		case SP_AUTOSPELL_WHENHIT:
+		case SP_AUTOSPELL_ONSKILL:
+		case SP_SKILL_ATK:
+		case SP_SKILL_HEAL:
+		case SP_SKILL_HEAL2:
+		case SP_ADD_SKILL_BLOW:
+		case SP_CASTRATE:
+		case SP_ADDEFF_ONSKILL:
+		case SP_SKILL_USE_SP_RATE:
+		case SP_SKILL_COOLDOWN:
+		case SP_SKILL_FIXEDCAST:
+		case SP_SKILL_VARIABLECAST:
+		case SP_VARCASTRATE:
+		case SP_FIXCASTRATE:
+		case SP_SKILL_DELAY:
+		case SP_SKILL_USE_SP:
+		case SP_SUB_SKILL:
+			return true;
+		default:
+			return false;
+	}
+}
+
 /// See 'doc/item_bonus.txt'
 ///
 /// bonus <bonus type>,<val1>;
@@ -10040,47 +10175,25 @@ BUILDIN_FUNC(bonus)
 		return SCRIPT_CMD_SUCCESS; // no player attached
 
 	type = script_getnum(st,2);
-	switch( type ) {
-		case SP_AUTOSPELL:
-		case SP_AUTOSPELL_WHENHIT:
-		case SP_AUTOSPELL_ONSKILL:
-		case SP_SKILL_ATK:
-		case SP_SKILL_HEAL:
-		case SP_SKILL_HEAL2:
-		case SP_ADD_SKILL_BLOW:
-		case SP_CASTRATE:
-		case SP_ADDEFF_ONSKILL:
-		case SP_SKILL_USE_SP_RATE:
-		case SP_SKILL_COOLDOWN:
-		case SP_SKILL_FIXEDCAST:
-		case SP_SKILL_VARIABLECAST:
-		case SP_VARCASTRATE:
-		case SP_FIXCASTRATE:
-		case SP_SKILL_DELAY:
-		case SP_SKILL_USE_SP:
-		case SP_SUB_SKILL:
-			// these bonuses support skill names
-			if (script_isstring(st, 3)) {
-				const char *name = script_getstr(st, 3);
+	if( script_bonus_skill_type( type ) ){
+		// these bonuses support skill names
+		if (script_isstring(st, 3)) {
+			const char *name = script_getstr(st, 3);
 
-				if (!(val1 = skill_name2id(name))) {
-					ShowError("buildin_bonus: Invalid skill name %s passed to item bonus. Skipping.\n", name);
-					return SCRIPT_CMD_FAILURE;
-				}
-			} else {
-				val1 = script_getnum(st, 3);
+			if (!(val1 = skill_name2id(name))) {
+				ShowError("buildin_bonus: Invalid skill name %s passed to item bonus. Skipping.\n", name);
+				return SCRIPT_CMD_FAILURE;
+			}
+		} else {
+			val1 = script_getnum(st, 3);
 
-				if (strcmpi(script_getfuncname(st), "bonus") && !skill_get_index(val1)) { // Only check skill ID for bonus2, bonus3, bonus4, or bonus5
-					ShowError("buildin_bonus: Invalid skill ID %d passed to item bonus. Skipping.\n", val1);
-					return SCRIPT_CMD_FAILURE;
-				}
+			if (strcmpi(script_getfuncname(st), "bonus") && !skill_get_index(val1)) { // Only check skill ID for bonus2, bonus3, bonus4, or bonus5
+				ShowError("buildin_bonus: Invalid skill ID %d passed to item bonus. Skipping.\n", val1);
+				return SCRIPT_CMD_FAILURE;
 			}
-			break;
-		default:
-			if (script_hasdata(st, 3))
-				val1 = script_getnum(st, 3);
-			break;
-	}
+		}
+	} else if (script_hasdata(st, 3))
+		val1 = script_getnum(st, 3);
 
 	switch( script_lastdata(st)-2 ) {
 		case 0:
@@ -10125,6 +10238,106 @@ BUILDIN_FUNC(bonus)
 	return SCRIPT_CMD_SUCCESS;
 }
 
+/**
+ * Lowers a script that only consists of bonus calls with constant values to a list of bonuses
+ * @param code: Script to lower
+ * @param bonuses: Filled with the bonus calls in script order
+ * @return true if the whole script was lowered, false if it has to be run by the script engine
+ */
+bool script_compile_bonus( struct script_code* code, std::vector<s_script_bonus>& bonuses ){
+	bonuses.clear();
+
+	if( code == nullptr )
+		return false;
+
+	unsigned char* buf = code->script_buf;
+	int32 pos = 0;
+
+	for( ;; ){
+		switch( get_com( buf, &pos ) ){
+			case C_NOP:
+				return true;
+			case C_NAME:
+				break;
+			default:
+				return false;
+		}
+
+		int32 func = GETVALUE( buf, pos );
+
+		pos += 3;
+
+		if( str_data[func].type != C_FUNC || str_data[func].func != buildin_bonus || get_com( buf, &pos ) != C_ARG )
+			return false;
+
+		int64 args[6];
+		size_t argc = 0;
+
+		for( c_op op = get_com( buf, &pos ); op != C_FUNC; op = get_com( buf, &pos ) ){
+			if( op != C_INT || argc == ARRAYLENGTH( args ) )
+				return false;
+
+			int64 value = get_num( buf, &pos );
+
+			// Negative values are followed by the negation operator
+			for( int32 next = pos; get_com( buf, &next ) == C_NEG; pos = next ){
+				value = -value;
+			}
+
+			if( value < INT32_MIN || value > INT32_MAX )
+				return false;
+
+			args[argc++] = value;
+		}
+
+		if( argc == 0 || get_com( buf, &pos ) != C_EOL )
+			return false;
+
+		s_script_bonus bonus = {};
+
+		bonus.type = static_cast<int32>( args[0] );
+		bonus.count = static_cast<uint8>( argc - 1 );
+
+		for( uint8 i = 0; i < bonus.count; i++ ){
+			bonus.values[i] = static_cast<int32>( args[i + 1] );
+		}
+
+		// Invalid skills are reported by the script engine
+		if( script_bonus_skill_type( bonus.type ) && strcmpi( get_str( func ), "bonus" ) && !skill_get_index( bonus.values[0] ) )
+			return false;
+
+		bonuses.push_back( bonus );
+	}
+}
+
+/**
+ * Applies a list of bonuses lowered by script_compile_bonus, same as running the script
+ * @param sd: Player receiving the bonuses
+ * @param bonuses: Bonus calls
+ */
+void script_run_bonus( map_session_data* sd, const std::vector<s_script_bonus>& bonuses ){
+	for( const s_script_bonus& bonus : bonuses ){
+		switch( bonus.count ){
+			case 0:
+			case 1:
+				pc_bonus( sd, bonus.type, bonus.values[0] );
+				break;
+			case 2:
+				pc_bonus2( sd, bonus.type, bonus.values[0], bonus.values[1] );
+				break;
+			case 3:
+				pc_bonus3( sd, bonus.type, bonus.values[0], bonus.values[1], bonus.values[2] );
+				break;
+			case 4:
+				pc_bonus4( sd, bonus.type, bonus.values[0], bonus.values[1], bonus.values[2], bonus.values[3] );
+				break;
+			case 5:
+				pc_bonus5( sd, bonus.type, bonus.values[0], bonus.values[1], bonus.values[2], bonus.values[3], bonus.values[4] );
+				break;
+		}
+	}
+}
+
 BUILDIN_FUNC(autobonus)
 {
 	uint32 dur, pos;
@@ -18038,37 +18251,71 @@ BUILDIN_FUNC(setd)
 	return SCRIPT_CMD_SUCCESS;
 }
 
-int32 buildin_query_sql_sub(struct script_state* st, Sql* handle)
+/**
+ * Checks the target variables of query_sql and query_sql_async
+ * @param st: Script state
+ * @param sd: Set to the attached player if a character variable is used
+ * @return Number of variables or -1 on failure
+ */
+static int32 buildin_query_sql_vars(struct script_state* st, map_session_data*& sd)
 {
-	int32 i, j;
-	TBL_PC* sd = nullptr;
-	const char* query;
-	struct script_data* data;
-	const char* name;
-	uint32 max_rows = SCRIPT_MAX_ARRAYSIZE; // maximum number of rows
-	int32 num_vars;
-	int32 num_cols;
+	int32 i;
 
-	// check target variables
 	for( i = 3; script_hasdata(st,i); ++i ) {
-		data = script_getdata(st, i);
+		struct script_data* data = script_getdata(st, i);
+
 		if( data_isreference(data) ) { // it's a variable
-			name = reference_getname(data);
+			const char* name = reference_getname(data);
+
 			if( not_server_variable(*name) && sd == nullptr ) { // requires a player
 				if( !script_rid2sd(sd) ) { // no player attached
 					script_reportdata(data);
 					st->state = END;
-					return SCRIPT_CMD_FAILURE;
+					return -1;
 				}
 			}
 		} else {
 			ShowError("script:query_sql: not a variable\n");
 			script_reportdata(data);
 			st->state = END;
-			return SCRIPT_CMD_FAILURE;
+			return -1;
 		}
 	}
-	num_vars = i - 3;
+
+	return i - 3;
+}
+
+/**
+ * Stores a column value of a query_sql result in the target variable
+ * @param st: Script state
+ * @param sd: Attached player, if required
+ * @param var: Index of the target variable
+ * @param row: Row number, used as array index
+ * @param str: Column value or nullptr
+ */
+static void buildin_query_sql_store(struct script_state* st, map_session_data* sd, int32 var, uint32 row, const char* str)
+{
+	struct script_data* data = script_getdata(st, var+3);
+	const char* name = reference_getname(data);
+
+	if( is_string_variable(name) )
+		setd_sub_str( st, sd, name, row, str ? str : "", reference_getref( data ) );
+	else
+		setd_sub_num( st, sd, name, row, str ? strtoll( str, nullptr, 10 ) : 0, reference_getref( data ) );
+}
+
+int32 buildin_query_sql_sub(struct script_state* st, Sql* handle)
+{
+	int32 i, j;
+	TBL_PC* sd = nullptr;
+	const char* query;
+	uint32 max_rows = SCRIPT_MAX_ARRAYSIZE; // maximum number of rows
+	int32 num_vars;
+	int32 num_cols;
+
+	// check target variables
+	if( ( num_vars = buildin_query_sql_vars(st, sd) ) < 0 )
+		return SCRIPT_CMD_FAILURE;
 
 	// Execute the query
 	query = script_getstr(st,2);
@@ -18103,13 +18350,7 @@ int32 buildin_query_sql_sub(struct script_state* st, Sql* handle)
 			if( j < num_cols )
 				Sql_GetData(handle, j, &str, nullptr);
 
-			data = script_getdata(st, j+3);
-			name = reference_getname(data);
-
-			if( is_string_variable(name) )
-				setd_sub_str( st, sd, name, i, str ? str : "", reference_getref( data ) );
-			else
-				setd_sub_num( st, sd, name, i, str ? strtoll( str, nullptr, 10 ) : 0, reference_getref( data ) );
+			buildin_query_sql_store(st, sd, j, i, str);
 		}
 	}
 	if( i == max_rows && max_rows < Sql_NumRows(handle) ) {
@@ -18123,6 +18364,86 @@ int32 buildin_query_sql_sub(struct script_state* st, Sql* handle)
 	return SCRIPT_CMD_SUCCESS;
 }
 
+/**
+ * Runs a query on a worker connection, the script sleeps until the result arrived
+ * @param st: Script state
+ * @param db: Target database
+ */
+static int32 buildin_query_sql_async_sub(struct script_state* st, e_script_sql_db db)
+{
+	TBL_PC* sd = nullptr;
+	int32 num_vars;
+
+	// check target variables
+	if( ( num_vars = buildin_query_sql_vars(st, sd) ) < 0 )
+		return SCRIPT_CMD_FAILURE;
+
+	// First call(by function call)
+	if( st->sleep.tick == 0 ) {
+		if( !script_sql_async_query(db, st->id, script_getstr(st,2), SCRIPT_MAX_ARRAYSIZE) ) {
+			ShowError("script:query_sql_async: The script is already waiting for a query.\n");
+			script_reportsrc(st);
+			script_pushint(st, -1);
+			return SCRIPT_CMD_FAILURE;
+		}
+
+		// sleep until the result arrived or the timeout is reached
+		st->state = RERUNLINE;
+		st->sleep.tick = script_config.sql_async_timeout;
+		return SCRIPT_CMD_SUCCESS;
+	}
+
+	// Second call(woken up by the result or the timeout)
+	st->state = RUN;
+	st->sleep.tick = 0;
+
+	std::shared_ptr<s_script_sql_request> request = script_sql_async_result(st->id);
+
+	if( request == nullptr || !request->finished ) {
+		ShowWarning("script:query_sql_async: Query did not finish within %d ms, result discarded.\n", script_config.sql_async_timeout);
+		script_reportsrc(st);
+		script_pushint(st, -1);
+		return SCRIPT_CMD_FAILURE;
+	}
+
+	if( !request->success ) {
+		script_pushint(st, -1);
+		return SCRIPT_CMD_FAILURE;
+	}
+
+	if( request->num_rows == 0 ) { // No data received
+		script_pushint(st, 0);
+		return SCRIPT_CMD_SUCCESS;
+	}
+
+	// Count the number of columns to store
+	int32 num_cols = request->num_cols;
+
+	if( num_vars < num_cols ) {
+		ShowWarning("script:query_sql_async: Too many columns, discarding last %u columns.\n", (uint32)(num_cols-num_vars));
+		script_reportsrc(st);
+	} else if( num_vars > num_cols ) {
+		ShowWarning("script:query_sql_async: Too many variables (%u extra).\n", (uint32)(num_vars-num_cols));
+		script_reportsrc(st);
+	}
+
+	// Store data
+	uint32 i;
+
+	for( i = 0; i < request->rows.size(); ++i ) {
+		for( int32 j = 0; j < num_vars; ++j ) {
+			buildin_query_sql_store(st, sd, j, i, j < num_cols ? request->rows[i][j].c_str() : nullptr);
+		}
+	}
+	if( i < request->num_rows ) {
+		ShowWarning("script:query_sql_async: Only %u/%" PRIu64 " rows have been stored.\n", i, request->num_rows);
+		script_reportsrc(st);
+	}
+
+	script_pushint(st, i);
+	return SCRIPT_CMD_SUCCESS;
+}
+
 BUILDIN_FUNC(query_sql) {
 	return buildin_query_sql_sub(st, qsmysql_handle);
 }
@@ -18137,6 +18458,20 @@ BUILDIN_FUNC(query_logsql) {
 	return buildin_query_sql_sub(st, logmysql_handle);
 }
 
+BUILDIN_FUNC(query_sql_async) {
+	return buildin_query_sql_async_sub(st, SCRIPT_SQL_MAP);
+}
+
+BUILDIN_FUNC(query_logsql_async) {
+	if( !log_config.sql_logs ) {// logmysql_handle == nullptr
+		ShowWarning("buildin_query_logsql_async: SQL logs are disabled, query '%s' will not be executed.\n", script_getstr(st,2));
+		script_pushint(st,-1);
+		return SCRIPT_CMD_FAILURE;
+	}
+
+	return buildin_query_sql_async_sub(st, SCRIPT_SQL_LOG);
+}
+
 //Allows escaping of a given string.
 BUILDIN_FUNC(escape_sql)
 {
@@ -19457,7 +19792,7 @@ BUILDIN_FUNC(setunitdata)
 				status_calc_bl_(md, status_db.getSCB_BATTLE());
 				unit_refresh(bl);
 				break;
-			case UMOB_AI: md->special_state.ai = (enum mob_ai)value; break;
+			case UMOB_AI: md->special_state.ai = (enum mob_ai)value; map_presence_refresh(*md); break;
 			case UMOB_SCOPTION: md->sc.option = (uint16)value; break;
 			case UMOB_SEX: md->vd->sex = (char)value; unit_refresh(bl); break;
 			case UMOB_CLASS: status_set_viewdata(bl, (uint16)value); unit_refresh(bl); break;
@@ -20415,7 +20750,7 @@ BUILDIN_FUNC(sleep2)
 	// Second call(by timer after sleeping time is over)
 	} else {		
 		// Check if the unit is still attached
-		// NOTE: This should never happen, since run_script_timer already checks this
+		// NOTE: This should never happen, since script_sleep_resume already checks this
 		if (map_id2bl(st->rid) == nullptr) {
 			// The unit is not attached anymore - terminate the script
 			st->rid = 0;
@@ -20455,14 +20790,11 @@ BUILDIN_FUNC(awake)
 
 	for (tst = static_cast<script_state *>(dbi_first(iter)); dbi_exists(iter); tst = static_cast<script_state *>(dbi_next(iter))) {
 		if (tst->oid == nd->id) {
-			if (tst->sleep.timer == INVALID_TIMER) { // already awake ???
+			if (!tst->sleep.suspended) { // already awake ???
 				continue;
 			}
 
-			delete_timer(tst->sleep.timer, run_script_timer);
-
-			// Trigger the timer function
-			run_script_timer(INVALID_TIMER, gettick(), tst->sleep.charid, (intptr_t)tst);
+			script_sleep_resume(tst);
 		}
 	}
 	dbi_destroy(iter);
@@ -28232,6 +28564,8 @@ struct script_function buildin_func[] = {
 	BUILDIN_DEF(axtoi,"s"),
 	BUILDIN_DEF(query_sql,"s*"),
 	BUILDIN_DEF(query_logsql,"s*"),
+	BUILDIN_DEF(query_sql_async,"s*"),
+	BUILDIN_DEF(query_logsql_async,"s*"),
 	BUILDIN_DEF(escape_sql,"v"),
 	BUILDIN_DEF(atoi,"s"),
 	BUILDIN_DEF(strtol,"si"),
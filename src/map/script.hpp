@@ -4,6 +4,8 @@
 #ifndef SCRIPT_HPP
 #define SCRIPT_HPP
 
+#include <vector>
+
 #include <ryml_std.hpp>
 #include <ryml.hpp>
 
@@ -157,6 +159,8 @@ struct Script_Config {
 	int32 check_gotocount;
 	int32 input_min_value;
 	int32 input_max_value;
+	int32 sql_async_workers;
+	int32 sql_async_timeout;
 
 	// PC related
 	const char *die_event_name;
@@ -299,6 +303,13 @@ struct script_code {
 	uint16 instances;
 };
 
+/// Bonus call with constant values, see script_compile_bonus
+struct s_script_bonus {
+	int32 type;
+	int32 values[5];
+	uint8 count; ///< Number of values passed
+};
+
 struct script_stack {
 	int32 sp;                         ///< number of entries in the stack
 	int32 sp_max;                     ///< capacity of the stack
@@ -321,7 +332,9 @@ struct script_state {
 	int32 rid,oid;
 	struct script_code *script;
 	struct sleep_data {
-		int32 tick,timer,charid;
+		int32 tick,charid;
+		t_tick wakeup; ///< Tick the state is scheduled to resume at
+		bool suspended; ///< State is parked in the sleep queue
 	} sleep;
 	//For backing up purposes
 	struct script_state *bk_st;
@@ -2298,6 +2311,8 @@ bool is_number(const char *p);
 struct script_code* parse_script_( const char *src, const char *file, int32 line, int32 options, const char* src_file, int32 src_line, const char* src_func );
 #define parse_script( src, file, line, options ) parse_script_( ( src ), ( file ), ( line ), ( options ), ALC_MARK )
 void run_script(struct script_code *rootscript,int32 pos,int32 rid,int32 oid);
+bool script_compile_bonus( struct script_code* code, std::vector<s_script_bonus>& bonuses );
+void script_run_bonus( map_session_data* sd, const std::vector<s_script_bonus>& bonuses );
 
 bool set_reg_num(struct script_state* st, map_session_data* sd, int64 num, const char* name, const int64 value, struct reg_db *ref);
 bool set_reg_str(struct script_state* st, map_session_data* sd, int64 num, const char* name, const char* value, struct reg_db* ref);
@@ -2307,9 +2322,10 @@ int64 conv_num64(struct script_state *st, struct script_data *data);
 int32 conv_num(struct script_state *st, struct script_data *data);
 const char* conv_str(struct script_state *st,struct script_data *data);
 void pop_stack(struct script_state* st, int32 start, int32 end);
-TIMER_FUNC(run_script_timer);
+TIMER_FUNC(script_sleep_timer);
 void script_stop_sleeptimers(int32 id);
-struct linkdb_node *script_erase_sleepdb(struct linkdb_node *n);
+void script_sleep_wakeup(uint32 id);
+void script_sleep_report(void);
 void script_attach_state(struct script_state* st);
 void script_detach_rid(struct script_state* st);
 void run_script_main(struct script_state *st);
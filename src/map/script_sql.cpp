@@ -0,0 +1,412 @@
+// Copyright (c) rAthena Dev Teams - Licensed under GNU GPL
+// For more information, see LICENCE in the main folder
+
+#include "script_sql.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <errmsg.h> // CR_SERVER_GONE_ERROR, CR_SERVER_LOST
+
+#include <common/showmsg.hpp>
+#include <common/sql.hpp>
+#include <common/utilities.hpp>
+
+#include "map.hpp"
+#include "script.hpp"
+
+using namespace rathena;
+
+// NOTE: The workers must not use the Sql wrapper (keepalive timers) or the console output,
+// neither of them is thread safe. Results are reported on the main thread instead.
+
+/// Connection settings of a database, copied at initialization
+struct s_script_sql_server {
+	std::string ip;
+	uint16 port;
+	std::string user;
+	std::string password;
+	std::string db;
+	std::string codepage;
+};
+
+static s_script_sql_server script_sql_servers[SCRIPT_SQL_MAX];
+
+static std::vector<std::thread> script_sql_workers;
+static std::mutex script_sql_mutex;
+static std::condition_variable script_sql_cond;
+static std::deque<std::shared_ptr<s_script_sql_request>> script_sql_pending; // guarded by script_sql_mutex
+static std::vector<std::shared_ptr<s_script_sql_request>> script_sql_finished; // guarded by script_sql_mutex
+static bool script_sql_shutdown; // guarded by script_sql_mutex
+
+// Main thread only
+static std::unordered_map<uint32, std::shared_ptr<s_script_sql_request>> script_sql_requests; // script state id -> request
+static int32 script_sql_timer = INVALID_TIMER;
+
+static struct s_script_sql_stats {
+	uint64 submitted;
+	uint64 completed;
+	uint64 failed;
+	uint64 canceled; ///< Timed out or the script state was freed
+	uint64 dequeued; ///< Canceled before a worker picked them up
+	size_t peak; ///< Highest number of requests in flight
+	t_tick total_time; ///< Summed time from submission to result of completed queries
+} script_sql_stats;
+
+/**
+ * Opens a worker connection to a database
+ * @param db: Target database
+ * @param error: Filled with the error message on failure
+ * @return Connection or nullptr
+ */
+static MYSQL* script_sql_connect( e_script_sql_db db, std::string& error ){
+	const s_script_sql_server& server = script_sql_servers[db];
+	MYSQL* handle = mysql_init( nullptr );
+
+	if( handle == nullptr ){
+		error = "mysql_init failed";
+		return nullptr;
+	}
+
+#if !defined(MARIADB_BASE_VERSION) && !defined(MARIADB_VERSION_ID) && MYSQL_VERSION_ID >= 50710
+	uint32 md = SSL_MODE_DISABLED;
+
+	mysql_options( handle, MYSQL_OPT_SSL_MODE, &md );
+#endif
+
+	// Do not block a worker forever on a stuck query, the script stopped waiting long ago anyway
+	uint32 read_timeout = std::max( script_config.sql_async_timeout / 1000, 1 );
+
+	mysql_options( handle, MYSQL_OPT_READ_TIMEOUT, &read_timeout );
+
+	if( !mysql_real_connect( handle, server.ip.c_str(), server.user.c_str(), server.password.c_str(), server.db.c_str(), server.port, nullptr, 0 ) ){
+		error = mysql_error( handle );
+		mysql_close( handle );
+		return nullptr;
+	}
+
+	if( !server.codepage.empty() && mysql_set_character_set( handle, server.codepage.c_str() ) != 0 ){
+		error = mysql_error( handle );
+		mysql_close( handle );
+		return nullptr;
+	}
+
+	return handle;
+}
+
+/**
+ * Executes a request on a worker connection and stores the result in it
+ * @param handle: Worker connection of the request's database, (re)connected if needed
+ * @param request: Request to execute
+ */
+static void script_sql_execute( MYSQL*& handle, s_script_sql_request& request ){
+	for( int32 attempt = 0; attempt < 2; attempt++ ){
+		if( handle == nullptr && ( handle = script_sql_connect( request.db, request.error ) ) == nullptr )
+			return;
+
+		if( mysql_real_query( handle, request.query.c_str(), static_cast<unsigned long>( request.query.length() ) ) == 0 )
+			break;
+
+		uint32 error = mysql_errno( handle );
+
+		request.error = mysql_error( handle );
+
+		// The connection was lost, reconnect once
+		if( attempt == 0 && ( error == CR_SERVER_GONE_ERROR || error == CR_SERVER_LOST ) ){
+			mysql_close( handle );
+			handle = nullptr;
+			continue;
+		}
+
+		return;
+	}
+
+	MYSQL_RES* result = mysql_store_result( handle );
+
+	if( result == nullptr ){
+		if( mysql_errno( handle ) != 0 ){
+			request.error = mysql_error( handle );
+			return;
+		}
+
+		// Statement without a result set
+		request.error.clear();
+		request.success = true;
+		return;
+	}
+
+	request.error.clear();
+	request.num_rows = mysql_num_rows( result );
+	request.num_cols = mysql_num_fields( result );
+
+	MYSQL_ROW row;
+
+	while( request.rows.size() < request.max_rows && ( row = mysql_fetch_row( result ) ) != nullptr ){
+		unsigned long* lengths = mysql_fetch_lengths( result );
+		std::vector<std::string> columns( request.num_cols );
+
+		for( uint32 i = 0; i < request.num_cols; i++ ){
+			if( row[i] != nullptr )
+				columns[i].assign( row[i], lengths[i] );
+		}
+
+		request.rows.push_back( std::move( columns ) );
+	}
+
+	mysql_free_result( result );
+	request.success = true;
+}
+
+/**
+ * Worker thread, runs pending requests on its own connections until shutdown
+ */
+static void script_sql_worker( void ){
+	MYSQL* handles[SCRIPT_SQL_MAX] = {};
+
+	mysql_thread_init();
+
+	for( ;; ){
+		std::shared_ptr<s_script_sql_request> request;
+
+		{
+			std::unique_lock<std::mutex> lock( script_sql_mutex );
+
+			script_sql_cond.wait( lock, []{ return script_sql_shutdown || !script_sql_pending.empty(); } );
+
+			if( script_sql_shutdown )
+				break;
+
+			request = script_sql_pending.front();
+			script_sql_pending.pop_front();
+		}
+
+		script_sql_execute( handles[request->db], *request );
+
+		{
+			std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+			request->finished = true;
+			script_sql_finished.push_back( request );
+		}
+	}
+
+	for( MYSQL* handle : handles ){
+		if( handle != nullptr )
+			mysql_close( handle );
+	}
+
+	mysql_thread_end();
+}
+
+static TIMER_FUNC( script_sql_async_timer );
+
+/**
+ * Starts collecting finished requests, if not already running
+ */
+static void script_sql_async_arm( void ){
+	if( script_sql_timer == INVALID_TIMER )
+		script_sql_timer = add_timer( gettick() + SCRIPT_SQL_ASYNC_INTERVAL, script_sql_async_timer, 0, 0 );
+}
+
+/**
+ * Removes a request from the queue, so that no worker runs a query whose result is not needed anymore.
+ * The caller must hold script_sql_mutex.
+ * @param request: Canceled request
+ */
+static void script_sql_dequeue( const std::shared_ptr<s_script_sql_request>& request ){
+	auto it = std::find( script_sql_pending.begin(), script_sql_pending.end(), request );
+
+	if( it == script_sql_pending.end() )
+		return;
+
+	script_sql_pending.erase( it );
+	script_sql_stats.dequeued++;
+}
+
+/**
+ * Collects finished requests and wakes up the waiting script states.
+ * Only armed while requests are outstanding.
+ */
+static TIMER_FUNC( script_sql_async_timer ){
+	std::vector<std::shared_ptr<s_script_sql_request>> finished;
+
+	script_sql_timer = INVALID_TIMER;
+
+	{
+		std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+		finished.swap( script_sql_finished );
+	}
+
+	for( std::shared_ptr<s_script_sql_request>& request : finished ){
+		std::shared_ptr<s_script_sql_request> current = util::umap_find( script_sql_requests, request->st_id );
+
+		// Canceled in the meantime, the result is not needed anymore
+		if( current != request )
+			continue;
+
+		script_sql_stats.completed++;
+		script_sql_stats.total_time += DIFF_TICK( tick, request->start );
+
+		if( !request->success ){
+			script_sql_stats.failed++;
+			ShowSQL( "DB error - %s\n", request->error.c_str() );
+			ShowDebug( "at %s:%d - %s\n", __FILE__, __LINE__, request->query.c_str() );
+		}
+
+		script_sleep_wakeup( request->st_id );
+	}
+
+	if( !script_sql_requests.empty() )
+		script_sql_async_arm();
+
+	return 0;
+}
+
+/**
+ * Submits an asynchronous query for a script state
+ * @param db: Target database
+ * @param st_id: Script state waiting for the result
+ * @param query: Query to execute
+ * @param max_rows: Rows to fetch at most
+ * @return true on success, false if the state already waits for a query
+ */
+bool script_sql_async_query( e_script_sql_db db, uint32 st_id, const char* query, uint32 max_rows ){
+	if( script_sql_requests.find( st_id ) != script_sql_requests.end() )
+		return false;
+
+	std::shared_ptr<s_script_sql_request> request = std::make_shared<s_script_sql_request>();
+
+	request->st_id = st_id;
+	request->db = db;
+	request->query = query;
+	request->max_rows = max_rows;
+	request->start = gettick();
+	request->finished = false;
+	request->success = false;
+	request->num_rows = 0;
+	request->num_cols = 0;
+
+	script_sql_requests[st_id] = request;
+	script_sql_stats.submitted++;
+	script_sql_stats.peak = std::max( script_sql_stats.peak, script_sql_requests.size() );
+
+	{
+		std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+		script_sql_pending.push_back( request );
+	}
+
+	script_sql_cond.notify_one();
+	script_sql_async_arm();
+
+	return true;
+}
+
+/**
+ * Takes the request of a script state, finished or not
+ * @param st_id: Script state id
+ * @return Request or nullptr if the state has none
+ */
+std::shared_ptr<s_script_sql_request> script_sql_async_result( uint32 st_id ){
+	auto it = script_sql_requests.find( st_id );
+
+	if( it == script_sql_requests.end() )
+		return nullptr;
+
+	std::shared_ptr<s_script_sql_request> request = it->second;
+
+	script_sql_requests.erase( it );
+
+	// Only read the result fields once the worker handed the request back
+	std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+	if( !request->finished ){
+		script_sql_stats.canceled++;
+		script_sql_dequeue( request );
+	}
+
+	return request;
+}
+
+/**
+ * Drops the request of a script state, its result will be discarded
+ * @param st_id: Script state id
+ */
+void script_sql_async_cancel( uint32 st_id ){
+	if( script_sql_requests.empty() )
+		return;
+
+	auto it = script_sql_requests.find( st_id );
+
+	if( it == script_sql_requests.end() )
+		return;
+
+	std::shared_ptr<s_script_sql_request> request = it->second;
+
+	script_sql_requests.erase( it );
+	script_sql_stats.canceled++;
+
+	std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+	script_sql_dequeue( request );
+}
+
+/**
+ * Displays statistics of the asynchronous queries
+ */
+void script_sql_async_report( void ){
+	size_t pending;
+
+	{
+		std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+		pending = script_sql_pending.size();
+	}
+
+	ShowInfo( "Async SQL: " CL_WHITE "%" PRIuPTR CL_RESET " in flight (" CL_WHITE "%" PRIuPTR CL_RESET " queued, peak " CL_WHITE "%" PRIuPTR CL_RESET ") on " CL_WHITE "%" PRIuPTR CL_RESET " workers.\n", script_sql_requests.size(), pending, script_sql_stats.peak, script_sql_workers.size() );
+	ShowInfo( "Async SQL: " CL_WHITE "%" PRIu64 CL_RESET " submitted, " CL_WHITE "%" PRIu64 CL_RESET " completed (" CL_WHITE "%" PRIu64 CL_RESET " failed, avg " CL_WHITE "%" PRId64 CL_RESET " ms), " CL_WHITE "%" PRIu64 CL_RESET " canceled (" CL_WHITE "%" PRIu64 CL_RESET " before running).\n",
+		script_sql_stats.submitted, script_sql_stats.completed, script_sql_stats.failed,
+		script_sql_stats.completed > 0 ? static_cast<int64>( script_sql_stats.total_time / script_sql_stats.completed ) : 0, script_sql_stats.canceled, script_sql_stats.dequeued );
+}
+
+void do_init_script_sql( void ){
+	script_sql_servers[SCRIPT_SQL_MAP] = { map_server_ip, static_cast<uint16>( map_server_port ), map_server_id, map_server_pw, map_server_db, default_codepage };
+	script_sql_servers[SCRIPT_SQL_LOG] = { log_db_ip, log_db_port, log_db_id, log_db_pw, log_db_db, log_codepage.empty() ? default_codepage : log_codepage };
+
+	script_sql_shutdown = false;
+
+	for( int32 i = 0; i < script_config.sql_async_workers; i++ ){
+		script_sql_workers.emplace_back( script_sql_worker );
+	}
+
+	add_timer_func_list( script_sql_async_timer, "script_sql_async_timer" );
+}
+
+void do_final_script_sql( void ){
+	if( script_sql_timer != INVALID_TIMER ){
+		delete_timer( script_sql_timer, script_sql_async_timer );
+		script_sql_timer = INVALID_TIMER;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( script_sql_mutex );
+
+		script_sql_shutdown = true;
+		script_sql_pending.clear();
+	}
+
+	script_sql_cond.notify_all();
+
+	for( std::thread& worker : script_sql_workers ){
+		worker.join();
+	}
+
+	script_sql_workers.clear();
+	script_sql_finished.clear();
+	script_sql_requests.clear();
+}
@@ -0,0 +1,49 @@
+// Copyright (c) rAthena Dev Teams - Licensed under GNU GPL
+// For more information, see LICENCE in the main folder
+
+#ifndef SCRIPT_SQL_HPP
+#define SCRIPT_SQL_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common/cbasetypes.hpp>
+#include <common/timer.hpp>
+
+/// Interval in milliseconds in which finished asynchronous queries are collected while any are outstanding
+#define SCRIPT_SQL_ASYNC_INTERVAL 10
+
+enum e_script_sql_db : uint8 {
+	SCRIPT_SQL_MAP = 0, ///< Main database, used by query_sql_async
+	SCRIPT_SQL_LOG, ///< Log database, used by query_logsql_async
+	SCRIPT_SQL_MAX
+};
+
+/// Asynchronous query of a script state, executed on a worker connection
+/// Everything but the result fields is only accessed by the main thread
+struct s_script_sql_request {
+	uint32 st_id; ///< Script state waiting for the result
+	e_script_sql_db db;
+	std::string query;
+	uint32 max_rows; ///< Rows to fetch at most
+	t_tick start; ///< Tick the query was submitted
+
+	// Result, written by the worker before the request is handed back
+	bool finished;
+	bool success;
+	std::string error; ///< MySQL error message on failure
+	uint64 num_rows; ///< Total rows of the result set
+	uint32 num_cols;
+	std::vector<std::vector<std::string>> rows; ///< Fetched rows, at most max_rows (NULL is stored as empty string)
+};
+
+bool script_sql_async_query( e_script_sql_db db, uint32 st_id, const char* query, uint32 max_rows );
+std::shared_ptr<s_script_sql_request> script_sql_async_result( uint32 st_id );
+void script_sql_async_cancel( uint32 st_id );
+void script_sql_async_report( void );
+
+void do_init_script_sql( void );
+void do_final_script_sql( void );
+
+#endif /* SCRIPT_SQL_HPP */
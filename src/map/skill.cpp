@@ -4,6 +4,7 @@
 #include "skill.hpp"
 
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -4166,7 +4167,24 @@ int64 skill_attack (int32 attack_type, block_list* src, block_list *dsrc, block_
  * Checking bl battle flag and display damage
  * then call func with source,target,skill_id,skill_lv,tick,flag
  *------------------------------------------*/
-typedef int32 (*SkillFunc)(block_list *, block_list *, int32, int32, t_tick, int32);
+typedef int32 (*SkillFunc)(block_list *, block_list *, uint16, uint16, t_tick, int32);
+static int32 skill_area_sub_apply(block_list *bl, block_list *src, uint16 skill_id, uint16 skill_lv, t_tick tick, int32 flag, SkillFunc func)
+{
+	nullpo_ret(bl);
+
+	if(battle_check_target(src,bl,flag) > 0) {
+		// several splash skills need this initial dummy packet to display correctly
+		if (flag&SD_PREAMBLE && skill_area_temp[2] == 0)
+			clif_skill_damage( *src, *bl, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
+
+		if (flag&(SD_SPLASH|SD_PREAMBLE))
+			skill_area_temp[2]++;
+
+		return func(src,bl,skill_id,skill_lv,tick,flag);
+	}
+	return 0;
+}
+
 int32 skill_area_sub(block_list *bl, va_list ap)
 {
 	block_list *src;
@@ -4175,8 +4193,6 @@ int32 skill_area_sub(block_list *bl, va_list ap)
 	t_tick tick;
 	SkillFunc func;
 
-	nullpo_ret(bl);
-
 	src = va_arg(ap,block_list *);
 	skill_id = va_arg(ap,int32);
 	skill_lv = va_arg(ap,int32);
@@ -4184,17 +4200,17 @@ int32 skill_area_sub(block_list *bl, va_list ap)
 	flag = va_arg(ap,int32);
 	func = va_arg(ap,SkillFunc);
 
-	if(battle_check_target(src,bl,flag) > 0) {
-		// several splash skills need this initial dummy packet to display correctly
-		if (flag&SD_PREAMBLE && skill_area_temp[2] == 0)
-			clif_skill_damage( *src, *bl, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
-
-		if (flag&(SD_SPLASH|SD_PREAMBLE))
-			skill_area_temp[2]++;
+	return skill_area_sub_apply(bl, src, skill_id, skill_lv, tick, flag, func);
+}
 
-		return func(src,bl,skill_id,skill_lv,tick,flag);
-	}
-	return 0;
+/**
+ * Binds the arguments of skill_area_sub for the typed map_foreach* functions
+ * The arguments are evaluated once, before the area is searched, as with skill_area_sub.
+ * @return Callable for map_foreach*
+ */
+static auto skill_area_sub_bind(block_list *src, uint16 skill_id, uint16 skill_lv, t_tick tick, int32 flag, SkillFunc func)
+{
+	return [=]( block_list* bl ){ return skill_area_sub_apply( bl, src, skill_id, skill_lv, tick, flag, func ); };
 }
 
 static int32 skill_check_unit_range_sub(block_list *bl, va_list ap)
@@ -4537,8 +4553,7 @@ static TIMER_FUNC(skill_timerskill){
 			if (skl->skill_id == SR_SKYNETBLOW) {
 				skill_area_temp[1] = 0;
 				clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skl->skill_id, skl->skill_lv, DMG_SINGLE );
-				map_foreachinallrange(skill_area_sub,src,skill_get_splash(skl->skill_id,skl->skill_lv),BL_CHAR|BL_SKILL,src,
-					skl->skill_id,skl->skill_lv,tick,skl->flag|BCT_ENEMY|SD_SPLASH|1,skill_castend_damage_id);
+				map_foreachinallrange(skill_area_sub_bind(src,skl->skill_id,skl->skill_lv,tick,skl->flag|BCT_ENEMY|SD_SPLASH|1,skill_castend_damage_id),src,skill_get_splash(skl->skill_id,skl->skill_lv),BL_CHAR|BL_SKILL);
 				break;
 			}
 
@@ -4806,7 +4821,7 @@ static TIMER_FUNC(skill_timerskill){
 						int32 splash = skill_get_splash(skl->skill_id, skl->skill_lv);
 
 						clif_skill_poseffect( *src, skl->skill_id, skl->skill_lv, tmpx, tmpy, tick );
-						map_foreachinarea(skill_area_sub, src->m, tmpx - splash, tmpy - splash, tmpx + splash, tmpy + splash, BL_CHAR, src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id);
+						map_foreachinarea(skill_area_sub_bind(src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id), src->m, tmpx - splash, tmpy - splash, tmpx + splash, tmpy + splash, BL_CHAR);
 						skill_unitsetting(src, skl->skill_id, skl->skill_lv, tmpx, tmpy, skill_get_unit_interval(skl->skill_id));
 					}
 					break;
@@ -4829,8 +4844,7 @@ static TIMER_FUNC(skill_timerskill){
 
 						tmpx = skl->x - range + rnd() % (range * 2 + 1);
 						tmpy = skl->y - range + rnd() % (range * 2 + 1);
-						map_foreachinarea(skill_area_sub, src->m, tmpx - range, tmpy - range, tmpx + range, tmpy + range, BL_CHAR,
-							src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+						map_foreachinarea(skill_area_sub_bind(src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), src->m, tmpx - range, tmpy - range, tmpx + range, tmpy + range, BL_CHAR);
 					}
 					break;
 
@@ -4840,7 +4854,7 @@ static TIMER_FUNC(skill_timerskill){
 						int16 tmpx = skl->x - area + rnd() % ( area * 2 + 1 );
 						int16 tmpy = skl->y - area + rnd() % ( area * 2 + 1 );
 
-						map_foreachinarea( skill_area_sub, src->m, tmpx - splash, tmpy - splash, tmpx + splash, tmpy + splash, BL_CHAR, src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id );
+						map_foreachinarea(skill_area_sub_bind(src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), src->m, tmpx - splash, tmpy - splash, tmpx + splash, tmpy + splash, BL_CHAR);
 					} break;
 
 				case SKE_STAR_CANNON: {
@@ -4851,7 +4865,7 @@ static TIMER_FUNC(skill_timerskill){
 							int16 tmpx = skl->x - area + rnd() % ( area * 2 + 1 );
 							int16 tmpy = skl->y - area + rnd() % ( area * 2 + 1 );
 
-							map_foreachinarea( skill_area_sub, src->m, tmpx - splash, tmpy - splash, tmpx + splash, tmpy + splash, BL_CHAR, src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id );
+							map_foreachinarea(skill_area_sub_bind(src, skl->skill_id, skl->skill_lv, tick, skl->flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), src->m, tmpx - splash, tmpy - splash, tmpx + splash, tmpy + splash, BL_CHAR);
 						}
 					} break;
 			}
@@ -5145,12 +5159,12 @@ bool skill_mirage_cast( block_list& src, block_list* bl, uint16 skill_id, uint16
 				}
 				clif_skill_poseffect( *su, skill_id, skill_lv, x, y, tick );
 				int32 range = skill_get_splash( skill_id, skill_lv );
-				map_foreachinallarea( skill_area_sub, src.m, x - range, y - range, x + range, y + range, BL_CHAR, &src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id );
+				map_foreachinallarea(skill_area_sub_bind(&src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id), src.m, x - range, y - range, x + range, y + range, BL_CHAR);
 				} break;
 			case SS_KAGENOMAI://nodamage splash
 			case SS_ANTENPOU://nodamage splash
 				clif_skill_nodamage( su, *su, skill_id, skill_lv, tick );
-				map_foreachinrange( skill_area_sub, su, skill_get_splash( skill_id, skill_lv ), BL_CHAR, &src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SD_ANIMATION | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id );
+				map_foreachinrange(skill_area_sub_bind(&src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SD_ANIMATION | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id), su, skill_get_splash( skill_id, skill_lv ), BL_CHAR);
 				break;
 			case SS_KAGEGISSEN://damage splash
 				x = bl->x;
@@ -5446,10 +5460,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 	case MO_COMBOFINISH:
 		if (!(flag&1) && sc && sc->getSCE(SC_SPIRIT) && sc->getSCE(SC_SPIRIT)->val2 == SL_MONK)
 		{	//Becomes a splash attack when Soul Linked.
-			map_foreachinshootrange(skill_area_sub, bl,
-				skill_get_splash(skill_id, skill_lv),BL_CHAR|BL_SKILL,
-				src,skill_id,skill_lv,tick, flag|BCT_ENEMY|1,
-				skill_castend_damage_id);
+			map_foreachinshootrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		} else
 			skill_attack(BF_WEAPON,src,src,bl,skill_id,skill_lv,tick,flag);
 		break;
@@ -6073,7 +6084,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 					break;
 				case ABC_CHAIN_REACTION_SHOT:
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-					map_foreachinrange(skill_area_sub, bl, skill_get_splash(ABC_CHAIN_REACTION_SHOT_ATK, skill_lv), BL_CHAR|BL_SKILL, src, ABC_CHAIN_REACTION_SHOT_ATK, skill_lv, tick + (200 + status_get_amotion(src)), flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+					map_foreachinrange(skill_area_sub_bind(src, ABC_CHAIN_REACTION_SHOT_ATK, skill_lv, tick + (200 + status_get_amotion(src)), flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(ABC_CHAIN_REACTION_SHOT_ATK, skill_lv), BL_CHAR|BL_SKILL);
 					break;
 				case IQ_THIRD_PUNISH:
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv);
@@ -6097,10 +6108,10 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 					break;
 				case IG_OVERSLASH:
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-					skill_area_temp[0] = map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count);
+					skill_area_temp[0] = map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 					break;
 				case WH_GALESTORM:// Give AP if 3 or more targets are hit.
-					if (sd && map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count) >= 3)
+					if (sd && map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR) >= 3)
 						status_heal(src, 0, 0, 10, 0);
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 					break;
@@ -6134,14 +6145,14 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 					break;
 				case SOA_TALISMAN_OF_RED_PHOENIX:
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-					skill_area_temp[0] = map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count);
+					skill_area_temp[0] = map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 					if (sc != nullptr && sc->getSCE(SC_T_SECOND_GOD) != nullptr){
 						sc_start(src, src, skill_get_sc(skill_id), 100, skill_lv, skill_get_time(skill_id, skill_lv));
 					}
 					break;
 				case SOA_CIRCLE_OF_DIRECTIONS_AND_ELEMENTALS:
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-					skill_area_temp[0] = map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count);
+					skill_area_temp[0] = map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 					sc_start(src,src,skill_get_sc(skill_id),100,skill_lv,skill_get_time(skill_id,skill_lv));
 					break;
 				case SS_KINRYUUHOU:
@@ -6156,14 +6167,14 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			//SD_LEVEL -> Forced splash damage for Auto Blitz-Beat -> count targets
 			//special case: Venom Splasher uses a different range for searching than for splashing
 			if (flag&SD_LEVEL || skill_get_nk(skill_id, NK_SPLASHSPLIT)) {
-				skill_area_temp[0] = map_foreachinallrange(skill_area_sub, bl, (skill_id == AS_SPLASHER)?1:splash_size, BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count);
+				skill_area_temp[0] = map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, (skill_id == AS_SPLASHER)?1:splash_size, BL_CHAR);
 				// If there are no characters in the area, then it always counts as if there was one target
 				// This happens when targetting skill units such as icewall
 				skill_area_temp[0] = std::max(1, skill_area_temp[0]);
 			}
 
 			// recursive invocation of skill_castend_damage_id() with flag|1
-			map_foreachinrange(skill_area_sub, bl, splash_size, starget, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, splash_size, starget);
 
 			if (skill_id == RA_ARROWSTORM)
 				status_change_end(src, SC_CAMOUFLAGE);
@@ -6186,7 +6197,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			if (sd && sd->weapontype1 == W_GRENADE)
 				splash += 2;
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinrange(skill_area_sub, bl, splash, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, splash, BL_CHAR);
 			if (sc && sc->getSCE(SC_INTENSIVE_AIM_COUNT))
 				status_change_end(src, SC_INTENSIVE_AIM_COUNT);
 		}
@@ -6200,7 +6211,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			if (sd != nullptr && sd->weapontype1 == W_RIFLE)
 				splash += 1;
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv, 1);
-			map_foreachinrange(skill_area_sub, bl, splash, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, splash, BL_CHAR);
 
 		}
 		break;
@@ -6405,8 +6416,8 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 		if (flag & 1) {
 			skill_attack(skill_get_type(skill_id), src, src, bl, skill_id, skill_lv, tick, (skill_area_temp[0]) > 0 ? SD_ANIMATION | skill_area_temp[0] : skill_area_temp[0]);
 		} else {
-			skill_area_temp[0] = map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count);
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			skill_area_temp[0] = map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		}
 		break;
 #else
@@ -6474,9 +6485,9 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 				// Splash around target cell, but only cells inside area; we first have to check the area is not negative
 				if((max(min_x,tx-1) <= min(max_x,tx+1)) &&
 					(max(min_y,ty-1) <= min(max_y,ty+1)) &&
-					(count = map_foreachinallarea(skill_area_sub, bl->m, max(min_x,tx-1), max(min_y,ty-1), min(max_x,tx+1), min(max_y,ty+1), splash_target(src), src, skill_id, skill_lv, tick, flag|BCT_ENEMY, skill_area_sub_count))) {
+					(count = map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY, skill_area_sub_count), bl->m, max(min_x,tx-1), max(min_y,ty-1), min(max_x,tx+1), min(max_y,ty+1), splash_target(src)))) {
 					// Recursive call
-					map_foreachinallarea(skill_area_sub, bl->m, max(min_x,tx-1), max(min_y,ty-1), min(max_x,tx+1), min(max_y,ty+1), splash_target(src), src, skill_id, skill_lv, tick, (flag|BCT_ENEMY)+1, skill_castend_damage_id);
+					map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, (flag|BCT_ENEMY)+1, skill_castend_damage_id), bl->m, max(min_x,tx-1), max(min_y,ty-1), min(max_x,tx+1), min(max_y,ty+1), splash_target(src));
 					// Self-collision
 					if(bl->x >= min_x && bl->x <= max_x && bl->y >= min_y && bl->y <= max_y)
 						skill_attack(BF_WEAPON,src,src,bl,skill_id,skill_lv,tick,(flag&0xFFF)>0?SD_ANIMATION|count:count);
@@ -6503,8 +6514,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			if (skill_attack(BF_WEAPON,src,src,bl,skill_id,skill_lv,tick,0))
 				skill_blown(src,bl,skill_area_temp[2],-1,BLOWN_NONE);
 			for (i=0;i<4;i++) {
-				map_foreachincell(skill_area_sub,bl->m,x,y,BL_CHAR,
-					src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+				map_foreachincell(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),bl->m,x,y,BL_CHAR);
 				x += dirx[dir];
 				y += diry[dir];
 			}
@@ -6516,10 +6526,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 	{
 		skill_area_temp[1] = bl->id; //NOTE: This is used in skill_castend_nodamage_id to avoid affecting the target.
 		if (skill_attack(BF_WEAPON,src,src,bl,skill_id,skill_lv,tick,flag))
-			map_foreachinallrange(skill_area_sub,bl,
-				skill_get_splash(skill_id, skill_lv),(skill_id==TK_TURNKICK)?BL_MOB:BL_CHAR,
-				src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,
-				skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), (skill_id==TK_TURNKICK)?BL_MOB:BL_CHAR);
 	}
 		break;
 	case CH_PALMSTRIKE: //	Palm Strike takes effect 1sec after casting. [Skotlex]
@@ -6777,7 +6784,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			skill_attack(skill_get_type(skill_id),src,src,bl,skill_id,skill_lv,tick,flag);
 		else {
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-			map_foreachinallrange(skill_area_sub, bl,skill_get_splash(skill_id, skill_lv),BL_CHAR,src,skill_id,skill_lv,tick, flag|BCT_ENEMY|1,skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 	case GC_DARKILLUSION:
@@ -6878,7 +6885,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 				if (skill_lv > 5) {
 					skill_area_temp[0] = i;
 					skill_area_temp[1] = skill[1];
-					map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill[0], skill_lv, tick, flag | BCT_ENEMY, skill_castend_damage_id);
+					map_foreachinallrange(skill_area_sub_bind(src, skill[0], skill_lv, tick, flag | BCT_ENEMY, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 				} else
 					skill_addtimerskill(src, tick + i * 200, bl->id, skill[1], 0, skill[0], skill_lv, i, flag);
 				i++;
@@ -6917,7 +6924,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 				if (skill_lv > 5) {
 					skill_area_temp[0] = abs(i - SC_SPHERE_5);
 					skill_area_temp[1] = k;
-					map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, subskill, skill_lv, tick, flag | BCT_ENEMY, skill_castend_damage_id);
+					map_foreachinallrange(skill_area_sub_bind(src, subskill, skill_lv, tick, flag | BCT_ENEMY, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 				} else
 					skill_addtimerskill(src, tick + abs(i - SC_SPHERE_5) * 200, bl->id, k, 0, subskill, skill_lv, abs(i - SC_SPHERE_5), flag);
 				status_change_end(src, static_cast<sc_type>(i));
@@ -7017,7 +7024,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			skill_addtimerskill(src, tick + 300, bl->id, 0, 0, skill_id, skill_lv, BF_MAGIC, flag | 2);
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 	case RA_WUGSTRIKE:
@@ -7077,14 +7084,14 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			sc_start(src,bl, SC_INFRAREDSCAN, 10000, skill_lv, skill_get_time(skill_id, skill_lv));
 		} else {
 			clif_skill_damage( *src, *bl,tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), splash_target(src), src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), splash_target(src));
 		}
 		break;
 	case SC_FATALMENACE:
 		if( flag&1 )
 			skill_attack(BF_WEAPON,src,src,bl,skill_id,skill_lv,tick,flag);
 		else {
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), splash_target(src), src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), splash_target(src));
 			clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 		}
 		break;
@@ -7098,7 +7105,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			// Destination area
 			skill_area_temp[4] = x;
 			skill_area_temp[5] = y;
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), splash_target(src), src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), splash_target(src));
 			skill_addtimerskill(src,tick + 800,src->id,x,y,skill_id,skill_lv,0,flag); // To teleport Self
 			clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 		}
@@ -7172,7 +7179,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			if (tsc && tsc->getSCE(SC__SHADOWFORM) && rnd() % 100 < 100 - tsc->getSCE(SC__SHADOWFORM)->val1 * 10) // [100 - (Skill Level x 10)] %
 				status_change_end(bl, SC__SHADOWFORM);
 		} else {
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 			clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 		}
 		break;
@@ -7183,7 +7190,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 		} else if (sd) {
 			if (sc && sc->getSCE(SC_COMBO) && sc->getSCE(SC_COMBO)->val1 == SR_FALLENEMPIRE && !sc->getSCE(SC_FLASHCOMBO))
 				flag |= 8; // Only apply Combo bonus when Tiger Cannon is not used through Flash Combo
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL);
 		}
 		break;
 
@@ -7193,7 +7200,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			skill_attack(skill_get_type(skill_id), src, src, bl, skill_id, skill_lv, tick, flag);
 		else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 			battle_consume_ammo(sd, skill_id, skill_lv); // Consume here since Magic/Misc attacks reset arrow_atk
 		}
 		break;
@@ -7242,7 +7249,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			clif_skill_nodamage(src,*battle_get_master(src),skill_id,skill_lv);
 			clif_skill_damage( *src, *bl, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 			if( rnd()%100 < 30 )
-				map_foreachinrange(skill_area_sub,bl,i,BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+				map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),bl,i,BL_CHAR);
 			else
 				skill_attack(skill_get_type(skill_id),src,src,bl,skill_id,skill_lv,tick,flag);
 		}
@@ -7265,7 +7272,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			clif_skill_nodamage(src,*battle_get_master(src),skill_id,skill_lv);
 			clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 			if( rnd()%100 < 30 )
-				map_foreachinrange(skill_area_sub,bl,i,BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+				map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),bl,i,BL_CHAR);
 			else
 				skill_attack(skill_get_type(skill_id),src,src,bl,skill_id,skill_lv,tick,flag);
 		}
@@ -7314,7 +7321,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			skill_attack(skill_get_type(skill_id), src, src, bl, skill_id, skill_lv, tick, flag);
 		}
 		else
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		break;
 
 	case MH_TWISTER_CUTTER:
@@ -7363,8 +7370,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			// Triggered by RL_FLICKER
 			if (sd && sd->flicker) {
 				// Splash damage around it!
-				map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL,
-					src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+				map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 				flag |= 1; // Don't consume requirement
 				if (tsc &&tsc->getSCE(SC_H_MINE) && tsc->getSCE(SC_H_MINE)->val2 == src->id) {
 					status_change_end(bl, SC_H_MINE);
@@ -7402,7 +7408,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			else
 				clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -7423,10 +7429,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 					skill_attack(BF_WEAPON, src, src, bl, skill_id, skill_lv, tick, SD_LEVEL|flag);
 			} else {
 				skill_area_temp[1] = bl->id;
-				map_foreachinallrange(skill_area_sub, bl,
-					sd->bonus.splash_range, BL_CHAR,
-					src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1,
-					skill_castend_damage_id);
+				map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), bl, sd->bonus.splash_range, BL_CHAR);
 				flag|=1; //Set flag to 1 so ammo is not double-consumed. [Skotlex]
 			}
 		}
@@ -7512,8 +7515,8 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 		} else {
 			int32 splash = skill_get_splash(skill_id, skill_lv);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			skill_area_temp[0] = map_foreachinallrange(skill_area_sub, bl, splash, BL_CHAR, src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count);
-			map_foreachinrange(skill_area_sub, bl, splash, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			skill_area_temp[0] = map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, BCT_ENEMY, skill_area_sub_count), bl, splash, BL_CHAR);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, splash, BL_CHAR);
 			sc_start(src, src, SC_HNNOWEAPON, 100, skill_lv, skill_get_time2(skill_id, skill_lv));
 		}
 		break;
@@ -7523,7 +7526,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			skill_attack(skill_get_type(skill_id), src, src, bl, skill_id, skill_lv, tick, flag);
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			sc_start(src, src, SC_HNNOWEAPON, 100, skill_lv, skill_get_time2(skill_id, skill_lv));
 		}
 		break;
@@ -7540,7 +7543,7 @@ int32 skill_castend_damage_id (block_list* src, block_list *bl, uint16 skill_id,
 			skill_attack(skill_get_type(skill_id), src, src, bl, skill_id, skill_lv, tick, flag);
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -7940,7 +7943,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		if (flag&1)
 			sc_start(src, bl, type, 30 + 10 * skill_lv, skill_lv, skill_get_time(skill_id, skill_lv));
 		else {
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
 		break;
@@ -8274,8 +8277,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 	//Passive Magnum, should had been casted on yourself.
 	case MS_MAGNUM:
 		skill_area_temp[1] = 0;
-		map_foreachinshootrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_SKILL|BL_CHAR,
-			src,skill_id,skill_lv,tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+		map_foreachinshootrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), src, skill_get_splash(skill_id, skill_lv), BL_SKILL|BL_CHAR);
 		clif_skill_nodamage(src, *src,skill_id,skill_lv);
 		// Initiate 20% of your damage becomes fire element.
 #ifdef RENEWAL
@@ -8523,12 +8525,12 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			if (skill_id == AG_DESTRUCTIVE_HURRICANE && climax_lv == 4) // Buff for caster instead of damage AoE.
 				sc_start(src, bl, type, 100, skill_lv, skill_get_time2(skill_id, skill_lv));
 			else if (skill_id == AG_CRYSTAL_IMPACT && climax_lv == 1) // Buffs the caster and allies instead of doing damage AoE.
-					map_foreachinrange(skill_area_sub, bl, splash_size, BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ALLY|SD_SPLASH|1, skill_castend_nodamage_id);
+					map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ALLY|SD_SPLASH|1, skill_castend_nodamage_id), bl, splash_size, BL_CHAR);
 			else {
 				if (skill_id == AG_DESTRUCTIVE_HURRICANE && climax_lv == 1) // Display extra animation for the additional hit cast.
 					clif_skill_nodamage(src, *bl, AG_DESTRUCTIVE_HURRICANE_CLIMAX, skill_lv);
 
-				map_foreachinrange(skill_area_sub, bl, splash_size, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+				map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, splash_size, BL_CHAR);
 			}
 		}
 		break;
@@ -8676,10 +8678,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(bl,type,100,skill_lv,skill_get_time(skill_id,skill_lv));
 		else
 		{
-			map_foreachinallrange(skill_area_sub, bl,
-				skill_get_splash(skill_id, skill_lv), BL_PC,
-				src, skill_id, skill_lv, tick, flag|BCT_ALL|1,
-				skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ALL|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_PC);
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 		}
 		break;
@@ -8964,10 +8963,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 	case RG_RAID:
 		skill_area_temp[1] = 0;
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-		map_foreachinrange(skill_area_sub, bl,
-			skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL,
-			src,skill_id,skill_lv,tick, flag|BCT_ENEMY|1,
-			skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		status_change_end(src, SC_HIDING);
 		break;
 
@@ -9071,8 +9067,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 
 		skill_area_temp[1] = 0;
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-		i = map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), starget,
-				src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+		i = map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), starget);
 		if( !i && ( skill_id == RK_WINDCUTTER || skill_id == NC_AXETORNADO || skill_id == LG_CANNONSPEAR || skill_id == SR_SKYNETBLOW || skill_id == KO_HAPPOKUNAI ) )
 			clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 	}
@@ -9083,7 +9078,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			skill_area_temp[1] = 0;
 
 			// Note: doesn't force player to stand before attacking
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_LEVEL | SD_SPLASH, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_LEVEL | SD_SPLASH, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL);
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv, sc_start(src, bl, type, 100, skill_lv, skill_get_time(skill_id, skill_lv)));
 		}
@@ -9098,7 +9093,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 				skill_sit(sd, false);
 			}
 
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_LEVEL | SD_SPLASH, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_LEVEL | SD_SPLASH, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL);
 		} else {
 			if (dstsd) {
 				int32 lv = abs( status_get_lv( src ) - status_get_lv( bl ) );
@@ -9146,7 +9141,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		skill_area_temp[1] = 0;
 		clif_skill_nodamage(src, *bl, buster_element, skill_lv);// Animation for the triggered blaster element.
 		clif_skill_nodamage(src, *bl, skill_id, skill_lv);// Triggered after blaster animation to make correct skill name scream appear.
-		map_foreachinrange(skill_area_sub, bl, 6, BL_CHAR | BL_SKILL, src, buster_element, skill_lv, tick, flag | BCT_ENEMY | SD_LEVEL | SD_SPLASH | 1, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, buster_element, skill_lv, tick, flag | BCT_ENEMY | SD_LEVEL | SD_SPLASH | 1, skill_castend_damage_id), bl, 6, BL_CHAR | BL_SKILL);
 	}
 	break;
 
@@ -9158,7 +9153,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 #else
 		clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 #endif
-		map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		break;
 
 	case SR_TIGERCANNON:
@@ -9215,10 +9210,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		//Passive side of the attack.
 		status_change_end(src, SC_SIGHT);
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-		map_foreachinshootrange(skill_area_sub,src,
-			skill_get_splash(skill_id, skill_lv),BL_CHAR|BL_SKILL,
-			src,skill_id,skill_lv,tick, flag|BCT_ENEMY|SD_ANIMATION|1,
-			skill_castend_damage_id);
+		map_foreachinshootrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_ANIMATION|1, skill_castend_damage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		break;
 
 	case WZ_FROSTNOVA:
@@ -9243,10 +9235,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		}
 		clif_skill_nodamage(src, *src, skill_id, skill_lv);
 		map_delblock(src); //Required to prevent chain-self-destructions hitting back.
-		map_foreachinshootrange(skill_area_sub, bl,
-			skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL,
-			src, skill_id, skill_lv, tick, flag|i,
-			skill_castend_damage_id);
+		map_foreachinshootrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|i, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 		if(map_addblock(src)) {
 			return 1;
 		}
@@ -10035,9 +10024,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		}
 
 		//Affect all targets on splash area.
-		map_foreachinallrange(skill_area_sub, bl, i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag|1,
-			skill_castend_damage_id);
+		map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|1, skill_castend_damage_id), bl, i, BL_CHAR);
 		break;
 
 	case TK_HIGHJUMP:
@@ -10487,7 +10474,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 				if (dstsd == f_sd || dstsd == m_sd)
 					clif_skill_nodamage(src, *bl, skill_id, skill_lv, sc_start(src, bl, type, 100, skill_lv, skill_get_time(skill_id, skill_lv)));
 			} else
-				map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_PC, src, skill_id, skill_lv, tick, flag|BCT_ALL|1, skill_castend_nodamage_id);
+				map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ALL|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_PC);
 		}
 		break;
 
@@ -10894,10 +10881,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			}
 		} else if (status_get_guild_id(src)) {
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-			map_foreachinallrange(skill_area_sub, src,
-				skill_get_splash(skill_id, skill_lv), BL_PC,
-				src,skill_id,skill_lv,tick, flag|BCT_GUILD|1,
-				skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_GUILD|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_PC);
 			if (sd)
 #ifdef RENEWAL
 				skill_blockpc_start(*sd, skill_id, skill_get_cooldown(skill_id, skill_lv));
@@ -11120,7 +11104,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 	case HVAN_EXPLOSION:
 		if( hd != nullptr ){
 			clif_skill_nodamage(src, *src, skill_id, skill_lv, 1);
-			map_foreachinshootrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL, src, skill_id, skill_lv, tick, flag | BCT_ENEMY, skill_castend_damage_id);
+			map_foreachinshootrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL);
 
 			hd->homunculus.intimacy = hom_intimacy_grade2intimacy(HOMGRADE_HATE_WITH_PASSION);
 			clif_send_homdata(*hd, SP_INTIMATE);
@@ -11199,10 +11183,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		else {
 			skill_area_temp[2] = 0; //For SD_PREAMBLE
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-			map_foreachinallrange(skill_area_sub, bl,
-				skill_get_splash(skill_id, skill_lv),BL_CHAR,
-				src,skill_id,skill_lv,tick, flag|BCT_ENEMY|SD_PREAMBLE|1,
-				skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_PREAMBLE|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 	case NPC_WIDESOULDRAIN:
@@ -11211,10 +11192,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		else {
 			skill_area_temp[2] = 0; //For SD_PREAMBLE
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-			map_foreachinallrange(skill_area_sub, bl,
-				skill_get_splash(skill_id, skill_lv),BL_CHAR,
-				src,skill_id,skill_lv,tick, flag|BCT_ENEMY|SD_PREAMBLE|1,
-				skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_PREAMBLE|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 	case NPC_FIRESTORM: {
@@ -11223,8 +11201,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		if( skill_lv > 1 )
 			sflag |= 4;
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-		map_foreachinshootrange(skill_area_sub,src,skill_get_splash(skill_id,skill_lv),splash_target(src),src,
-			skill_id,skill_lv,tick,sflag|BCT_ENEMY|SD_ANIMATION|1,skill_castend_damage_id);
+		map_foreachinshootrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,sflag|BCT_ENEMY|SD_ANIMATION|1,skill_castend_damage_id),src,skill_get_splash(skill_id,skill_lv),splash_target(src));
 		}
 		break;
 	case ALL_PARTYFLEE:
@@ -11260,10 +11237,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		{
 			skill_area_temp[2] = 0;
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-			map_foreachinallrange(skill_area_sub, src,
-				skill_get_splash(skill_id,skill_lv),BL_CHAR,
-				src,skill_id,skill_lv,tick,flag|BCT_ENEMY|SD_PREAMBLE|1,
-				skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|SD_PREAMBLE|1,skill_castend_nodamage_id),src,skill_get_splash(skill_id,skill_lv),BL_CHAR);
 		}
 		break;
 
@@ -11273,7 +11247,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			clif_skill_damage( *src, *bl,tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 			i = skill_get_splash(skill_id,skill_lv);
 			map_foreachinallarea(skill_cell_overlap, src->m, src->x-i, src->y-i, src->x+i, src->y+i, BL_SKILL, LG_EARTHDRIVE, &dummy, src);
-			map_foreachinrange(skill_area_sub, bl,i,BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),bl,i,BL_CHAR);
 			clif_skill_nodamage(src, *src, skill_id, skill_lv);
 		}
 		break;
@@ -11333,7 +11307,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		{
 			int16 count = 1;
 			skill_area_temp[2] = 0;
-			map_foreachinrange(skill_area_sub,src,skill_get_splash(skill_id,skill_lv),BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|SD_PREAMBLE|SD_SPLASH|1,skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|SD_PREAMBLE|SD_SPLASH|1,skill_castend_damage_id),src,skill_get_splash(skill_id,skill_lv),BL_CHAR);
 			if( tsc && tsc->getSCE(SC_ROLLINGCUTTER) )
 			{ // Every time the skill is casted the status change is reseted adding a counter.
 				count += (int16)tsc->getSCE(SC_ROLLINGCUTTER)->val1;
@@ -11347,7 +11321,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		break;
 
 	case ABC_ABYSS_FLAME:
-		map_foreachinrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL, src, skill_id, skill_lv, tick, (flag | BCT_ENEMY | SD_SPLASH) & ~BCT_SELF, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, (flag | BCT_ENEMY | SD_SPLASH) & ~BCT_SELF, skill_castend_damage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR | BL_SKILL);
 		skill_castend_damage_id(src, bl, ABC_ABYSS_FLAME_ATK, skill_lv, tick, flag);
 		break;
 
@@ -11392,8 +11366,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 	case GC_PHANTOMMENACE:
 		clif_skill_damage( *src, *bl,tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-		map_foreachinrange(skill_area_sub,src,skill_get_splash(skill_id,skill_lv),BL_CHAR,
-			src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),src,skill_get_splash(skill_id,skill_lv),BL_CHAR);
 		break;
 
 	case GC_HALLUCINATIONWALK:
@@ -11477,8 +11450,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			}
 		}
 		else {
-			map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_MOB,
-				src, skill_id, skill_lv, tick, flag|BCT_PARTY|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_PARTY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_MOB);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
 		break;
@@ -11487,8 +11459,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		if( flag&1 )
 			sc_start(src,bl, type, 40 + 5 * skill_lv, skill_lv, skill_get_time(skill_id, skill_lv));
 		else {
-			map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR,
-				src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
 		break;
@@ -11584,13 +11555,12 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			break;
 		}
 
-		map_foreachinallrange(skill_area_sub, bl, i, BL_CHAR, src, skill_id, skill_lv, tick, flag|1, skill_castend_damage_id);
+		map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|1, skill_castend_damage_id), bl, i, BL_CHAR);
 		break;
 
 	case AB_SILENTIUM:
 		// Should the level of Lex Divina be equivalent to the level of Silentium or should the highest level learned be used? [LimitLine]
-		map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR,
-			src, PR_LEXDIVINA, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+		map_foreachinallrange(skill_area_sub_bind(src, PR_LEXDIVINA, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		break;
 
@@ -11600,7 +11570,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		else {
 			struct map_data *mapdata = map_getmapdata(src->m);
 
-			map_foreachinallrange(skill_area_sub,src,skill_get_splash(skill_id, skill_lv),BL_CHAR,src,skill_id,skill_lv,tick,(mapdata_flag_vs(mapdata)?BCT_ALL:BCT_ENEMY|BCT_SELF)|flag|1,skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, (mapdata_flag_vs(mapdata)?BCT_ALL:BCT_ENEMY|BCT_SELF)|flag|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
 		break;
@@ -11638,7 +11608,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 
 	case NPC_JACKFROST:
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
-		map_foreachinrange(skill_area_sub,bl,skill_get_splash(skill_id,skill_lv),BL_CHAR|BL_SKILL,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),bl,skill_get_splash(skill_id,skill_lv),BL_CHAR|BL_SKILL);
 		break;
 
 	case WL_SIENNAEXECRATE:
@@ -11657,7 +11627,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 				if( status_change_start(src,bl,type,10000,skill_lv,src->id,0,0,skill_get_time2(skill_id,skill_lv), SCSTART_NOTICKDEF, skill_get_time(skill_id, skill_lv)) ) {
 					clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 					skill_area_temp[1] = bl->id;
-					map_foreachinallrange(skill_area_sub,bl,skill_get_splash(skill_id,skill_lv),BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_nodamage_id);
+					map_foreachinallrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_nodamage_id),bl,skill_get_splash(skill_id,skill_lv),BL_CHAR);
 				}
 				// Doesn't send failure packet if it fails on defense.
 			}
@@ -11773,7 +11743,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 	case RA_SENSITIVEKEEN:
 		clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 		clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
-		map_foreachinrange(skill_area_sub,src,skill_get_splash(skill_id,skill_lv),BL_CHAR|BL_SKILL,src,skill_id,skill_lv,tick,flag|BCT_ENEMY,skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY,skill_castend_damage_id),src,skill_get_splash(skill_id,skill_lv),BL_CHAR|BL_SKILL);
 		break;
 
 	case NC_F_SIDESLIDE:
@@ -11791,7 +11761,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 				pc_setmadogear(sd, false);
 			skill_area_temp[1] = 0;
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_SPLASH|1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 			status_set_sp(src, 0, 0);
 			skill_clear_unitgroup(src);
 		}
@@ -11824,7 +11794,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		} else {
 			if (map_flag_vs(src->m)) // Doesn't affect the caster in non-PVP maps [exneval]
 				sc_start2(src, bl, type, 100, skill_lv, src->id, skill_get_time(skill_id, skill_lv));
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), splash_target(src), src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), splash_target(src));
 			clif_skill_damage( *src, *bl, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 		}
 		break;
@@ -11897,8 +11867,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(src, bl, SC_BLIND, 53 + 2 * skill_lv, skill_lv, skill_get_time2(skill_id, skill_lv));
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, 0);
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR,
-				src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -11964,7 +11933,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(src,bl,type,100,skill_lv,skill_get_time(skill_id,skill_lv));
 		else {
 			skill_area_temp[2] = 0;
-			map_foreachinallrange(skill_area_sub,bl,skill_get_splash(skill_id,skill_lv),BL_PC,src,skill_id,skill_lv,tick,flag|SD_PREAMBLE|BCT_PARTY|BCT_SELF|1,skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|SD_PREAMBLE|BCT_PARTY|BCT_SELF|1,skill_castend_nodamage_id),bl,skill_get_splash(skill_id,skill_lv),BL_PC);
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 		}
 		break;
@@ -12039,7 +12008,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv, i != 0);
 		} else {
 			clif_skill_damage( *src, *bl, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), splash_target(src), src, skill_id, skill_lv, tick, flag|BCT_ENEMY|BCT_SELF|SD_SPLASH|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|BCT_SELF|SD_SPLASH|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), splash_target(src));
 		}
 		break;
 
@@ -12139,7 +12108,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			// Success chance: (Skill Level x 6) + (Voice Lesson Skill Level x 2) + (Caster's Job Level / 2) %
 			skill_area_temp[5] = skill_lv * 6 + ((sd) ? pc_checkskill(sd, WM_LESSON) : 1) * 2 + (sd ? sd->status.job_level : 50) / 2;
 			skill_area_temp[6] = skill_get_time(skill_id,skill_lv);
-			map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id,skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag|BCT_ALL|BCT_WOS|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ALL|BCT_WOS|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id,skill_lv), BL_CHAR|BL_SKILL);
 			clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 		}
 		break;
@@ -12161,7 +12130,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(src,bl,type,100,skill_lv,skill_get_time(skill_id,skill_lv));
 		} else if (sd) {
 			if( rnd()%100 < sstatus->int_ / 6 + sd->status.job_level / 5 + skill_lv * 4 + pc_checkskill(sd, WM_LESSON) ) { // !TODO: What's the Lesson bonus?
-				map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id,skill_lv),BL_PC, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+				map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id,skill_lv), BL_PC);
 				clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 			}
 		}
@@ -12188,7 +12157,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(src,bl,type,100,skill_lv,skill_get_time(skill_id,skill_lv));
 		} else {	// These affect to all targets around the caster.
 			if( rnd()%100 < 5 + 5 * skill_lv + pc_checkskill(sd, WM_LESSON) ) { // !TODO: What's the Lesson bonus?
-				map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id,skill_lv),BL_PC, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+				map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id,skill_lv), BL_PC);
 				clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 			}
 		}
@@ -12199,7 +12168,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(src,bl,type,100,skill_lv,skill_get_time(skill_id,skill_lv));
 		} else {	// These affect to all targets around the caster.
 			if( rnd()%100 < 12 + 3 * skill_lv + (sd ? pc_checkskill(sd, WM_LESSON) : 0) ) { // !TODO: What's the Lesson bonus?
-				map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id,skill_lv),BL_PC, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+				map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id,skill_lv), BL_PC);
 				clif_skill_nodamage(src,*bl,skill_id,skill_lv);
 			}
 		}
@@ -12209,7 +12178,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		if (flag&1) {
 			sc_start(src, bl, type, 100, skill_lv, (sd ? pc_checkskill(sd, WM_LESSON) * 500 : 0) + skill_get_time(skill_id, skill_lv)); // !TODO: Confirm Lesson increase
 		} else {
-			map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv),BL_PC, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_PC);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
 		break;
@@ -12367,7 +12336,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			sc_start(src, bl, type, rate, skill_lv, duration);
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -12483,7 +12452,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 				status_zap(bl,0,status_get_max_sp(bl) * (25 + 5 * skill_lv) / 100);
 			}
 		} else {
-			map_foreachinallrange(skill_area_sub,bl,skill_get_splash(skill_id,skill_lv),BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_nodamage_id),bl,skill_get_splash(skill_id,skill_lv),BL_CHAR);
 			clif_skill_nodamage(src,*src,skill_id,skill_lv);
 		}
 		break;
@@ -12499,7 +12468,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			if( itemdb_group.item_exists(IG_BOMB, ammo_id) ) {
 				if(battle_check_target(src,bl,BCT_ENEMY) > 0) {// Only attack if the target is an enemy.
 					if( ammo_id == ITEMID_PINEAPPLE_BOMB )
-						map_foreachincell(skill_area_sub,bl->m,bl->x,bl->y,BL_CHAR,src,GN_SLINGITEM_RANGEMELEEATK,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+						map_foreachincell(skill_area_sub_bind(src,GN_SLINGITEM_RANGEMELEEATK,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),bl->m,bl->x,bl->y,BL_CHAR);
 					else
 						skill_attack(BF_WEAPON,src,src,bl,GN_SLINGITEM_RANGEMELEEATK,skill_lv,tick,flag);
 				} else //Otherwise, it fails, shows animation and removes items.
@@ -12747,7 +12716,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 					sc_start(src, bl, type, 100, skill_lv, skill_get_time(skill_id, skill_lv));
 			}
 		}else{
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR|BL_SKILL);
 			clif_skill_damage( *src, *src, tick, status_get_amotion(src), 0, DMGVAL_IGNORE, 1, skill_id, skill_lv, DMG_SINGLE );
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
@@ -12896,7 +12865,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		// Remember main target as it will always be hit by this skill
 		skill_area_temp[1] = bl->id;
 		// Iterate through all enemies in the area
-		map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+		map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		// End here to prevent spamming of the skill onto the target
 		status_change_end(src, SC_QD_SHOT_READY);
 		skill_area_temp[1] = 0;
@@ -12911,7 +12880,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 				map_foreachinallrange(skill_bind_trap, src, AREA_SIZE, BL_SKILL, src);
 			// Detonate RL_H_MINE
 			if ((i = pc_checkskill(sd, RL_H_MINE)))
-				map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, RL_H_MINE, i, tick, flag|BCT_ENEMY|SD_SPLASH, skill_castend_damage_id);
+				map_foreachinallrange(skill_area_sub_bind(src, RL_H_MINE, i, tick, flag|BCT_ENEMY|SD_SPLASH, skill_castend_damage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			sd->flicker = false;
 		}
 		break;
@@ -13011,9 +12980,9 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 			if (battle_config.skill_wall_check)
-				map_foreachinshootrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+				map_foreachinshootrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			else
-				map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+				map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -13033,7 +13002,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		if (flag&1)
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv, sc_start(src, bl, type, 100, skill_lv, skill_get_time(skill_id, skill_lv)));
 		else {
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 		}
 		break;
@@ -13130,7 +13099,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			if (skill_check_pc_partner(sd, skill_id, &skill_lv, AREA_SIZE, 0) > 0)
 				flag |= 2;
 
-			map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -13159,7 +13128,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			if (skill_check_pc_partner(sd, skill_id, &skill_lv, AREA_SIZE, 0) > 0)
 				flag |= 2;
 
-			map_foreachinallrange(skill_area_sub, src, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_nodamage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_nodamage_id), src, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -13179,7 +13148,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			}
 		} else {
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ALLY | SD_SPLASH | 1, skill_castend_nodamage_id);
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ALLY | SD_SPLASH | 1, skill_castend_nodamage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		}
 		break;
 
@@ -13324,13 +13293,13 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		}else{
 			skill_area_temp[2] = 0; // For SD_PREAMBLE
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-			map_foreachinallrange( skill_area_sub, bl, skill_get_splash( skill_id, skill_lv ), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_PREAMBLE | 1, skill_castend_nodamage_id );
+			map_foreachinallrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_PREAMBLE | 1, skill_castend_nodamage_id), bl, skill_get_splash( skill_id, skill_lv ), BL_CHAR);
 		}
 		break;
 
 	case HN_HELLS_DRIVE:
 		clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-		map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		break;
 
 	case NW_THE_VIGILANTE_AT_NIGHT:
@@ -13344,7 +13313,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			clif_skill_nodamage(src, *bl, NW_THE_VIGILANTE_AT_NIGHT_GUN_GATLING, skill_lv);
 		} else
 			clif_skill_nodamage(src, *bl, NW_THE_VIGILANTE_AT_NIGHT_GUN_SHOTGUN, skill_lv);
-		map_foreachinrange(skill_area_sub, bl, i, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, i, BL_CHAR);
 		if (sc && sc->getSCE(SC_INTENSIVE_AIM_COUNT))
 			status_change_end(src, SC_INTENSIVE_AIM_COUNT);
 		break;
@@ -13423,7 +13392,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		skill_area_temp[1] = bl->id;
 		skill_area_temp[2] = 0;
 		clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-		map_foreachinrange(skill_area_sub, bl, range, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), bl, range, BL_CHAR);
 		} break;
 
 	case SH_HOGOGONG_STRIKE:
@@ -13433,7 +13402,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 		skill_area_temp[1] = bl->id;
 		skill_area_temp[2] = 0;
 		clif_skill_nodamage(src, *bl, skill_id, skill_lv);
-		map_foreachinrange(skill_area_sub, bl, skill_get_splash(skill_id, skill_lv), BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), bl, skill_get_splash(skill_id, skill_lv), BL_CHAR);
 		break;
 
 	case SH_KI_SUL_WATER_SPRAYING:
@@ -13499,7 +13468,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 			}
 
 			clif_skill_nodamage( src, *bl, skill_id, 0 );
-			map_foreachinrange( skill_area_sub, bl, range, BL_CHAR, bl, skill_id, skill_lv, tick, flag|BCT_PARTY|2, skill_castend_nodamage_id );
+			map_foreachinrange(skill_area_sub_bind(bl, skill_id, skill_lv, tick, flag|BCT_PARTY|2, skill_castend_nodamage_id), bl, range, BL_CHAR);
 		}else{
 			// No party check required
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
@@ -13569,7 +13538,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 
 		clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 
-		map_foreachinrange( skill_area_sub, bl, range, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id );
+		map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_damage_id), bl, range, BL_CHAR);
 		} break;
 	case SS_AKUMUKESU:
 		if (flag & 1) {
@@ -13579,7 +13548,7 @@ int32 skill_castend_nodamage_id (block_list *src, block_list *bl, uint16 skill_i
 
 			clif_skill_nodamage(src, *bl, skill_id, skill_lv);
 
-			map_foreachinrange( skill_area_sub, bl, range, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_nodamage_id );
+			map_foreachinrange(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | 1, skill_castend_nodamage_id), bl, range, BL_CHAR);
 		}
 		break;
 
@@ -14437,22 +14406,13 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 	case PR_BENEDICTIO:
 		skill_area_temp[1] = src->id;
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub,
-			src->m, x-i, y-i, x+i, y+i, BL_PC,
-			src, skill_id, skill_lv, tick, flag|BCT_ALL|1,
-			skill_castend_nodamage_id);
-		map_foreachinallarea(skill_area_sub,
-			src->m, x-i, y-i, x+i, y+i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1,
-			skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ALL|1, skill_castend_nodamage_id), src->m, x-i, y-i, x+i, y+i, BL_PC);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		break;
 
 	case BS_HAMMERFALL:
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub,
-			src->m, x-i, y-i, x+i, y+i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag|BCT_ENEMY|2,
-			skill_castend_nodamage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|2, skill_castend_nodamage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		break;
 
 	case HT_DETECTING:
@@ -14466,14 +14426,12 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 	case SR_RIDEINLIGHTNING:
 	case NW_BASIC_GRENADE:
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x-i, y-i, x+i, y+i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		break;
 
 	case NPC_LEX_AETERNA:
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x-i, y-i, x+i, y+i, BL_CHAR, src,
-			PR_LEXAETERNA, 1, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, PR_LEXAETERNA, 1, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		break;
 
 	case SA_VOLCANO:
@@ -14833,10 +14791,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 			if(potion_hp > 0 || potion_sp > 0) {
 				i_lv = skill_get_splash(skill_id, skill_lv);
-				map_foreachinallarea(skill_area_sub,
-					src->m,x-i_lv,y-i_lv,x+i_lv,y+i_lv,BL_CHAR,
-					src,skill_id,skill_lv,tick,flag|BCT_PARTY|BCT_GUILD|1,
-					skill_castend_nodamage_id);
+				map_foreachinallarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_PARTY|BCT_GUILD|1,skill_castend_nodamage_id),src->m,x-i_lv,y-i_lv,x+i_lv,y+i_lv,BL_CHAR);
 			}
 		} else {
 			struct item_data *item = itemdb_search(skill_db.find(skill_id)->require.itemid[skill_lv - 1]);
@@ -14852,10 +14807,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 			if(potion_hp > 0 || potion_sp > 0) {
 				id = skill_get_splash(skill_id, skill_lv);
-				map_foreachinallarea(skill_area_sub,
-					src->m,x-id,y-id,x+id,y+id,BL_CHAR,
-					src,skill_id,skill_lv,tick,flag|BCT_PARTY|BCT_GUILD|1,
-						skill_castend_nodamage_id);
+				map_foreachinallarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_PARTY|BCT_GUILD|1,skill_castend_nodamage_id),src->m,x-id,y-id,x+id,y+id,BL_CHAR);
 			}
 		}
 		break;
@@ -14980,13 +14932,12 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 		skill_area_temp[4] = x;
 		skill_area_temp[5] = y;
 		i = skill_get_splash(skill_id,skill_lv);
-		map_foreachinarea(skill_area_sub,src->m,x-i,y-i,x+i,y+i,BL_CHAR|BL_SKILL,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+		map_foreachinarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),src->m,x-i,y-i,x+i,y+i,BL_CHAR|BL_SKILL);
 		break;
 
 	case SO_ARRULLO:
 		i = skill_get_splash(skill_id,skill_lv);
-		map_foreachinallarea(skill_area_sub,src->m,x-i,y-i,x+i,y+i,BL_CHAR,
-			src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_nodamage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		break;
 
 	case GC_POISONSMOKE:
@@ -15002,7 +14953,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 	case AB_EPICLESIS:
 		if( (sg = skill_unitsetting(src, skill_id, skill_lv, x, y, 0)) ) {
 			i = skill_get_splash(skill_id, skill_lv);
-			map_foreachinallarea(skill_area_sub, src->m, x - i, y - i, x + i, y + i, BL_CHAR, src, ALL_RESURRECTION, 1, tick, flag|BCT_NOENEMY|1,skill_castend_nodamage_id);
+			map_foreachinallarea(skill_area_sub_bind(src, ALL_RESURRECTION, 1, tick, flag|BCT_NOENEMY|1, skill_castend_nodamage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		}
 		break;
 
@@ -15099,7 +15050,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 	case WM_GREAT_ECHO:
 		i = skill_get_splash(skill_id,skill_lv);
-		map_foreachinarea(skill_area_sub,src->m,x-i,y-i,x+i,y+i,BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+		map_foreachinarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),src->m,x-i,y-i,x+i,y+i,BL_CHAR);
 		break;
 
 	case WM_SEVERE_RAINSTORM:
@@ -15140,7 +15091,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 				}
 						break;
 				case 2:
-					map_foreachinallarea(skill_area_sub, src->m, su->x - 2, su->y - 2, su->x + 2, su->y + 2, BL_CHAR, src, GN_DEMONIC_FIRE, skill_lv + 20, tick, flag | BCT_ENEMY | SD_LEVEL | 1, skill_castend_damage_id);
+					map_foreachinallarea(skill_area_sub_bind(src, GN_DEMONIC_FIRE, skill_lv + 20, tick, flag | BCT_ENEMY | SD_LEVEL | 1, skill_castend_damage_id), src->m, su->x - 2, su->y - 2, su->x + 2, su->y + 2, BL_CHAR);
 					if (su != nullptr)
 						skill_delunit(su);
 					break;
@@ -15159,7 +15110,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 					if (sd && pc_checkskill(sd, CR_ACIDDEMONSTRATION) > 5)
 						acid_lv = pc_checkskill(sd, CR_ACIDDEMONSTRATION);
-					map_foreachinallarea(skill_area_sub, src->m, su->x - 2, su->y - 2, su->x + 2, su->y + 2, BL_CHAR, src, GN_FIRE_EXPANSION_ACID, acid_lv, tick, flag | BCT_ENEMY | SD_LEVEL | 1, skill_castend_damage_id);
+					map_foreachinallarea(skill_area_sub_bind(src, GN_FIRE_EXPANSION_ACID, acid_lv, tick, flag | BCT_ENEMY | SD_LEVEL | 1, skill_castend_damage_id), src->m, su->x - 2, su->y - 2, su->x + 2, su->y + 2, BL_CHAR);
 					if (su != nullptr)
 						skill_delunit(su);
 				}
@@ -15193,9 +15144,9 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 			rate = (100 - (1000 / (sstatus->dex + sstatus->luk) * 5)) * (skill_lv / 2 + 5) / 10;
 			if( rate < 0 )
 				rate = 0;
-			skill_area_temp[0] = map_foreachinarea(skill_area_sub,src->m,x-i,y-i,x+i,y+i,BL_CHAR,src,skill_id,skill_lv,tick,BCT_ENEMY,skill_area_sub_count);
+			skill_area_temp[0] = map_foreachinarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,BCT_ENEMY,skill_area_sub_count),src->m,x-i,y-i,x+i,y+i,BL_CHAR);
 			if( rnd()%100 < rate )
-				map_foreachinarea(skill_area_sub,src->m,x-i,y-i,x+i,y+i,BL_CHAR,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id);
+				map_foreachinarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|1,skill_castend_damage_id),src->m,x-i,y-i,x+i,y+i,BL_CHAR);
 		}
 		break;
 
@@ -15240,8 +15191,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 	case NC_MAGMA_ERUPTION:
 		// 1st, AoE 'slam' damage
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinarea(skill_area_sub, src->m, x-i, y-i, x+i, y+i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_ANIMATION|1, skill_castend_damage_id);
+		map_foreachinarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|SD_ANIMATION|1, skill_castend_damage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		// 2nd, AoE 'eruption' unit
 		skill_addtimerskill(src,tick + status_get_amotion(src) * 2,0,x,y,skill_id,skill_lv,0,flag);
 		break;
@@ -15263,7 +15213,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 	case AG_ASTRAL_STRIKE:
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x-i, y-i, x+i, y+i, BL_CHAR, src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag|BCT_ENEMY|1, skill_castend_damage_id), src->m, x-i, y-i, x+i, y+i, BL_CHAR);
 		flag |= 1;
 		skill_unitsetting(src, skill_id, skill_lv, x, y, 0);
 		break;
@@ -15300,7 +15250,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 			if (climax_lv == 4) { // Deals no damage and instead inflicts a status on the enemys in range.
 				i = skill_get_splash(skill_id, skill_lv);
-				map_foreachinallarea(skill_area_sub, src->m, x - i, y - i, x + i, y + i, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_nodamage_id);
+				map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_nodamage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 			} else for (i = 1; i <= unit_time / unit_interval; i++) { // Spawn the rising rocks / rose buds on random spots at seperate intervals
 				tmpx = x - area + rnd() % (area * 2 + 1);
 				tmpy = y - area + rnd() % (area * 2 + 1);
@@ -15357,7 +15307,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 			int32 splash = skill_get_splash(skill_id, skill_lv);
 
-			map_foreachinarea(skill_area_sub, src->m, x - splash, y - splash, x + splash, y + splash, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id);
+			map_foreachinarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id), src->m, x - splash, y - splash, x + splash, y + splash, BL_CHAR);
 			skill_unitsetting(src, skill_id, skill_lv, x, y, flag);
 
 			for (i = 1; i <= (skill_get_time(skill_id, skill_lv) / skill_get_unit_interval(skill_id)); i++) {
@@ -15377,7 +15327,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 
 			int32 splash = skill_get_splash(skill_id, skill_lv);
 
-			map_foreachinarea(skill_area_sub, src->m, x - splash, y - splash, x + splash, y + splash, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id);
+			map_foreachinarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id), src->m, x - splash, y - splash, x + splash, y + splash, BL_CHAR);
 			skill_unitsetting(src, skill_id, skill_lv, x, y, skill_get_unit_interval(skill_id));
 
 			for (i = 1; i <= (skill_get_time(skill_id, skill_lv) / skill_get_time2(skill_id, skill_lv)); i++) {
@@ -15390,10 +15340,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 		i = skill_get_splash(skill_id, skill_lv);
 		if (sd && sd->status.weapon == W_GRENADE)
 			i += 2;
-		map_foreachinallarea(skill_area_sub,
-			src->m, x - i, y - i, x + i, y + i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1,
-			skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		if (sc && sc->getSCE(SC_INTENSIVE_AIM_COUNT))
 			status_change_end(src, SC_INTENSIVE_AIM_COUNT);
 		break;
@@ -15405,10 +15352,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 		if (flag & 2){
 			i++;
 		}
-		map_foreachinallarea(skill_area_sub,
-			src->m, x - i, y - i, x + i, y + i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1,
-			skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		if (!(flag & 1)) {
 			skill_addtimerskill(src, tick + 300, 0, x, y, skill_id, skill_lv, 0, flag | 1 | SKILL_NOCONSUME_REQ);
 			skill_addtimerskill(src, tick + 600, 0, x, y, skill_id, skill_lv, 0, flag | 3 | SKILL_NOCONSUME_REQ);
@@ -15425,7 +15369,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 		} break;
 	case NW_MISSION_BOMBARD:
 		i = skill_get_splash(skill_id,skill_lv);
-		map_foreachinarea(skill_area_sub,src->m,x-i,y-i,x+i,y+i,BL_CHAR|BL_SKILL,src,skill_id,skill_lv,tick,flag|BCT_ENEMY|SKILL_ALTDMG_FLAG|1,skill_castend_damage_id);
+		map_foreachinarea(skill_area_sub_bind(src,skill_id,skill_lv,tick,flag|BCT_ENEMY|SKILL_ALTDMG_FLAG|1,skill_castend_damage_id),src->m,x-i,y-i,x+i,y+i,BL_CHAR|BL_SKILL);
 		skill_unitsetting(src, skill_id, skill_lv, x, y, flag);
 
 		for (i = 1; i <= (skill_get_time(skill_id, skill_lv) / skill_get_unit_interval(skill_id)); i++) {
@@ -15440,7 +15384,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 			else if (sd->status.weapon == W_GRENADE)
 				splash += 2;
 		}
-		map_foreachinallarea(skill_area_sub, src->m, x - splash, y - splash, x + splash, y + splash, BL_CHAR, src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - splash, y - splash, x + splash, y + splash, BL_CHAR);
 		} break;
 
 	case SOA_TALISMAN_OF_BLACK_TORTOISE:
@@ -15515,8 +15459,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 		break;
 	case SS_KAGEGARI:
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x - i, y - i, x + i, y + i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		break;
 	case SS_REIKETSUHOU:
 		skill_mirage_cast(*src, nullptr, SS_ANTENPOU, skill_lv, 0, 0, tick, flag | BCT_WOS);
@@ -15525,14 +15468,12 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 			return 0;
 		}
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x - i, y - i, x + i, y + i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		break;
 	case SS_KUNAIWAIKYOKU:
 		skill_mirage_cast(*src, nullptr, skill_id, skill_lv, x, y, tick, flag | BCT_WOS);
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x - i, y - i, x + i, y + i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		skill_unitsetting(src, skill_id, skill_lv, x, y, UNIT_NOCONSUME_AMMO);
 		break;
 	case SS_KUNAIKAITEN:
@@ -15556,8 +15497,7 @@ int32 skill_castend_pos2(block_list* src, int32 x, int32 y, uint16 skill_id, uin
 		break;
 	case SS_TOKEDASU:
 		i = skill_get_splash(skill_id, skill_lv);
-		map_foreachinallarea(skill_area_sub, src->m, x - i, y - i, x + i, y + i, BL_CHAR,
-			src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id);
+		map_foreachinallarea(skill_area_sub_bind(src, skill_id, skill_lv, tick, flag | BCT_ENEMY | 1, skill_castend_damage_id), src->m, x - i, y - i, x + i, y + i, BL_CHAR);
 		sc_start(src, src, skill_get_sc(skill_id), 100, skill_lv, skill_get_time2(skill_id, skill_lv));
 		unit_setdir(src, map_calc_dir_xy(src->x, src->y, x, y, unit_getdir(src)));
 		skill_blown(src, src, skill_get_blewcount(skill_id, skill_lv), unit_getdir(src), (enum e_skill_blown)(BLOWN_IGNORE_NO_KNOCKBACK | BLOWN_DONT_SEND_PACKET));
@@ -17166,7 +17106,7 @@ int32 skill_unit_onplace_timer(skill_unit *unit, block_list *bl, t_tick tick)
 
 		case UNT_EARTHQUAKE:
 			sg->val1++; // Hit count
-			skill_attack(skill_get_type(sg->skill_id), ss, unit, bl, sg->skill_id, sg->skill_lv, tick, map_foreachinallrange(skill_area_sub, unit, skill_get_splash(sg->skill_id, sg->skill_lv), BL_CHAR, unit, sg->skill_id, sg->skill_lv, tick, BCT_ENEMY, skill_area_sub_count) | (sg->val1 == 1 ? NPC_EARTHQUAKE_FLAG : 0));
+			skill_attack(skill_get_type(sg->skill_id), ss, unit, bl, sg->skill_id, sg->skill_lv, tick, map_foreachinallrange(skill_area_sub_bind(unit, sg->skill_id, sg->skill_lv, tick, BCT_ENEMY, skill_area_sub_count), unit, skill_get_splash(sg->skill_id, sg->skill_lv), BL_CHAR) | (sg->val1 == 1 ? NPC_EARTHQUAKE_FLAG : 0));
 			break;
 
 		case UNT_ELECTRICSHOCKER:
@@ -21071,8 +21011,7 @@ int32 skill_attack_area(block_list *bl, va_list ap)
 		}
 
 		if (unit->group->skill_id == SS_FUUMASHOUAKU) {
-			map_foreachinallrange(skill_area_sub, bl, skill_get_splash(SS_FUUMAKOUCHIKU,skill_lv), BL_CHAR,
-				src, SS_FUUMAKOUCHIKU, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id);
+			map_foreachinallrange(skill_area_sub_bind(src, SS_FUUMAKOUCHIKU, skill_lv, tick, flag | BCT_ENEMY | SD_SPLASH | SKILL_ALTDMG_FLAG | 1, skill_castend_damage_id), bl, skill_get_splash(SS_FUUMAKOUCHIKU,skill_lv), BL_CHAR);
 			skill_delunit(unit);
 			return 1;
 		}
@@ -21600,7 +21539,7 @@ static int32 skill_trap_splash(block_list *bl, va_list ap)
 				int32 split_count = 0;
 
 				if (skill_get_nk(sg->skill_id, NK_SPLASHSPLIT))
-					split_count = max(1, map_foreachinallrange(skill_area_sub, src, skill_get_splash(sg->skill_id, sg->skill_lv), BL_CHAR, src, sg->skill_id, sg->skill_lv, tick, BCT_ENEMY, skill_area_sub_count));
+					split_count = max(1, map_foreachinallrange(skill_area_sub_bind(src, sg->skill_id, sg->skill_lv, tick, BCT_ENEMY, skill_area_sub_count), src, skill_get_splash(sg->skill_id, sg->skill_lv), BL_CHAR));
 				skill_attack(skill_get_type(sg->skill_id), ss, src, bl, sg->skill_id, sg->skill_lv, tick, split_count);
 			}
 			break;
@@ -22335,6 +22274,13 @@ int32 skill_unit_timer_sub_onplace(block_list* bl, va_list ap)
 	return 1;
 }
 
+static struct s_skill_unit_timer_stats {
+	uint64 runs;
+	uint64 units; ///< Skill units processed by all runs
+	uint64 skipped; ///< Area searches skipped because nothing was near the unit
+	std::chrono::nanoseconds time; ///< Time spent in all runs
+} skill_unit_timer_stats;
+
 /**
  * @see DBApply
  * Sub function of skill_unit_timer for executing each skill unit from skillunit_db
@@ -22348,6 +22294,8 @@ static int32 skill_unit_timer_sub(DBKey key, DBData *data, va_list ap)
 
 	nullpo_ret(unit);
 
+	skill_unit_timer_stats.units++;
+
 	if( !unit->alive )
 		return 0;
 
@@ -22468,7 +22416,7 @@ static int32 skill_unit_timer_sub(DBKey key, DBData *data, va_list ap)
 				block_list *src = map_id2bl(group->src_id);
 
 				if (src)
-					map_foreachinrange(skill_area_sub, unit, unit->range, BL_CHAR|BL_SKILL, src, group->skill_id, group->skill_lv, tick, BCT_ENEMY|SD_ANIMATION|5, skill_castend_damage_id);
+					map_foreachinrange(skill_area_sub_bind(src, group->skill_id, group->skill_lv, tick, BCT_ENEMY|SD_ANIMATION|5, skill_castend_damage_id), unit, unit->range, BL_CHAR|BL_SKILL);
 				skill_delunit(unit);
 			}
 				break;
@@ -22593,7 +22541,10 @@ static int32 skill_unit_timer_sub(DBKey key, DBData *data, va_list ap)
 
 	if( unit->range >= 0 && group->interval != -1 )
 	{
-		if (skill_get_unit_flag(group->skill_id, UF_PATHCHECK))
+		// Nothing the unit could affect is near it, the area search would not find anything
+		if (!map_presence_inrange_type(bl->m, bl->x, bl->y, unit->range, group->bl_flag))
+			skill_unit_timer_stats.skipped++;
+		else if (skill_get_unit_flag(group->skill_id, UF_PATHCHECK))
 			map_foreachinrange(skill_unit_timer_sub_onplace, bl, unit->range, group->bl_flag, bl, tick);
 		else
 			map_foreachinallrange(skill_unit_timer_sub_onplace, bl, unit->range, group->bl_flag, bl, tick);
@@ -22628,11 +22579,33 @@ static int32 skill_unit_timer_sub(DBKey key, DBData *data, va_list ap)
  *------------------------------------------*/
 TIMER_FUNC(skill_unit_timer){
 	FreeBlockLock freeLock;
+	auto start = std::chrono::steady_clock::now();
 
 	skillunit_db->foreach(skillunit_db, skill_unit_timer_sub, tick);
+
+	skill_unit_timer_stats.runs++;
+	skill_unit_timer_stats.time += std::chrono::steady_clock::now() - start;
 	return 0;
 }
 
+/**
+ * Displays the skill units of each map and statistics of the skill unit timer
+ */
+void skill_unit_report(void){
+	for( int32 m = 0; m < map_num; m++ ){
+		size_t count = map_presence_count( m, PRESENCE_SKILL );
+
+		if( count > 0 )
+			ShowInfo( "Skill units: " CL_WHITE "%" PRIuPTR CL_RESET " on map '" CL_WHITE "%s" CL_RESET "'.\n", count, map[m].name );
+	}
+
+	ShowInfo( "Skill units: " CL_WHITE "%u" CL_RESET " in total, " CL_WHITE "%" PRIu64 CL_RESET " timer runs processing " CL_WHITE "%" PRIu64 CL_RESET " units on average in " CL_WHITE "%" PRId64 CL_RESET " us, " CL_WHITE "%" PRIu64 CL_RESET " area searches skipped.\n",
+		db_size( skillunit_db ), skill_unit_timer_stats.runs,
+		skill_unit_timer_stats.runs > 0 ? skill_unit_timer_stats.units / skill_unit_timer_stats.runs : 0,
+		skill_unit_timer_stats.runs > 0 ? static_cast<int64>( std::chrono::duration_cast<std::chrono::microseconds>( skill_unit_timer_stats.time ).count() / skill_unit_timer_stats.runs ) : 0,
+		skill_unit_timer_stats.skipped );
+}
+
 static std::vector<int16> skill_unit_cell; // Temporary storage for tracking skill unit skill IDs as players move in/out of them
 
 /*==========================================
@@ -22751,7 +22724,8 @@ int32 skill_unit_move(block_list *bl, t_tick tick, int32 flag)
 	if( flag&2 && !(flag&1) ) //Onout, clear data
 		skill_unit_cell.clear();
 
-	map_foreachincell(skill_unit_move_sub,bl->m,bl->x,bl->y,BL_SKILL,bl,tick,flag);
+	if( map_presence_inrange( bl->m, bl->x, bl->y, 0, PRESENCE_SKILL ) )
+		map_foreachincell(skill_unit_move_sub,bl->m,bl->x,bl->y,BL_SKILL,bl,tick,flag);
 
 	if( flag&2 && flag&1 ) { //Onplace, check any skill units you have left.
 		for (const auto &it : skill_unit_cell) {
@@ -22859,7 +22833,7 @@ void skill_unit_move_unit_group(std::shared_ptr<s_skill_unit_group> group, int16
 		switch(m_flag[i]) {
 			case 0:
 			//Cell moves independently, safely move it.
-				map_foreachinmovearea(clif_outsight, unit1, AREA_SIZE, dx, dy, BL_PC, unit1);
+				map_foreachinmovearea([unit1]( block_list* target ){ return clif_outsight( target, unit1 ); }, unit1, AREA_SIZE, dx, dy, BL_PC);
 				map_moveblock(unit1, unit1->x+dx, unit1->y+dy, tick);
 				break;
 			case 1:
@@ -22873,7 +22847,7 @@ void skill_unit_move_unit_group(std::shared_ptr<s_skill_unit_group> group, int16
 					unit2 = &group->unit[j];
 					dx2 = unit2->x + dx - unit1->x;
 					dy2 = unit2->y + dy - unit1->y;
-					map_foreachinmovearea(clif_outsight, unit1, AREA_SIZE, dx2, dy2, BL_PC, unit1);
+					map_foreachinmovearea([unit1]( block_list* target ){ return clif_outsight( target, unit1 ); }, unit1, AREA_SIZE, dx2, dy2, BL_PC);
 					map_moveblock(unit1, unit2->x+dx, unit2->y+dy, tick);
 					j++; //Skip this cell as we have used it.
 					break;
@@ -3,6 +3,7 @@
 
 #include "status.hpp"
 
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <functional>
@@ -581,6 +582,24 @@ uint64 SizeFixDatabase::parseBodyNode(const ryml::NodeRef& node) {
 	return 1;
 }
 
+/// Size modifiers per weapon type, flattened from size_fix_db once it is loaded
+static int32 size_fix_table[MAX_WEAPON_TYPE][SZ_ALL];
+
+/**
+ * Flattens the loaded entries into size_fix_table, weapon types without an entry deal full damage
+ */
+void SizeFixDatabase::loadingFinished(){
+	std::fill_n( &size_fix_table[0][0], MAX_WEAPON_TYPE * SZ_ALL, 100 );
+
+	for( const auto& it : *this ){
+		size_fix_table[it.first][SZ_SMALL] = it.second->small;
+		size_fix_table[it.first][SZ_MEDIUM] = it.second->medium;
+		size_fix_table[it.first][SZ_BIG] = it.second->large;
+	}
+
+	TypesafeYamlDatabase::loadingFinished();
+}
+
 SizeFixDatabase size_fix_db;
 
 const std::string EnchantgradeDatabase::getDefaultLocation(){
@@ -1185,7 +1204,8 @@ status_change::status_change(){
 #ifndef RENEWAL
 	this->sg_counter = 0;
 #endif
-	this->data = {};
+	this->active.reset();
+	this->data.clear();
 	this->lastStatus = { SC_NONE, nullptr };
 }
 
@@ -1201,7 +1221,14 @@ status_change_entry* status_change::getSCE( enum sc_type type ){
 		return this->lastStatus.second;
 	}
 
-	status_change_entry* sc = util::umap_find( this->data, type );
+	status_change_entry* sc = nullptr;
+
+	// Most lookups are for inactive status changes, the bitset answers them without searching
+	if( type > SC_NONE && type < SC_MAX && this->active.test( type ) ){
+		auto it = std::lower_bound( this->data.begin(), this->data.end(), type, []( const auto& entry, sc_type type ){ return entry.first < type; } );
+
+		sc = it->second.get();
+	}
 
 	this->lastStatus.first = type;
 	this->lastStatus.second = sc;
@@ -1214,10 +1241,15 @@ status_change_entry* status_change::getSCE( uint32 type ){
 }
 
 status_change_entry* status_change::createSCE( enum sc_type type ){
-	status_change_entry& sc = this->data[type];
+	auto it = std::lower_bound( this->data.begin(), this->data.end(), type, []( const auto& entry, sc_type type ){ return entry.first < type; } );
+
+	if( it == this->data.end() || it->first != type ){
+		it = this->data.emplace( it, type, std::make_unique<status_change_entry>() );
+		this->active.set( type );
+	}
 
 	this->lastStatus.first = type;
-	this->lastStatus.second = &sc;
+	this->lastStatus.second = it->second.get();
 
 	return this->lastStatus.second;
 }
@@ -1226,12 +1258,32 @@ status_change_entry* status_change::createSCE( enum sc_type type ){
  * free the sce, then clear it
  */
 void status_change::deleteSCE(enum sc_type type) {
-	this->data.erase( type );
+	if( type > SC_NONE && type < SC_MAX && this->active.test( type ) ){
+		auto it = std::lower_bound( this->data.begin(), this->data.end(), type, []( const auto& entry, sc_type type ){ return entry.first < type; } );
+
+		this->data.erase( it );
+		this->active.reset( type );
+	}
 
 	this->lastStatus.first = type;
 	this->lastStatus.second = nullptr;
 }
 
+/**
+ * Finds the next active status change, allows to end status changes while iterating
+ * @param type: Previous status change or SC_NONE to start
+ * @return Next active status change after type or SC_NONE
+ */
+enum sc_type status_change::nextSCE( enum sc_type type ){
+	auto it = std::upper_bound( this->data.begin(), this->data.end(), type, []( sc_type type, const auto& entry ){ return type < entry.first; } );
+
+	if( it == this->data.end() ){
+		return SC_NONE;
+	}
+
+	return it->first;
+}
+
 bool status_change::empty(){
 	return this->data.empty();
 }
@@ -1240,11 +1292,11 @@ size_t status_change::size(){
 	return this->data.size();
 }
 
-std::unordered_map<enum sc_type, status_change_entry>::const_iterator status_change::begin(){
+std::vector<std::pair<enum sc_type, std::unique_ptr<status_change_entry>>>::const_iterator status_change::begin(){
 	return this->data.begin();
 }
 
-std::unordered_map<enum sc_type, status_change_entry>::const_iterator status_change::end(){
+std::vector<std::pair<enum sc_type, std::unique_ptr<status_change_entry>>>::const_iterator status_change::end(){
 	return this->data.end();
 }
 
@@ -1553,8 +1605,11 @@ int32 status_damage(block_list *src,block_list *target,int64 dhp, int64 dsp, int
 		if( sc ) {
 			struct status_change_entry *sce;
 
-			for (const auto &it : status_db) {
-				sc_type type = static_cast<sc_type>(it.first);
+			for (sc_type type = sc->nextSCE(SC_NONE); type != SC_NONE; type = sc->nextSCE(type)) {
+				std::shared_ptr<s_status_change_db> scdb = status_db.find(type);
+
+				if (scdb == nullptr)
+					continue;
 
 				// For non-players, Wink Charm, Voice of Siren and Deep Sleep end only when damage was dealt (e.g. Wink Charm does not end itself)
 				// For players, these status changes end even if no damage was dealt (e.g. Provoke ends them on players but not on monsters)
@@ -1562,7 +1617,7 @@ int32 status_damage(block_list *src,block_list *target,int64 dhp, int64 dsp, int
 				if ((type == SC_WINKCHARM || type == SC_VOICEOFSIREN || type == SC_DEEPSLEEP) && target->type != BL_PC && hp == 0)
 					continue;
 
-				if (sc->getSCE(type) && it.second->flag[SCF_REMOVEONDAMAGED]) {
+				if (scdb->flag[SCF_REMOVEONDAMAGED]) {
 					// A status change that gets broken by damage should still be considered when calculating if a status change can be applied or not (for the same attack).
 					// !TODO: This is a temporary solution until we refactor the code so that the calculation of an SC is done at the start of an attack rather than after the damage was applied.
 					if (sc->opt1 > OPT1_NONE && sc->lastEffectTimer == INVALID_TIMER) {
@@ -2910,8 +2965,10 @@ int32 status_calc_mob_(mob_data* md, uint8 opt)
 	if (flag&16 && mbl) { // Max HP setting from Summon Flora/marine Sphere
 		struct unit_data *ud = unit_bl2ud(mbl);
 		// Remove special AI when this is used by regular mobs.
-		if (mbl->type == BL_MOB && !((TBL_MOB*)mbl)->special_state.ai)
+		if (mbl->type == BL_MOB && !((TBL_MOB*)mbl)->special_state.ai) {
 			md->special_state.ai = AI_NONE;
+			map_presence_refresh(*md);
+		}
 		if (ud) { 
 			// Different levels of HP according to skill level
 			if(!ud->skill_id) // !FIXME: We lost the unit data for magic decoy in somewhere before this
@@ -3733,41 +3790,234 @@ bool status_calc_cart_weight(map_session_data *sd, enum e_status_calc_weight_opt
 	return true;
 }
 
+/// Player fields that are reset at the beginning of status_calc_pc_sub and set by bonus scripts
+#define STATUS_PC_LAYER_FIELDS( F ) \
+	F( castrate ) F( hprate ) F( sprate ) F( aprate ) F( dsprate ) F( hprecov_rate ) F( sprecov_rate ) F( matk_rate ) \
+	F( critical_rate ) F( hit_rate ) F( flee_rate ) F( flee2_rate ) F( def_rate ) F( def2_rate ) F( mdef_rate ) F( mdef2_rate ) \
+	F( patk_rate ) F( smatk_rate ) F( res_rate ) F( mres_rate ) F( hplus_rate ) F( crate_rate ) F( add_max_weight ) \
+	F( indexed_bonus ) F( right_weapon ) F( left_weapon ) F( special_state ) F( bonus ) \
+	F( autospell ) F( autospell2 ) F( autospell3 ) F( addeff ) F( addeff_atked ) F( addeff_onskill ) \
+	F( skillatk ) F( skillusesprate ) F( skillusesp ) F( skillheal ) F( skillheal2 ) F( skillblown ) F( skillcastrate ) \
+	F( skillfixcastrate ) F( subskill ) F( skillcooldown ) F( skillfixcast ) F( skillvarcast ) F( skilldelay ) \
+	F( itemhealrate ) F( add_def ) F( add_mdef ) F( add_mdmg ) F( reseff ) F( itemgrouphealrate ) F( itemsphealrate ) \
+	F( itemgroupsphealrate ) F( add_drop ) F( subele2 ) F( sp_vanish ) F( hp_vanish ) F( subrace3 ) \
+	F( autobonus ) F( autobonus2 ) F( autobonus3 ) \
+	F( hp_loss ) F( sp_loss ) F( hp_regen ) F( sp_regen ) F( percent_hp_regen ) F( percent_sp_regen ) \
+	F( def_set_race ) F( mdef_set_race ) F( norecover_state_race ) F( hp_vanish_race ) F( sp_vanish_race )
+
+/// Equipment layer of status_calc_pc_sub: skill tree, equipment, combos, cards and random options
+/// Restored instead of running all item scripts again, when only scripts of status changes changed.
+struct s_status_pc_layer {
+	bool valid;
+	int16 m; ///< Map the layer was calculated on, equipment can be restricted on some maps
+	uint32 generation; ///< status_calc_pc_layer_generation when the layer was calculated
+	pet_data* pd; ///< Pet whose autobonuses were restored
+	struct status_data base_status;
+	decltype( mmo_charstatus::skill ) skill; ///< Skill tree, including skills granted by items
+	uint8 regen_block;
+	std::vector<std::shared_ptr<s_petautobonus>> pet_autobonus, pet_autobonus2, pet_autobonus3;
+#define STATUS_PC_LAYER_DECLARE( field ) decltype( map_session_data::field ) field;
+	STATUS_PC_LAYER_FIELDS( STATUS_PC_LAYER_DECLARE )
+#undef STATUS_PC_LAYER_DECLARE
+};
+
+static struct s_status_calc_pc_stats {
+	uint64 full; ///< Calculations that ran all scripts
+	uint64 partial; ///< Calculations that reused the equipment layer
+	uint64 invalid; ///< Partial calculations that had to run all scripts
+	uint64 untracked; ///< Partial calculations that changed more than the tracked base status
+	uint64 flags; ///< Battle status flags recalculated after partial calculations
+	uint64 compiled; ///< Item scripts applied as bonus lists
+	uint64 scripts; ///< Item scripts run by the script engine
+	std::chrono::nanoseconds equip_time; ///< Time spent on the equipment of full calculations
+} status_calc_pc_stats;
+
+static uint32 status_calc_pc_layer_generation; ///< Changes whenever all equipment layers have to be recalculated
+
 /**
- * Calculates player data from scratch without counting SC adjustments
- * Should be invoked whenever players raise stats, learn passive skills or change equipment
- * @param sd: Player object
- * @param opt: Whether it is first calc (login) or not
- * @return (-1) for too many recursive calls, (1) recursive call, (0) success
+ * Applies the script of an equipped item or card
+ * @param sd: Player
+ * @param item: Item whose script is applied
  */
-int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
-{
-	static int32 calculating = 0; ///< Check for recursive call preemption. [Skotlex]
-	struct status_data *base_status; ///< Pointer to the player's base status
-	status_change *sc = &sd->sc;
-	struct s_skill b_skill[MAX_SKILL]; ///< Previous skill tree
-	int32 i, skill, refinedef = 0;
-	int16 index = -1;
+static void status_calc_pc_item_script( map_session_data* sd, item_data* item ){
+	if( item->script_compiled ){
+		script_run_bonus( sd, item->script_bonus );
+		status_calc_pc_stats.compiled++;
+	}else{
+		run_script( item->script, 0, sd->id, 0 );
+		status_calc_pc_stats.scripts++;
+	}
+}
 
-	if (++calculating > 10) // Too many recursive calls!
-		return -1;
+template <typename T>
+static void status_layer_copy( T& dst, const T& src ){
+	dst = src;
+}
 
-	// Remember player-specific values that are currently being shown to the client (for refresh purposes)
-	memcpy(b_skill, &sd->status.skill, sizeof(b_skill));
+template <typename T, size_t N>
+static void status_layer_copy( T (&dst)[N], const T (&src)[N] ){
+	std::copy( std::begin( src ), std::end( src ), std::begin( dst ) );
+}
+
+/**
+ * Checks if the equipment layer of a player can be reused
+ * Everything but status changes invalidates it with a full calculation (status_calc_pc), see status_calc_pc_status
+ * @param sd: Player
+ * @return true if only the status change layer has to be recalculated
+ */
+static bool status_calc_pc_layer_valid( map_session_data& sd ){
+	if( !battle_config.status_calc_layer_cache || sd.status_layer == nullptr )
+		return false;
 
-	pc_calc_skilltree(sd);	// SkillTree calculation
+	const s_status_pc_layer& layer = *sd.status_layer;
 
-	if (opt&SCO_FIRST) {
-		// Load Hp/SP from char-received data.
-		sd->battle_status.hp = sd->status.hp;
-		sd->battle_status.sp = sd->status.sp;
-		if (battle_config.keep_ap_on_logout == 1)
-			sd->battle_status.ap = sd->status.ap;
-		sd->regen.sregen = &sd->sregen;
-		sd->regen.ssregen = &sd->ssregen;
+	return layer.valid && layer.m == sd.m && layer.pd == sd.pd && layer.generation == status_calc_pc_layer_generation;
+}
+
+/**
+ * Invalidates the equipment layers of all players
+ * Map flags and zones decide which equipment works on a map, see itemdb_isNoEquip
+ */
+void status_calc_pc_layer_invalidate( void ){
+	status_calc_pc_layer_generation++;
+}
+
+/**
+ * Stores the equipment layer of a player after the item scripts ran
+ * @param sd: Player
+ */
+static void status_calc_pc_layer_store( map_session_data& sd ){
+	if( !battle_config.status_calc_layer_cache )
+		return;
+
+	if( sd.status_layer == nullptr )
+		sd.status_layer = std::make_shared<s_status_pc_layer>();
+
+	s_status_pc_layer& layer = *sd.status_layer;
+
+#define STATUS_PC_LAYER_STORE( field ) status_layer_copy( layer.field, sd.field );
+	STATUS_PC_LAYER_FIELDS( STATUS_PC_LAYER_STORE )
+#undef STATUS_PC_LAYER_STORE
+
+	memcpy( &layer.base_status, &sd.base_status, sizeof( layer.base_status ) );
+	status_layer_copy( layer.skill, sd.status.skill );
+	layer.regen_block = sd.regen.state.block;
+	layer.m = sd.m;
+	layer.pd = sd.pd;
+	layer.generation = status_calc_pc_layer_generation;
+
+	if( sd.pd != nullptr ){
+		layer.pet_autobonus = sd.pd->autobonus;
+		layer.pet_autobonus2 = sd.pd->autobonus2;
+		layer.pet_autobonus3 = sd.pd->autobonus3;
+	}else{
+		layer.pet_autobonus.clear();
+		layer.pet_autobonus2.clear();
+		layer.pet_autobonus3.clear();
 	}
 
-	base_status = &sd->base_status;
+	layer.valid = true;
+}
+
+/**
+ * Restores the equipment layer of a player, as if all item scripts ran again
+ * @param sd: Player
+ */
+static void status_calc_pc_layer_restore( map_session_data& sd ){
+	const s_status_pc_layer& layer = *sd.status_layer;
+
+#define STATUS_PC_LAYER_RESTORE( field ) status_layer_copy( sd.field, layer.field );
+	STATUS_PC_LAYER_FIELDS( STATUS_PC_LAYER_RESTORE )
+#undef STATUS_PC_LAYER_RESTORE
+
+	// Current HP/SP/AP and a permanent speed are not part of the calculation
+	struct status_data* base_status = &sd.base_status;
+	uint16 speed = base_status->speed;
+
+	status_cpy( base_status, &layer.base_status );
+
+	if( sd.state.permanent_speed )
+		base_status->speed = speed;
+
+	status_layer_copy( sd.status.skill, layer.skill );
+	sd.regen.state.block = layer.regen_block;
+
+	if( sd.pd != nullptr ){
+		sd.pd->autobonus = layer.pet_autobonus;
+		sd.pd->autobonus2 = layer.pet_autobonus2;
+		sd.pd->autobonus3 = layer.pet_autobonus3;
+	}
+}
+
+/**
+ * Folds the card fix bonuses of a player into the tables used by battle_calc_cardfix
+ * Must be called once all bonuses are applied
+ * @param sd: Player
+ */
+static void status_calc_cardfix( map_session_data& sd ){
+	auto& bonus = sd.indexed_bonus;
+	auto& cardfix = sd.cardfix;
+	const weapon_data* hands[] = { &sd.right_weapon, &sd.left_weapon };
+
+	for( int32 hand = CARDFIX_RIGHT; hand <= CARDFIX_LEFT; hand++ ){
+		const weapon_data& wd = *hands[hand];
+
+		for( int32 i = 0; i < ELE_MAX; i++ ){
+			cardfix.addele[hand][i] = wd.addele[i] + wd.addele[ELE_ALL];
+		}
+		for( int32 i = 0; i < RC_MAX; i++ ){
+			cardfix.addrace[hand][i] = wd.addrace[i] + wd.addrace[RC_ALL];
+		}
+		for( int32 i = 0; i < CLASS_MAX; i++ ){
+			cardfix.addclass[hand][i] = wd.addclass[i] + wd.addclass[CLASS_ALL];
+		}
+		for( int32 i = 0; i < SZ_MAX; i++ ){
+			cardfix.addsize[hand][i] = wd.addsize[i] + wd.addsize[SZ_ALL];
+		}
+	}
+
+	for( int32 i = 0; i < ELE_MAX; i++ ){
+		cardfix.addele[CARDFIX_ARROW][i] = cardfix.addele[CARDFIX_RIGHT][i] + bonus.arrow_addele[i] + bonus.arrow_addele[ELE_ALL];
+		cardfix.magic_addele[i] = bonus.magic_addele[i] + bonus.magic_addele[ELE_ALL] + bonus.magic_addele_script[i] + bonus.magic_addele_script[ELE_ALL];
+		cardfix.magic_atk_ele[i] = bonus.magic_atk_ele[i] + bonus.magic_atk_ele[ELE_ALL];
+		cardfix.subele[i] = bonus.subele[i] + bonus.subele[ELE_ALL] + bonus.subele_script[i] + bonus.subele_script[ELE_ALL];
+		cardfix.subdefele[i] = bonus.subdefele[i] + bonus.subdefele[ELE_ALL];
+		cardfix.magic_subdefele[i] = bonus.magic_subdefele[i] + bonus.magic_subdefele[ELE_ALL];
+	}
+	for( int32 i = 0; i < RC_MAX; i++ ){
+		cardfix.addrace[CARDFIX_ARROW][i] = cardfix.addrace[CARDFIX_RIGHT][i] + bonus.arrow_addrace[i] + bonus.arrow_addrace[RC_ALL];
+		cardfix.magic_addrace[i] = bonus.magic_addrace[i] + bonus.magic_addrace[RC_ALL];
+		cardfix.subrace[i] = bonus.subrace[i] + bonus.subrace[RC_ALL];
+	}
+	for( int32 i = 0; i < CLASS_MAX; i++ ){
+		cardfix.addclass[CARDFIX_ARROW][i] = cardfix.addclass[CARDFIX_RIGHT][i] + bonus.arrow_addclass[i] + bonus.arrow_addclass[CLASS_ALL];
+		cardfix.magic_addclass[i] = bonus.magic_addclass[i] + bonus.magic_addclass[CLASS_ALL];
+		cardfix.subclass[i] = bonus.subclass[i] + bonus.subclass[CLASS_ALL];
+	}
+	for( int32 i = 0; i < SZ_MAX; i++ ){
+		cardfix.addsize[CARDFIX_ARROW][i] = cardfix.addsize[CARDFIX_RIGHT][i] + bonus.arrow_addsize[i] + bonus.arrow_addsize[SZ_ALL];
+		cardfix.magic_addsize[i] = bonus.magic_addsize[i] + bonus.magic_addsize[SZ_ALL];
+		cardfix.subsize[i] = bonus.subsize[i] + bonus.subsize[SZ_ALL];
+		cardfix.weapon_subsize[i] = bonus.weapon_subsize[i] + bonus.weapon_subsize[SZ_ALL];
+		cardfix.magic_subsize[i] = bonus.magic_subsize[i] + bonus.magic_subsize[SZ_ALL];
+	}
+}
+
+/**
+ * Calculates the equipment layer of a player from scratch, see status_calc_pc_sub
+ * @param sd: Player object
+ * @param opt: Whether it is first calc (login) or not
+ * @param calculating: Recursion counter of status_calc_pc_sub, reset when an item script calculated the player again
+ * @return false if the calculation was aborted
+ */
+static bool status_calc_pc_equip(map_session_data* sd, uint8 opt, const int32& calculating)
+{
+	struct status_data *base_status = &sd->base_status;
+	int32 i, refinedef = 0;
+	int16 index = -1;
+
+	auto equip_start = std::chrono::steady_clock::now();
+
 	// These are not zeroed. [zzo]
 	sd->hprate = 100;
 	sd->sprate = 100;
@@ -3790,12 +4040,6 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 	memset (&sd->right_weapon.overrefine, 0, sizeof(sd->right_weapon) - sizeof(sd->right_weapon.atkmods));
 	memset (&sd->left_weapon.overrefine, 0, sizeof(sd->left_weapon) - sizeof(sd->left_weapon.atkmods));
 
-	if (sd->special_state.intravision)
-		clif_status_load(sd, EFST_CLAIRVOYANCE, 0);
-
-	if (sd->special_state.no_walk_delay)
-		clif_status_load(sd, EFST_ENDURE, 0);
-
 	memset(&sd->special_state,0,sizeof(sd->special_state));
 
 	if (pc_isvip(sd)) // Magic Stone requirement avoidance for VIP.
@@ -3909,7 +4153,7 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 			|| !itemdb_isNoEquip(sd->inventory_data[index],sd->m))) { // Execute equip-script on login
 			run_script(sd->inventory_data[index]->equip_script,0,sd->id,0);
 			if (!calculating)
-				return 1;
+				return false;
 		}
 
 		// Sanitize the refine level in case someone decreased the value inbetween
@@ -3978,12 +4222,12 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 			if(sd->inventory_data[index]->script && (pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) || !itemdb_isNoEquip(sd->inventory_data[index],sd->m))) {
 				if (wd == &sd->left_weapon) {
 					sd->state.lr_flag = LR_FLAG_WEAPON;
-					run_script(sd->inventory_data[index]->script,0,sd->id,0);
+					status_calc_pc_item_script(sd, sd->inventory_data[index]);
 					sd->state.lr_flag = LR_FLAG_NONE;
 				} else
-					run_script(sd->inventory_data[index]->script,0,sd->id,0);
+					status_calc_pc_item_script(sd, sd->inventory_data[index]);
 				if (!calculating) // Abort, run_script retriggered this. [Skotlex]
-					return 1;
+					return false;
 			}
 #ifdef RENEWAL
 			if (sd->bonus.weapon_matk_rate)
@@ -4012,17 +4256,17 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 			if(sd->inventory_data[index]->script && (pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) || !itemdb_isNoEquip(sd->inventory_data[index],sd->m))) {
 				if( i == EQI_HAND_L ) // Shield
 					sd->state.lr_flag = LR_FLAG_SHIELD;
-				run_script(sd->inventory_data[index]->script,0,sd->id,0);
+				status_calc_pc_item_script(sd, sd->inventory_data[index]);
 				if( i == EQI_HAND_L ) // Shield
 					sd->state.lr_flag = LR_FLAG_NONE;
 				if (!calculating) // Abort, run_script retriggered this. [Skotlex]
-					return 1;
+					return false;
 			}
 		} else if( sd->inventory_data[index]->type == IT_SHADOWGEAR ) { // Shadow System
 			if (sd->inventory_data[index]->script && (pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) || !itemdb_isNoEquip(sd->inventory_data[index],sd->m))) {
-				run_script(sd->inventory_data[index]->script,0,sd->id,0);
+				status_calc_pc_item_script(sd, sd->inventory_data[index]);
 				if( !calculating )
-					return 1;
+					return false;
 			}
 		}
 	}
@@ -4033,10 +4277,10 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 			sd->bonus.arrow_atk += sd->inventory_data[index]->atk;
 			sd->state.lr_flag = LR_FLAG_ARROW;
 			if( !itemdb_group.item_exists(IG_THROWABLE, sd->inventory_data[index]->nameid) ) // Don't run scripts on throwable items
-				run_script(sd->inventory_data[index]->script,0,sd->id,0);
+				status_calc_pc_item_script(sd, sd->inventory_data[index]);
 			sd->state.lr_flag = LR_FLAG_NONE;
 			if (!calculating) // Abort, run_script retriggered status_calc_pc. [Skotlex]
-				return 1;
+				return false;
 		}
 	}
 
@@ -4073,7 +4317,7 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 			run_script(combo->bonus, 0, sd->id, 0);
 
 			if (!calculating) // Abort, run_script retriggered this
-				return 1;
+				return false;
 		}
 	}
 
@@ -4113,7 +4357,7 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 				if (opt&SCO_FIRST && data->equip_script && (pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) || !itemdb_isNoEquip(data.get(), sd->m))) {// Execute equip-script on login
 					run_script(data->equip_script,0,sd->id,0);
 					if (!calculating)
-						return 1;
+						return false;
 				}
 				if(!data->script)
 					continue;
@@ -4121,12 +4365,12 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 					continue;
 				if(i == EQI_HAND_L && sd->inventory.u.items_inventory[index].equip == EQP_HAND_L) { // Left hand status.
 					sd->state.lr_flag = LR_FLAG_WEAPON;
-					run_script(data->script,0,sd->id,0);
+					status_calc_pc_item_script(sd, data.get());
 					sd->state.lr_flag = LR_FLAG_NONE;
 				} else
-					run_script(data->script,0,sd->id,0);
+					status_calc_pc_item_script(sd, data.get());
 				if (!calculating) // Abort, run_script his function. [Skotlex]
-					return 1;
+					return false;
 			}
 		}
 	}
@@ -4167,11 +4411,80 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 				else
 					run_script(data->script, 0, sd->id, 0);
 				if (!calculating)
-					return 1;
+					return false;
 			}
 		}
 		current_equip_opt_index = -1;
 	}
+
+	status_calc_pc_layer_store(*sd);
+	status_calc_pc_stats.full++;
+	status_calc_pc_stats.equip_time += std::chrono::steady_clock::now() - equip_start;
+
+	return true;
+}
+
+/**
+ * Calculates player data from scratch without counting SC adjustments
+ * Should be invoked whenever players raise stats, learn passive skills or change equipment
+ * @param sd: Player object
+ * @param opt: Whether it is first calc (login) or not
+ * @return (-1) for too many recursive calls, (1) recursive call, (0) success
+ */
+int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
+{
+	static int32 calculating = 0; ///< Check for recursive call preemption. [Skotlex]
+	struct status_data *base_status; ///< Pointer to the player's base status
+	status_change *sc = &sd->sc;
+	struct s_skill b_skill[MAX_SKILL]; ///< Previous skill tree
+	int32 i, skill, refinedef = 0;
+	int16 index = -1;
+
+	if (++calculating > 10) // Too many recursive calls!
+		return -1;
+
+	// Remember player-specific values that are currently being shown to the client (for refresh purposes)
+	memcpy(b_skill, &sd->status.skill, sizeof(b_skill));
+
+	// Only the status changes changed, the equipment layer can be reused
+	bool reuse_layer = (opt&SCO_STATUS) && !(opt&SCO_FIRST) && status_calc_pc_layer_valid(*sd);
+
+	if (!reuse_layer) {
+		if (sd->status_layer != nullptr) // Invalid until all item scripts ran
+			sd->status_layer->valid = false;
+
+		pc_calc_skilltree(sd);	// SkillTree calculation
+	}
+
+	if (opt&SCO_FIRST) {
+		// Load Hp/SP from char-received data.
+		sd->battle_status.hp = sd->status.hp;
+		sd->battle_status.sp = sd->status.sp;
+		if (battle_config.keep_ap_on_logout == 1)
+			sd->battle_status.ap = sd->status.ap;
+		sd->regen.sregen = &sd->sregen;
+		sd->regen.ssregen = &sd->ssregen;
+	}
+
+	base_status = &sd->base_status;
+	if (sd->special_state.intravision)
+		clif_status_load(sd, EFST_CLAIRVOYANCE, 0);
+
+	if (sd->special_state.no_walk_delay)
+		clif_status_load(sd, EFST_ENDURE, 0);
+
+	if (reuse_layer) {
+		status_calc_pc_layer_restore(*sd);
+		status_calc_pc_stats.partial++;
+
+		// Same state as after parsing the equipment
+		current_equip_item_index = sd->equip_index[EQI_MAX - 1];
+		current_equip_combo_pos = 0;
+		current_equip_opt_index = -1;
+		current_equip_card_id = 0;
+	} else if (!status_calc_pc_equip(sd, opt, calculating))
+		return 1;
+
 	if (sd && sd->sc.getSCE(SC_SPIRIT)) {
 			auto spirit = sc->getSCE(SC_SPIRIT);
 			if (spirit != nullptr){
@@ -4188,8 +4501,9 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 				run_script(data->script, 0, sd->id, 0);
 		}
 
-		for( const auto& it : *sc ){
-			if( std::shared_ptr<s_status_change_db> scdb = status_db.find( it.first ); scdb != nullptr && scdb->script != nullptr ){
+		// The scripts may start or end status changes
+		for( sc_type type = sc->nextSCE( SC_NONE ); type != SC_NONE; type = sc->nextSCE( type ) ){
+			if( std::shared_ptr<s_status_change_db> scdb = status_db.find( type ); scdb != nullptr && scdb->script != nullptr ){
 				run_script( scdb->script, 0, sd->id, 0 );
 			}
 		}
@@ -4218,17 +4532,11 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 	sd->bonus.splash_range += sd->bonus.splash_add_range;
 
 	// Damage modifiers from weapon type
-	if( std::shared_ptr<s_sizefix_db> right_weapon = size_fix_db.find(sd->weapontype1); right_weapon != nullptr ){
-		sd->right_weapon.atkmods[SZ_SMALL] = right_weapon->small;
-		sd->right_weapon.atkmods[SZ_MEDIUM] = right_weapon->medium;
-		sd->right_weapon.atkmods[SZ_BIG] = right_weapon->large;
-	}
+	if( sd->weapontype1 >= W_FIST && sd->weapontype1 < MAX_WEAPON_TYPE )
+		memcpy( sd->right_weapon.atkmods, size_fix_table[sd->weapontype1], sizeof( sd->right_weapon.atkmods ) );
 
-	if( std::shared_ptr<s_sizefix_db> left_weapon = size_fix_db.find(sd->weapontype2); left_weapon != nullptr ){
-		sd->left_weapon.atkmods[SZ_SMALL] = left_weapon->small;
-		sd->left_weapon.atkmods[SZ_MEDIUM] = left_weapon->medium;
-		sd->left_weapon.atkmods[SZ_BIG] = left_weapon->large;
-	}
+	if( sd->weapontype2 >= W_FIST && sd->weapontype2 < MAX_WEAPON_TYPE )
+		memcpy( sd->left_weapon.atkmods, size_fix_table[sd->weapontype2], sizeof( sd->left_weapon.atkmods ) );
 
 	if((pc_isriding(sd) || pc_isridingdragon(sd)) &&
 		(sd->status.weapon==W_1HSPEAR || sd->status.weapon==W_2HSPEAR))
@@ -4958,6 +5266,7 @@ int32 status_calc_pc_sub(map_session_data* sd, uint8 opt)
 			sd->bonus.long_attack_atk_rate += i;
 		}
 	}
+	status_calc_cardfix(*sd);
 	status_cpy(&sd->battle_status, base_status);
 
 // ----- CLIENT-SIDE REFRESH -----
@@ -5532,7 +5841,7 @@ void status_calc_state_sub( block_list& bl, status_change& sc, bool start, std::
 		}
 
 		// Check the conditional restrictions
-		if( !func_switch( bl, sc, restriction, it.first, it.second ) ){
+		if( !func_switch( bl, sc, restriction, it.first, *it.second ) ){
 			const char* constant_sc = script_get_constant_str( "SC_", it.first );
 
 			if( constant_sc == nullptr ){
@@ -6509,6 +6818,144 @@ void status_calc_bl_main(block_list& bl, std::bitset<SCB_MAX> flag)
 		status_calc_regen_rate(&bl, status_get_regen_data(&bl), sc);
 }
 
+/**
+ * Compares the base status of a player before and after a recalculation of the status change layer
+ * Changed fields are copied to the battle status and flagged to be recalculated by status_calc_bl_main.
+ * @param prev: Base status before the recalculation
+ * @param base: Current base status
+ * @param battle: Battle status to update
+ * @param flag: Flags of the changed fields
+ * @return false if something changed that is not tracked by a flag
+ */
+static bool status_calc_pc_base_diff( const status_data& prev, const status_data& base, status_data& battle, std::bitset<SCB_MAX>& flag ){
+#define STATUS_BASE_DIFF( field, scb ) if( prev.field != base.field ){ battle.field = base.field; flag.set( scb ); }
+	STATUS_BASE_DIFF( max_hp, SCB_MAXHP )
+	STATUS_BASE_DIFF( max_sp, SCB_MAXSP )
+	STATUS_BASE_DIFF( max_ap, SCB_MAXAP )
+	STATUS_BASE_DIFF( str, SCB_STR )
+	STATUS_BASE_DIFF( agi, SCB_AGI )
+	STATUS_BASE_DIFF( vit, SCB_VIT )
+	STATUS_BASE_DIFF( int_, SCB_INT )
+	STATUS_BASE_DIFF( dex, SCB_DEX )
+	STATUS_BASE_DIFF( luk, SCB_LUK )
+	STATUS_BASE_DIFF( pow, SCB_POW )
+	STATUS_BASE_DIFF( sta, SCB_STA )
+	STATUS_BASE_DIFF( wis, SCB_WIS )
+	STATUS_BASE_DIFF( spl, SCB_SPL )
+	STATUS_BASE_DIFF( con, SCB_CON )
+	STATUS_BASE_DIFF( crt, SCB_CRT )
+	STATUS_BASE_DIFF( eatk, SCB_WATK )
+	STATUS_BASE_DIFF( batk, SCB_BATK )
+#ifdef RENEWAL
+	STATUS_BASE_DIFF( watk, SCB_WATK )
+	STATUS_BASE_DIFF( watk2, SCB_WATK )
+#endif
+	STATUS_BASE_DIFF( matk_min, SCB_MATK )
+	STATUS_BASE_DIFF( matk_max, SCB_MATK )
+	STATUS_BASE_DIFF( speed, SCB_SPEED )
+	STATUS_BASE_DIFF( amotion, SCB_ASPD )
+	STATUS_BASE_DIFF( clientamotion, SCB_ASPD )
+	STATUS_BASE_DIFF( adelay, SCB_ASPD )
+	STATUS_BASE_DIFF( dmotion, SCB_DSPD )
+	STATUS_BASE_DIFF( mode, SCB_MODE )
+	STATUS_BASE_DIFF( hit, SCB_HIT )
+	STATUS_BASE_DIFF( flee, SCB_FLEE )
+	STATUS_BASE_DIFF( cri, SCB_CRI )
+	STATUS_BASE_DIFF( flee2, SCB_FLEE2 )
+	STATUS_BASE_DIFF( def2, SCB_DEF2 )
+	STATUS_BASE_DIFF( mdef2, SCB_MDEF2 )
+#ifdef RENEWAL_ASPD
+	STATUS_BASE_DIFF( aspd_rate2, SCB_ASPD )
+#endif
+	STATUS_BASE_DIFF( aspd_rate, SCB_ASPD )
+	STATUS_BASE_DIFF( patk, SCB_PATK )
+	STATUS_BASE_DIFF( smatk, SCB_SMATK )
+	STATUS_BASE_DIFF( res, SCB_RES )
+	STATUS_BASE_DIFF( mres, SCB_MRES )
+	STATUS_BASE_DIFF( hplus, SCB_HPLUS )
+	STATUS_BASE_DIFF( crate, SCB_CRATE )
+	STATUS_BASE_DIFF( def, SCB_DEF )
+	STATUS_BASE_DIFF( mdef, SCB_MDEF )
+	STATUS_BASE_DIFF( def_ele, SCB_DEF_ELE )
+	STATUS_BASE_DIFF( ele_lv, SCB_DEF_ELE )
+	STATUS_BASE_DIFF( rhw.atk, SCB_WATK )
+	STATUS_BASE_DIFF( rhw.atk2, SCB_WATK )
+	STATUS_BASE_DIFF( rhw.ele, SCB_ATK_ELE )
+	STATUS_BASE_DIFF( lhw.atk, SCB_WATK )
+	STATUS_BASE_DIFF( lhw.atk2, SCB_WATK )
+	STATUS_BASE_DIFF( lhw.ele, SCB_ATK_ELE )
+#ifdef RENEWAL
+	STATUS_BASE_DIFF( rhw.matk, SCB_MATK )
+	STATUS_BASE_DIFF( rhw.wlv, SCB_WATK )
+	STATUS_BASE_DIFF( lhw.matk, SCB_MATK )
+	STATUS_BASE_DIFF( lhw.wlv, SCB_WATK )
+#endif
+#undef STATUS_BASE_DIFF
+
+	// Not recalculated by status_calc_bl_main at all
+	return prev.size == base.size && prev.race == base.race && prev.class_ == base.class_
+		&& prev.rhw.range == base.rhw.range && prev.lhw.range == base.lhw.range;
+}
+
+/**
+ * Recalculates the status change layer of a player, see status_calc_pc_sub
+ * status_calc_pc_ overwrites the whole battle status with the base status, this restores
+ * the battle status of everything that did not change in the base status instead.
+ * @param sd: Player
+ * @param flag: Flags of the status change that changed
+ * @param opt: Calculation options, including SCO_STATUS
+ * @return Flags for status_calc_bl_main
+ */
+static std::bitset<SCB_MAX> status_calc_pc_status( map_session_data& sd, std::bitset<SCB_MAX> flag, uint8 opt ){
+	if( !status_calc_pc_layer_valid( sd ) ){
+		status_calc_pc_stats.invalid++;
+		status_calc_pc_( &sd, opt&~SCO_STATUS );
+		return status_db.getSCB_ALL();
+	}
+
+	status_data base_prev, battle_prev;
+	decltype( sd.bonus ) bonus_prev;
+
+	memcpy( &base_prev, &sd.base_status, sizeof( base_prev ) );
+	memcpy( &battle_prev, &sd.battle_status, sizeof( battle_prev ) );
+	memcpy( &bonus_prev, &sd.bonus, sizeof( bonus_prev ) );
+
+	int32 matk_rate = sd.matk_rate, hprecov_rate = sd.hprecov_rate, sprecov_rate = sd.sprecov_rate;
+	int32 overrefine = sd.right_weapon.overrefine;
+
+	status_calc_pc_( &sd, opt );
+
+	flag.reset( SCB_BASE );
+
+	// Player bonuses that are used by status_calc_bl_main directly
+	if( memcmp( &bonus_prev, &sd.bonus, sizeof( bonus_prev ) ) != 0 || matk_rate != sd.matk_rate || hprecov_rate != sd.hprecov_rate
+		|| sprecov_rate != sd.sprecov_rate || overrefine != sd.right_weapon.overrefine
+		|| !status_calc_pc_base_diff( base_prev, sd.base_status, battle_prev, flag ) ){
+		status_calc_pc_stats.untracked++;
+		return status_db.getSCB_ALL();
+	}
+
+	status_cpy( &sd.battle_status, &battle_prev );
+	status_calc_pc_stats.flags += flag.count();
+
+	return flag;
+}
+
+/**
+ * Displays statistics of the player status calculations
+ */
+void status_calc_pc_report( void ){
+	uint64 layered = status_calc_pc_stats.partial - status_calc_pc_stats.untracked;
+
+	ShowInfo( "Status calc: " CL_WHITE "%" PRIu64 CL_RESET " full (" CL_WHITE "%" PRIu64 CL_RESET " without a reusable equipment layer), " CL_WHITE "%" PRIu64 CL_RESET " partial (" CL_WHITE "%" PRIu64 CL_RESET " recalculated the whole battle status).\n",
+		status_calc_pc_stats.full, status_calc_pc_stats.invalid, status_calc_pc_stats.partial, status_calc_pc_stats.untracked );
+	ShowInfo( "Status calc: " CL_WHITE "%.1f" CL_RESET " of " CL_WHITE "%" PRIuPTR CL_RESET " battle status flags recalculated after partial calculations on average.\n",
+		layered > 0 ? static_cast<double>( status_calc_pc_stats.flags ) / layered : 0., status_db.getSCB_ALL().count() );
+	ShowInfo( "Status calc: " CL_WHITE "%" PRIu64 CL_RESET " item scripts applied as bonus lists, " CL_WHITE "%" PRIu64 CL_RESET " run by the script engine, " CL_WHITE "%" PRId64 CL_RESET " us per full equipment calculation on average.\n",
+		status_calc_pc_stats.compiled, status_calc_pc_stats.scripts,
+		status_calc_pc_stats.full > 0 ? static_cast<int64>( std::chrono::duration_cast<std::chrono::microseconds>( status_calc_pc_stats.equip_time ).count() / status_calc_pc_stats.full ) : 0 );
+}
+
 /**
  * Recalculates parts of an objects status according to specified flags
  * Also sends updates to the client when necessary
@@ -6543,7 +6990,12 @@ void status_calc_bl_(block_list* bl, std::bitset<SCB_MAX> flag, uint8 opt)
 
 	if( flag[SCB_BASE] ) { // Calculate the object's base status too
 		switch( bl->type ) {
-		case BL_PC:  status_calc_pc_(BL_CAST(BL_PC,bl), opt);          break;
+		case BL_PC:
+			if( opt&SCO_STATUS )
+				flag = status_calc_pc_status( *BL_CAST(BL_PC,bl), flag, opt );
+			else
+				status_calc_pc_(BL_CAST(BL_PC,bl), opt);
+			break;
 		case BL_MOB: status_calc_mob_(BL_CAST(BL_MOB,bl), opt);        break;
 		case BL_PET: status_calc_pet_(BL_CAST(BL_PET,bl), opt);        break;
 		case BL_HOM: status_calc_homunculus_(BL_CAST(BL_HOM,bl), opt); break;
@@ -10645,10 +11097,10 @@ static bool status_change_start_post_delay(block_list* src, block_list* bl, sc_t
 
 	// Check for OPT1 stacking
 	if (sc->opt1 > OPT1_NONE && scdb->opt1 > OPT1_NONE) {
-		for (const auto &status_it : status_db) {
-			sc_type opt1_type = status_it.second->type;
+		for (sc_type opt1_type = sc->nextSCE(SC_NONE); opt1_type != SC_NONE; opt1_type = sc->nextSCE(opt1_type)) {
+			std::shared_ptr<s_status_change_db> opt1_scdb = status_db.find(opt1_type);
 
-			if (sc->getSCE(opt1_type) && status_it.second->opt1 > OPT1_NONE)
+			if (opt1_scdb != nullptr && opt1_scdb->opt1 > OPT1_NONE)
 				status_change_end(bl, opt1_type);
 		}
 	}
@@ -13195,7 +13647,7 @@ static bool status_change_start_post_delay(block_list* src, block_list* bl, sc_t
 	sce->val3 = val3;
 	sce->val4 = val4;
 	if (tick >= 0)
-		sce->timer = add_timer(gettick() + tick, status_change_timer, bl->id, type);
+		sce->timer = add_timer_batch(gettick() + tick, status_change_timer, bl->id, type);
 	else
 		sce->timer = INVALID_TIMER; // Infinite duration
 
@@ -13208,11 +13660,11 @@ static bool status_change_start_post_delay(block_list* src, block_list* bl, sc_t
 				case SC_MERC_SPUP:
 				// Status needs to be updated immediately and not at the end of the damage
 				case SC_EXTREMITYFIST:
-					status_calc_bl_(bl, calc_flag, SCO_FORCE);
+					status_calc_bl_(bl, calc_flag, SCO_FORCE | (scdb->layered ? SCO_STATUS : SCO_NONE));
 					break;
 				default:
 					if (!sd->state.connect_new)
-						status_calc_bl_(bl, calc_flag);
+						status_calc_bl_(bl, calc_flag, scdb->layered ? SCO_STATUS : SCO_NONE);
 					break;
 			}
 		} else
@@ -13366,13 +13818,14 @@ int32 status_change_clear(block_list* bl, int32 type)
 	if (sc->empty())
 		return 0;
 
-	for (const auto &it : status_db) {
-		sc_type status = static_cast<sc_type>(it.first);
+	// Ending a status change may end or start others, always continue after the last checked one
+	for (sc_type status = sc->nextSCE(SC_NONE); status != SC_NONE; status = sc->nextSCE(status)) {
+		std::shared_ptr<s_status_change_db> scdb = status_db.find(status);
 
-		if (!sc->getSCE(status))
+		if (scdb == nullptr)
 			continue;
 		if (type == 0) { // Type 0: PC killed
-			if (it.second->flag[SCF_NOREMOVEONDEAD]) {
+			if (scdb->flag[SCF_NOREMOVEONDEAD]) {
 				switch (status) {
 					case SC_ELEMENTALCHANGE: // Only when its Holy or Dark that it doesn't dispell on death
 						if (sc->getSCE(status)->val2 != ELE_HOLY && sc->getSCE(status)->val2 != ELE_DARK)
@@ -13383,7 +13836,7 @@ int32 status_change_clear(block_list* bl, int32 type)
 			}
 		}
 
-		if (type == 3 && it.second->flag[SCF_NOCLEARBUFF])
+		if (type == 3 && scdb->flag[SCF_NOCLEARBUFF])
 			continue;
 
 		status_change_end(bl, status);
@@ -14087,7 +14540,7 @@ int32 status_change_end( block_list* bl, enum sc_type type, int32 tid ){
 			status_calc_bl_(bl, calc_flag, SCO_FORCE);
 		} else
 #endif
-			status_calc_bl_(bl, calc_flag);
+			status_calc_bl_(bl, calc_flag, scdb->layered ? SCO_STATUS : SCO_NONE);
 	}
 
 	if(opt_flag[SCF_UNITMOVE]) // Out of hiding, invoke on place.
@@ -14146,7 +14599,7 @@ TIMER_FUNC(status_change_timer){
 	sd = BL_CAST(BL_PC, bl);
 
 	std::function<void (t_tick)> sc_timer_next = [&sce, &bl, &data](t_tick t) {
-		sce->timer = add_timer(t, status_change_timer, bl->id, data);
+		sce->timer = add_timer_batch(t, status_change_timer, bl->id, data);
 	};
 	
 	FreeBlockLock freeLock(false);
@@ -15320,12 +15773,14 @@ void status_change_clear_buffs(block_list* bl, uint8 type)
 		return;
 
 	//Clears buffs with specified flag and type
-	for (const auto &it : status_db) {
-		sc_type status = static_cast<sc_type>(it.first);
-		const std::bitset<SCF_MAX>& flag = it.second->flag;
-		bool end = false;
-		if (!sc->getSCE(status))
+	for (sc_type status = sc->nextSCE(SC_NONE); status != SC_NONE; status = sc->nextSCE(status)) {
+		std::shared_ptr<s_status_change_db> scdb = status_db.find(status);
+
+		if (scdb == nullptr)
 			continue;
+
+		const std::bitset<SCF_MAX>& flag = scdb->flag;
+		bool end = false;
 		// Skip status with SCF_NOCLEARBUFF, no matter what
 		if (flag[SCF_NOCLEARBUFF])
 			continue;
@@ -15424,17 +15879,121 @@ int32 status_change_spread(block_list *src, block_list *bl)
 	return hasSpread;
 }
 
+/// Units with natural regeneration, one column per looked up pointer so the pass does not resolve them again
+static struct s_status_regen_table {
+	std::vector<block_list*> bl;
+	std::vector<regen_data*> regen;
+	std::vector<status_data*> status;
+	std::unordered_map<int32, size_t> index; ///< Unit id -> row
+	bool iterating; ///< Rows must not move, removed rows are cleared and compacted after the pass
+	bool removed;
+} status_regen_table;
+
+static struct s_status_regen_stats {
+	uint64 passes;
+	uint64 units; ///< Units processed over all passes
+	std::chrono::nanoseconds time; ///< Time spent in the natural heal passes
+} status_regen_stats;
+
+/**
+ * Adds a unit to the natural heal processing
+ * @param bl: Object with natural regeneration [PC|HOM|MER|ELEM]
+ */
+void status_natural_heal_add(block_list* bl){
+	regen_data* regen = status_get_regen_data(bl);
+
+	if (regen == nullptr)
+		return;
+
+	s_status_regen_table& table = status_regen_table;
+	auto it = table.index.find(bl->id);
+
+	if (it != table.index.end()) {
+		table.bl[it->second] = bl;
+		table.regen[it->second] = regen;
+		table.status[it->second] = status_get_status_data(*bl);
+		return;
+	}
+
+	table.index[bl->id] = table.bl.size();
+	table.bl.push_back(bl);
+	table.regen.push_back(regen);
+	table.status.push_back(status_get_status_data(*bl));
+}
+
+/**
+ * Removes a unit from the natural heal processing
+ * @param bl: Object with natural regeneration [PC|HOM|MER|ELEM]
+ */
+void status_natural_heal_remove(block_list* bl){
+	s_status_regen_table& table = status_regen_table;
+	auto it = table.index.find(bl->id);
+
+	if (it == table.index.end())
+		return;
+
+	size_t row = it->second;
+
+	table.index.erase(it);
+
+	if (table.iterating) {
+		table.bl[row] = nullptr;
+		table.removed = true;
+		return;
+	}
+
+	// Move the last row into the gap
+	size_t last = table.bl.size() - 1;
+
+	if (row != last) {
+		table.bl[row] = table.bl[last];
+		table.regen[row] = table.regen[last];
+		table.status[row] = table.status[last];
+		table.index[table.bl[row]->id] = row;
+	}
+
+	table.bl.pop_back();
+	table.regen.pop_back();
+	table.status.pop_back();
+}
+
+/**
+ * Removes the rows that were cleared during a natural heal pass
+ */
+static void status_natural_heal_compact(void){
+	s_status_regen_table& table = status_regen_table;
+	size_t count = 0;
+
+	for (size_t row = 0; row < table.bl.size(); row++) {
+		if (table.bl[row] == nullptr)
+			continue;
+
+		if (row != count) {
+			table.bl[count] = table.bl[row];
+			table.regen[count] = table.regen[row];
+			table.status[count] = table.status[row];
+			table.index[table.bl[count]->id] = count;
+		}
+
+		count++;
+	}
+
+	table.bl.resize(count);
+	table.regen.resize(count);
+	table.status.resize(count);
+	table.removed = false;
+}
+
 /**
  * Applying natural heal bonuses (sit, skill, homun, etc...)
- * TODO: the va_list doesn't seem to be used, safe to remove?
  * @param bl: Object applying bonuses to [PC|HOM|MER|ELEM]
- * @param args: va_list arguments
+ * @param regen: Regeneration data of bl
+ * @param status: Battle status of bl
  * @return which regeneration bonuses have been applied (flag)
  */
 static t_tick natural_heal_prev_tick,natural_heal_diff_tick;
-static int32 status_natural_heal(block_list* bl, va_list args)
+static int32 status_natural_heal(block_list* bl, regen_data* regen, status_data* status)
 {
-	struct regen_data *regen;
 	status_change *sc;
 	struct unit_data *ud;
 	struct view_data *vd = nullptr;
@@ -15442,12 +16001,6 @@ static int32 status_natural_heal(block_list* bl, va_list args)
 	map_session_data *sd;
 	int32 rate, multi = 1, flag;
 
-	regen = status_get_regen_data(bl);
-	if (!regen)
-		return 0;
-
-	status_data* status = status_get_status_data(*bl);
-
 	sc = status_get_sc(bl);
 	if (sc != nullptr && sc->empty())
 		sc = nullptr;
@@ -15635,6 +16188,16 @@ static int32 status_natural_heal(block_list* bl, va_list args)
 	return flag;
 }
 
+/**
+ * Displays statistics of the natural heal passes
+ */
+void status_natural_heal_report(void){
+	ShowInfo( "Natural heal: " CL_WHITE "%" PRIuPTR CL_RESET " regenerating units, " CL_WHITE "%" PRIu64 CL_RESET " passes processing " CL_WHITE "%" PRIu64 CL_RESET " units on average in " CL_WHITE "%" PRId64 CL_RESET " us.\n",
+		status_regen_table.bl.size(), status_regen_stats.passes,
+		status_regen_stats.passes > 0 ? status_regen_stats.units / status_regen_stats.passes : 0,
+		status_regen_stats.passes > 0 ? static_cast<int64>( std::chrono::duration_cast<std::chrono::microseconds>( status_regen_stats.time ).count() / status_regen_stats.passes ) : 0 );
+}
+
 /**
  * Natural heal main timer
  * @param tid: Timer ID
@@ -15644,9 +16207,27 @@ static int32 status_natural_heal(block_list* bl, va_list args)
  * @return 0
  */
 static TIMER_FUNC(status_natural_heal_timer){
+	s_status_regen_table& table = status_regen_table;
+	auto start = std::chrono::steady_clock::now();
+
 	natural_heal_diff_tick = DIFF_TICK(tick,natural_heal_prev_tick);
 	natural_heal_prev_tick = tick;
-	map_foreachregen(status_natural_heal);
+
+	// Units added during the pass are processed as well, removed ones are skipped
+	table.iterating = true;
+	for (size_t row = 0; row < table.bl.size(); row++) {
+		if (table.bl[row] != nullptr)
+			status_natural_heal(table.bl[row], table.regen[row], table.status[row]);
+	}
+	table.iterating = false;
+
+	status_regen_stats.units += table.bl.size();
+
+	if (table.removed)
+		status_natural_heal_compact();
+
+	status_regen_stats.passes++;
+	status_regen_stats.time += std::chrono::steady_clock::now() - start;
 	return 0;
 }
 
@@ -15719,10 +16300,8 @@ void status_change_clear_onChangeMap(block_list *bl, status_change *sc)
 		bool mapIsBG = mapdata->getMapFlag(MF_BATTLEGROUND) != 0;
 		bool mapIsTE = mapdata_flag_gvg2_te(mapdata);
 
-		for (const auto &it : status_db) {
-			sc_type type = static_cast<sc_type>(it.first);
-
-			if (!sc->getSCE(type) || !SCDisabled[type])
+		for (sc_type type = sc->nextSCE(SC_NONE); type != SC_NONE; type = sc->nextSCE(type)) {
+			if (!SCDisabled[type])
 				continue;
 
 			if (status_change_isDisabledOnMap_(type, mapIsVS, mapIsPVP, mapIsGVG, mapIsBG, mapdata->zone, mapIsTE))
@@ -15810,19 +16389,6 @@ uint64 AttributeDatabase::parseBodyNode(const ryml::NodeRef& node) {
 
 AttributeDatabase elemental_attribute_db;
 
-/**
- * Get attribute ratio
- * @param atk_ele Attack element enum e_element
- * @param def_ele Defense element enum e_element
- * @param level Element level 1 ~ MAX_ELE_LEVEL
- */
-int16 AttributeDatabase::getAttribute(uint16 level, uint16 atk_ele, uint16 def_ele) {
-	if (!CHK_ELEMENT(atk_ele) || !CHK_ELEMENT(def_ele) || !CHK_ELEMENT_LEVEL(level))
-		return 100;
-
-	return this->attr_fix_table[level-1][atk_ele][def_ele];
-}
-
 s_status_change_db::s_status_change_db(){
 	this->type = SC_NONE;
 	this->icon = EFST_BLANK;
@@ -15841,6 +16407,7 @@ s_status_change_db::s_status_change_db(){
 	this->min_duration = 1;
 	this->min_rate = 0;
 	this->script = nullptr;
+	this->layered = false;
 }
 
 s_status_change_db::~s_status_change_db(){
@@ -16364,8 +16931,11 @@ void StatusDatabase::loadingFinished(){
 		auto& status = entry.second;
 
 		if( status->script != nullptr ){
-			// Trigger recalculation for everything for now
-			status->calc_flag |= this->SCB_ALL;
+			// Players only recalculate the bonuses of status changes, unless a full recalculation was requested
+			status->layered = !status->calc_flag[SCB_BASE];
+			status->calc_flag.set( SCB_BASE );
+		}else{
+			status->layered = false;
 		}
 
 		struct{
@@ -16505,5 +17075,5 @@ void do_final_status(void) {
 	elemental_attribute_db.clear();
 	mods::soul_link_db.clear();
 	delay_status.clear();
-
+	status_regen_table = {};
 }
@@ -151,6 +151,7 @@ public:
 
 	const std::string getDefaultLocation() override;
 	uint64 parseBodyNode(const ryml::NodeRef& node) override;
+	void loadingFinished() override;
 };
 
 extern SizeFixDatabase size_fix_db;
@@ -171,7 +172,25 @@ public:
 	uint64 parseBodyNode(const ryml::NodeRef& node) override;
 
 	// Additional
-	int16 getAttribute(uint16 level, uint16 atk_ele, uint16 def_ele);
+
+	/**
+	 * Get attribute ratio
+	 * @param level: Element level 1 ~ MAX_ELE_LEVEL
+	 * @param atk_ele: Attack element enum e_element
+	 * @param def_ele: Defense element enum e_element
+	 * @return Ratio in percent, 100 for invalid arguments
+	 */
+	int16 getAttribute(uint16 level, uint16 atk_ele, uint16 def_ele) const{
+		if (!CHK_ELEMENT(atk_ele) || !CHK_ELEMENT(def_ele) || !CHK_ELEMENT_LEVEL(level))
+			return 100;
+
+		return this->attr_fix_table[level-1][atk_ele][def_ele];
+	}
+
+	/// Same as getAttribute for callers that already validated the arguments
+	int16 getAttributeUnchecked(uint16 level, uint16 atk_ele, uint16 def_ele) const{
+		return this->attr_fix_table[level-1][atk_ele][def_ele];
+	}
 };
 
 extern AttributeDatabase elemental_attribute_db;
@@ -3161,6 +3180,7 @@ enum e_status_calc_opt : uint8 {
 	SCO_NONE  = 0x0,
 	SCO_FIRST = 0x1, ///< Trigger the calculations that should take place only onspawn/once, process base status initialization code
 	SCO_FORCE = 0x2, ///< Only relevant to BL_PC types, ensures call bypasses the queue caused by delayed damage
+	SCO_STATUS = 0x4, ///< Only relevant to BL_PC types, only scripts of status changes changed and the equipment bonuses can be reused
 };
 
 /// Flags for status_change_start and status_get_sc_def
@@ -3289,6 +3309,7 @@ struct s_status_change_db {
 	t_tick min_duration;				///< Minimum duration effect (after all status reduction)
 	uint16 min_rate;					///< Minimum rate to be applied (after all status reduction)
 	struct script_code* script;			///< Script to execute, when starting the status change.
+	bool layered;						///< Only the script affects the base status, players recalculate the status change bonuses only
 
 	s_status_change_db();
 	~s_status_change_db();
@@ -3508,7 +3529,8 @@ public:
 	unsigned char sg_counter; //Storm gust counter (previous hits from storm gust)
 #endif
 private:
-	std::unordered_map<enum sc_type, status_change_entry> data;
+	std::bitset<SC_MAX> active; // status changes that have an entry
+	std::vector<std::pair<enum sc_type, std::unique_ptr<status_change_entry>>> data; // entries of the active status changes, sorted by type
 	std::pair<enum sc_type, status_change_entry*> lastStatus; // last-fetched status
 
 public:
@@ -3519,10 +3541,11 @@ public:
 	status_change_entry* getSCE( uint32 type );
 	status_change_entry* createSCE( enum sc_type type );
 	void deleteSCE(enum sc_type type);
+	enum sc_type nextSCE( enum sc_type type );
 	bool empty();
 	size_t size();
-	std::unordered_map<enum sc_type, status_change_entry>::const_iterator begin();
-	std::unordered_map<enum sc_type, status_change_entry>::const_iterator end();
+	std::vector<std::pair<enum sc_type, std::unique_ptr<status_change_entry>>>::const_iterator begin();
+	std::vector<std::pair<enum sc_type, std::unique_ptr<status_change_entry>>>::const_iterator end();
 };
 #ifndef ONLY_CONSTANTS
 int32 status_damage( block_list *src, block_list *target, int64 dhp, int64 dsp, int64 dap, t_tick walkdelay, int32 flag, uint16 skill_id );
@@ -3686,6 +3709,8 @@ void status_calc_bl_(block_list *bl, std::bitset<SCB_MAX> flag, uint8 opt = SCO_
 int32 status_calc_mob_(mob_data* md, uint8 opt);
 void status_calc_pet_(pet_data* pd, uint8 opt);
 int32 status_calc_pc_(map_session_data* sd, uint8 opt);
+void status_calc_pc_layer_invalidate(void);
+void status_calc_pc_report(void);
 int32 status_calc_homunculus_(homun_data *hd, uint8 opt);
 int32 status_calc_mercenary_(s_mercenary_data *md, uint8 opt);
 int32 status_calc_elemental_(s_elemental_data *ed, uint8 opt);
@@ -3705,6 +3730,9 @@ static void status_calc_bl(block_list *bl, std::vector<e_scb_flag> flags) {
 void status_calc_misc(block_list *bl, struct status_data *status, int32 level);
 void status_calc_regen(block_list *bl, struct status_data *status, struct regen_data *regen);
 void status_calc_regen_rate(block_list *bl, struct regen_data *regen, status_change *sc);
+void status_natural_heal_add(block_list* bl);
+void status_natural_heal_remove(block_list* bl);
+void status_natural_heal_report(void);
 void status_calc_state(block_list *bl, status_change *sc, std::bitset<SCS_MAX> flag, bool start);
 
 void status_calc_slave_mode(mob_data& md);
@@ -37,6 +37,7 @@ std::string grf_list_file = "conf/grf-files.txt";
 std::string map_list_file = "map_index.txt";
 std::string map_cache_file;
 int32 rebuild = 0;
+int32 grid = 0;
 
 FILE *map_cache_fp;
 
@@ -63,6 +64,36 @@ struct map_info {
 	int32 len;
 };
 
+#define GRID_MAGIC "RAMG"
+#define GRID_VERSION 1
+#define GRID_ALIGNMENT 4096 // Page size, so the map-server can map every grid directly
+
+// Main header of the uncompressed (-grid) map cache
+struct grid_header {
+	char magic[4];
+	uint16 version;
+	uint16 map_count;
+	uint32 alignment;
+};
+
+// Follows the main header once for each map of the uncompressed map cache
+struct grid_info {
+	char name[MAP_NAME_LENGTH];
+	int16 xs;
+	int16 ys;
+	uint32 offset; // Start of the grid in the file, one gat type byte per cell
+};
+
+// Map of the uncompressed map cache, kept in memory until the file is written
+struct grid_map {
+	char name[MAP_NAME_LENGTH];
+	int16 xs;
+	int16 ys;
+	std::vector<unsigned char> cells;
+};
+
+std::vector<struct grid_map> grid_maps;
+
 
 // Reads a map from GRF's GAT and RSW files
 int32 read_map(char *name, struct map_data *m)
@@ -115,6 +146,23 @@ int32 read_map(char *name, struct map_data *m)
 	return 1;
 }
 
+// Adds a map to the uncompressed cache
+void cache_grid_map(char *name, struct map_data *m)
+{
+	struct grid_map map = {};
+
+	if (strlen(name) > MAP_NAME_LENGTH) // It does not hurt to warn that there are maps with name longer than allowed.
+		ShowWarning ("Map name '%s' size '%" PRIuPTR "' is too long. Truncating to '%d'.\n", name, strlen(name), MAP_NAME_LENGTH);
+	strncpy(map.name, name, MAP_NAME_LENGTH);
+	map.xs = m->xs;
+	map.ys = m->ys;
+	map.cells.assign(m->cells, m->cells + (size_t)m->xs*(size_t)m->ys);
+	grid_maps.push_back(std::move(map));
+	header.map_count++;
+
+	aFree(m->cells);
+}
+
 // Adds a map to the cache
 void cache_map(char *name, struct map_data *m)
 {
@@ -122,6 +170,11 @@ void cache_map(char *name, struct map_data *m)
 	unsigned long len;
 	unsigned char *write_buf;
 
+	if (grid) {
+		cache_grid_map(name, m);
+		return;
+	}
+
 	// Create an output buffer twice as big as the uncompressed map... this way we're sure it fits
 	len = (unsigned long)m->xs*(unsigned long)m->ys*2;
 	write_buf = (unsigned char *)aMalloc(len);
@@ -155,6 +208,14 @@ int32 find_map(char *name)
 	int32 i;
 	struct map_info info;
 
+	if (grid) {
+		for (const auto &map : grid_maps) {
+			if (strncmp(name, map.name, MAP_NAME_LENGTH) == 0)
+				return 1;
+		}
+		return 0;
+	}
+
 	fseek(map_cache_fp, sizeof(struct main_header), SEEK_SET);
 
 	for(i = 0; i < header.map_count; i++) {
@@ -168,6 +229,78 @@ int32 find_map(char *name)
 	return 0;
 }
 
+// Reads the maps of an existing uncompressed cache, returns false if the file is not one
+bool read_grid_cache()
+{
+	struct grid_header gh;
+
+	fseek(map_cache_fp, 0, SEEK_SET);
+	if (fread(&gh, sizeof(gh), 1, map_cache_fp) != 1 || memcmp(gh.magic, GRID_MAGIC, sizeof(gh.magic)) != 0 || GetUShort((unsigned char *)&gh.version) != GRID_VERSION)
+		return false;
+
+	uint16 count = GetUShort((unsigned char *)&gh.map_count);
+	std::vector<struct grid_info> infos(count);
+
+	if (count > 0 && fread(infos.data(), sizeof(struct grid_info), count, map_cache_fp) != count)
+		return false;
+
+	for (const auto &info : infos) {
+		struct grid_map map = {};
+
+		memcpy(map.name, info.name, MAP_NAME_LENGTH);
+		map.xs = (int16)GetUShort((unsigned char *)&info.xs);
+		map.ys = (int16)GetUShort((unsigned char *)&info.ys);
+		map.cells.resize((size_t)map.xs*(size_t)map.ys);
+		fseek(map_cache_fp, GetULong((unsigned char *)&info.offset), SEEK_SET);
+		if (fread(map.cells.data(), 1, map.cells.size(), map_cache_fp) != map.cells.size())
+			return false;
+		grid_maps.push_back(std::move(map));
+	}
+
+	header.map_count = count;
+
+	return true;
+}
+
+// Writes the uncompressed cache, every grid starts at a page boundary
+void write_grid_cache()
+{
+	struct grid_header gh = {};
+	static const char padding[GRID_ALIGNMENT] = {};
+	uint32 offset = sizeof(struct grid_header) + (uint32)(grid_maps.size() * sizeof(struct grid_info));
+
+	memcpy(gh.magic, GRID_MAGIC, sizeof(gh.magic));
+	gh.version = MakeShortLE(GRID_VERSION);
+	gh.map_count = MakeShortLE((int16)grid_maps.size());
+	gh.alignment = MakeLongLE(GRID_ALIGNMENT);
+
+	fseek(map_cache_fp, 0, SEEK_SET);
+	fwrite(&gh, sizeof(gh), 1, map_cache_fp);
+
+	// Index of all maps
+	for (const auto &map : grid_maps) {
+		struct grid_info info;
+
+		offset = (offset + GRID_ALIGNMENT - 1) / GRID_ALIGNMENT * GRID_ALIGNMENT;
+		memcpy(info.name, map.name, MAP_NAME_LENGTH);
+		info.xs = MakeShortLE(map.xs);
+		info.ys = MakeShortLE(map.ys);
+		info.offset = MakeLongLE(offset);
+		fwrite(&info, sizeof(info), 1, map_cache_fp);
+		offset += (uint32)map.cells.size();
+	}
+
+	// Grids, padded to the alignment
+	offset = sizeof(struct grid_header) + (uint32)(grid_maps.size() * sizeof(struct grid_info));
+	for (const auto &map : grid_maps) {
+		uint32 pad = (GRID_ALIGNMENT - offset % GRID_ALIGNMENT) % GRID_ALIGNMENT;
+
+		fwrite(padding, 1, pad, map_cache_fp);
+		fwrite(map.cells.data(), 1, map.cells.size(), map_cache_fp);
+		offset += pad + (uint32)map.cells.size();
+	}
+}
+
 // Cuts the extension from a map name
 char *remove_extension(char *mapname)
 {
@@ -197,6 +330,8 @@ void process_args(int32 argc, char *argv[])
 				map_cache_file = argv[i];
 		} else if(strcmp(argv[i], "-rebuild") == 0)
 			rebuild = 1;
+		else if(strcmp(argv[i], "-grid") == 0)
+			grid = 1;
 	}
 
 }
@@ -230,6 +365,14 @@ bool MapcacheTool::initialize( int32 argc, char* argv[] ){
 		return false;
 	}
 
+	// The uncompressed cache is kept in memory and written at once, because its index comes first
+	if(grid && !rebuild && !read_grid_cache()) {
+		ShowNotice("Existing map cache is not an uncompressed map cache, forcing rebuild mode\n");
+		grid_maps.clear();
+		header.map_count = 0;
+		rebuild = 1;
+	}
+
 	// Open the map list
 	FILE *list;
 	std::vector<std::string> directories = { std::string(db_path) + "/",  std::string(db_path) + "/" + std::string(DBIMPORT) + "/" };
@@ -245,7 +388,9 @@ bool MapcacheTool::initialize( int32 argc, char* argv[] ){
 		}
 
 		// Initialize the main header
-		if (rebuild) {
+		if (grid) {
+			// Already read by read_grid_cache
+		} else if (rebuild) {
 			header.file_size = sizeof(struct main_header);
 			header.map_count = 0;
 		} else {
@@ -291,8 +436,19 @@ bool MapcacheTool::initialize( int32 argc, char* argv[] ){
 
 	// Write the main header and close the map cache
 	ShowStatus("Closing map cache: %s\n", map_cache_file.c_str());
-	fseek(map_cache_fp, 0, SEEK_SET);
-	fwrite(&header, sizeof(struct main_header), 1, map_cache_fp);
+	if (grid) {
+		// Drop the previous contents, the new file may be shorter
+		fclose(map_cache_fp);
+		map_cache_fp = fopen(map_cache_file.c_str(), "wb");
+		if (map_cache_fp == nullptr) {
+			ShowError("Failure when opening map cache file %s\n", map_cache_file.c_str());
+			return false;
+		}
+		write_grid_cache();
+	} else {
+		fseek(map_cache_fp, 0, SEEK_SET);
+		fwrite(&header, sizeof(struct main_header), 1, map_cache_fp);
+	}
 	fclose(map_cache_fp);
 
 	ShowStatus("Finalizing grfio\n");
@@ -0,0 +1,4 @@
+@ECHO OFF
+map-server-generator.exe /benchmark-battle
+ECHO.
+pause